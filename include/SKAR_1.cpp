@@ -50,55 +50,57 @@ void initialize()
 	ks.kBias = 0;
 
 	// Drive Motors
-	frontFrontLft.reset(new okapi::Motor(6, true, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations));
-	frontLft.reset(new okapi::Motor(4, true, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations));
-	frontUpperLft.reset(new okapi::Motor(3, true, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations));
-	backLft.reset(new okapi::Motor(2, false, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations));
-	backBackLft.reset(new okapi::Motor(1, false, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations));
-
-	frontFrontRt.reset(new okapi::Motor(20, true, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations));
-	frontRt.reset(new okapi::Motor(19, true, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations));
-	frontUpperRt.reset(new okapi::Motor(9, true, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations));
-	backRt.reset(new okapi::Motor(17, false, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations));
-	backBackRt.reset(new okapi::Motor(14, false, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations));
+	frontFrontLft = make_motor<wiring::frontFrontLft>();
+	frontLft = make_motor<wiring::frontLft>();
+	frontUpperLft = make_motor<wiring::frontUpperLft>();
+	backLft = make_motor<wiring::backLft>();
+	backBackLft = make_motor<wiring::backBackLft>();
+
+	frontFrontRt = make_motor<wiring::frontFrontRt>();
+	frontRt = make_motor<wiring::frontRt>();
+	frontUpperRt = make_motor<wiring::frontUpperRt>();
+	backRt = make_motor<wiring::backRt>();
+	backBackRt = make_motor<wiring::backBackRt>();
 
 	drive_lft.reset(new okapi::MotorGroup({frontFrontLft, frontLft, frontUpperLft, backLft, backBackLft}));
 	drive_rt.reset(new okapi::MotorGroup({frontFrontRt, frontRt, frontUpperRt, backRt, backBackRt}));
 	chassis = okapi::ChassisControllerBuilder()
 				  .withMotors(drive_lft, drive_rt)
 				  // Green gearset, 4 in wheel diam, 11.5 in wheel track
-				  .withDimensions(okapi::AbstractMotor::gearset::green, {{3.25_in, 14.5_in}, okapi::imev5GreenTPR})
+				  .withDimensions({wiring::drive.gearset, wiring::drive.ratio}, {{wiring::drive.wheel_diameter, wiring::drive.wheel_track}, wiring::drive.tpr})
 				  .withGains(ks, ks)
 				  .build();
 
 	// Front Lift
-	frontLftLift.reset(new okapi::Motor(15, false, okapi::AbstractMotor::gearset::red, okapi::AbstractMotor::encoderUnits::rotations));
-	frontRtLift.reset(new okapi::Motor(16, true, okapi::AbstractMotor::gearset::red, okapi::AbstractMotor::encoderUnits::rotations));
+	frontLftLift = make_motor<wiring::frontLftLift>();
+	frontRtLift = make_motor<wiring::frontRtLift>();
 	front_lift.reset(new okapi::MotorGroup({frontLftLift, frontRtLift}));
 	front_lift->setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
 	front_lift_control = okapi::AsyncPosControllerBuilder().withMotor(front_lift).build();
 
 	// intake
-	intake.reset(new okapi::Motor(6, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
+	intake = make_motor<wiring::intake>();
 
 	// Controller Initialization
 	master.reset(new pros::Controller(pros::E_CONTROLLER_MASTER));
 
 	// Pneumatics
-	piston.reset(new pros::ADIDigitalOut('C', true));	// back lift piston
-	front_piston.reset(new pros::ADIDigitalOut('A', false)); // front lift piston
+	piston = StaticDevice<pros::ADIDigitalOut, wiring::piston>::make(wiring::piston, true);	// back lift piston
+	front_piston = StaticDevice<pros::ADIDigitalOut, wiring::front_piston>::make(wiring::front_piston, false); // front lift piston
 
 	// Camera
-	camera.reset(new GoalCamera(11));
+	camera = StaticDevice<GoalCamera, wiring::camera>::make(wiring::camera);
+	goals.reset(new GoalTracker(camera));
+	goals->start();
 
 	// IMU
-	imu.reset(new pros::Imu(18));
+	imu = StaticDevice<pros::Imu, wiring::imu>::make(wiring::imu);
 
 	// Distance Sensor
-	dist_sensor.reset(new pros::Distance(13));
+	dist_sensor = StaticDevice<pros::Distance, wiring::dist_sensor>::make(wiring::dist_sensor);
 
 	// Snatcher
-	snatcher.reset(new okapi::Motor(8, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
+	snatcher = make_motor<wiring::snatcher>();
 }
 
 /**
@@ -179,30 +181,51 @@ void autonomous()
 		int DIST = 35; // mm distance
 		drive_lft->moveVoltage(12000);
 		drive_rt->moveVoltage(12000);
-		int move_time = 0;
+		uint32_t rush_start = pros::millis();
+		uint32_t now = rush_start;
 
 		drive_lft->setBrakeMode(okapi::AbstractMotor::brakeMode::brake);
 		drive_rt->setBrakeMode(okapi::AbstractMotor::brakeMode::brake);
-		int MAX_TIME = 1400; // seconds want to stop running no matter what (FOR AUTON LINE)
-		while ((dist_sensor->get() > DIST || dist_sensor->get() == 0) && move_time < MAX_TIME)
+		uint32_t MAX_TIME = 1400; // ms want to stop running no matter what (FOR AUTON LINE)
+		GoalApproach approach(DIST);
+		bool grabbed = false;
+		bool braked = false;
+		while ((!grabbed || !braked) && now - rush_start < MAX_TIME)
 		{
-			
-			if (dist_sensor->get() < 400 && dist_sensor->get() != 0)
+			int32_t dist = dist_sensor->get();
+			approach.update(pros::millis(), dist, dist_sensor->get_confidence(), dist_sensor->get_object_velocity());
+
+			if (!braked && dist < 400 && dist != 0)
 			{
 				drive_rt->moveVoltage(6000);
 				drive_lft->moveVoltage(6000);
 				MAX_TIME = MAX_TIME + 3;
 			}
+			// Grab the yellow
+			if (!grabbed && approach.fire_claw())
+			{
+				front_piston->set_value(true);
+				grabbed = true;
+			}
+			if (!braked && approach.fire_brake())
+			{
+				drive_rt->moveVoltage(0);
+				drive_lft->moveVoltage(0);
+				braked = true;
+			}
 
-			pros::delay(5);
-			move_time += 5;
-			
+			pros::Task::delay_until(&now, 5);
 		}
 		drive_rt->moveVoltage(0);
 		drive_lft->moveVoltage(0);
-
-		// Grab the yellow
 		front_piston->set_value(true);
+		// let the claw finish closing, and see when the goal actually got there
+		for (uint32_t t = pros::millis(); pros::millis() - t < 150;)
+		{
+			approach.update(pros::millis(), dist_sensor->get(), dist_sensor->get_confidence(), dist_sensor->get_object_velocity());
+			pros::delay(5);
+		}
+		approach.log();
 
 		// Go back
 		chassis->moveDistance(-1.61_ft);
@@ -229,6 +252,50 @@ void autonomous()
 	}
 }
 
+/*
+	Vision calibration, entered by holding B and Y in driver control. Point
+	the camera and press LEFT for a view with no goal, UP for red, RIGHT for
+	yellow or DOWN for blue to record a sweep to the SD card; B leaves. Feed
+	/usd/vision_rec.csv to sim/bin/vision_calibrate to get a signature table.
+*/
+void vision_calibration()
+{
+	drive_lft->moveVoltage(0);
+	drive_rt->moveVoltage(0);
+	master->print(0, 0, "Vision calibration");
+	pros::delay(50);
+	master->print(1, 0, "L none U R D color");
+	while (!master->get_digital_new_press(DIGITAL_B))
+	{
+		const char *label = NULL;
+		if (master->get_digital_new_press(DIGITAL_LEFT))
+		{
+			label = "NONE";
+		}
+		else if (master->get_digital_new_press(DIGITAL_UP))
+		{
+			label = "RED";
+		}
+		else if (master->get_digital_new_press(DIGITAL_RIGHT))
+		{
+			label = "YELLOW";
+		}
+		else if (master->get_digital_new_press(DIGITAL_DOWN))
+		{
+			label = "BLUE";
+		}
+		if (label != NULL)
+		{
+			master->print(2, 0, "recording %-8s", label);
+			bool saved = record_signature_sweep(camera, label);
+			pros::delay(50);
+			master->print(2, 0, saved ? "saved %-12s" : "no SD card %-7s", label);
+		}
+		pros::delay(20);
+	}
+	master->clear();
+}
+
 /**
  * Runs the operator control code. This function will be started in its own task
  * with the default priority and stack size whenever the robot is enabled via
@@ -259,9 +326,16 @@ void opcontrol()
 	/* bool chassis_hold = false; */
 	int delay = 0;
 	int move_volt = 11000;
+	FixedRateLoop loop(20);
+	int dt = 0;
 
 	while (true)
 	{
+		if (master->get_digital(DIGITAL_B) && master->get_digital(DIGITAL_Y))
+		{
+			vision_calibration();
+		}
+
 		// Drive Mechanics
 
 		if (selector::auton == 0)
@@ -308,7 +382,7 @@ void opcontrol()
 		piston->set_value(piston_flag);
 		if (piston_timer > 0)
 		{
-			piston_timer = piston_timer - 20;
+			piston_timer = piston_timer - dt;
 		}
 
 		// Front Lift Pistons
@@ -320,7 +394,7 @@ void opcontrol()
 		front_piston->set_value(piston_flag1);
 		if (piston_timer1 > 0)
 		{
-			piston_timer1 = piston_timer1 - 20;
+			piston_timer1 = piston_timer1 - dt;
 		}
 
 		// Intake Mechanics
@@ -346,10 +420,11 @@ void opcontrol()
 			snatcher->moveVelocity(0);
 		}
 
-		pros::delay(20);
+		dt = loop.next();
+		loop.report_every(500, "driver control");
 		if (delay > 0)
 		{
-			delay = delay - 20;
+			delay = delay - dt;
 		}
 	}
 }
\ No newline at end of file
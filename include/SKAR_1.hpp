@@ -6,6 +6,65 @@
 #define AUTON_CPP
 #include "auton_util.cpp"
 #endif
+#ifndef HARDWARE_CPP
+#define HARDWARE_CPP
+#include "hardware.cpp"
+#endif
+
+// Every port on the robot; the build fails if two devices share one
+namespace wiring
+{
+	using okapi::AbstractMotor;
+	using namespace okapi::literals;
+
+	constexpr MotorSpec frontFrontLft{6, true, AbstractMotor::gearset::blue};
+	constexpr MotorSpec frontLft{4, true, AbstractMotor::gearset::blue};
+	constexpr MotorSpec frontUpperLft{3, true, AbstractMotor::gearset::blue};
+	constexpr MotorSpec backLft{2, false, AbstractMotor::gearset::blue};
+	constexpr MotorSpec backBackLft{1, false, AbstractMotor::gearset::blue};
+
+	constexpr MotorSpec frontFrontRt{20, true, AbstractMotor::gearset::blue};
+	constexpr MotorSpec frontRt{19, true, AbstractMotor::gearset::blue};
+	constexpr MotorSpec frontUpperRt{9, true, AbstractMotor::gearset::blue};
+	constexpr MotorSpec backRt{17, false, AbstractMotor::gearset::blue};
+	constexpr MotorSpec backBackRt{14, false, AbstractMotor::gearset::blue};
+
+	constexpr MotorSpec frontLftLift{15, false, AbstractMotor::gearset::red};
+	constexpr MotorSpec frontRtLift{16, true, AbstractMotor::gearset::red};
+
+	// was on 6 with frontFrontLft, so every intake command also drove the left side;
+	// 7 is only the first free port, nobody has looked at the robot yet: check it
+	// before flashing, then set intake_port_checked
+	constexpr MotorSpec intake{7, true, AbstractMotor::gearset::green};
+	constexpr bool intake_port_checked = false;
+	constexpr MotorSpec snatcher{8, true, AbstractMotor::gearset::green};
+
+	constexpr uint8_t camera = 11;
+	constexpr uint8_t dist_sensor = 13;
+	constexpr uint8_t imu = 18;
+
+	constexpr char front_piston = 'A';
+	constexpr char piston = 'C';
+
+	// the drive is blue, but the chassis has always been tuned as green
+	constexpr DriveSpec drive{AbstractMotor::gearset::green, 1.0, 3.25_in, 14.5_in, okapi::imev5GreenTPR};
+
+	constexpr uint8_t smart_ports[] = {
+		frontFrontLft.port, frontLft.port, frontUpperLft.port, backLft.port, backBackLft.port,
+		frontFrontRt.port, frontRt.port, frontUpperRt.port, backRt.port, backBackRt.port,
+		frontLftLift.port, frontRtLift.port, intake.port, snatcher.port,
+		camera, dist_sensor, imu};
+	constexpr char adi_ports[] = {front_piston, piston};
+
+	static_assert(smart_ports_in_range(smart_ports), "SKAR_1: smart port outside 1-21");
+	static_assert(smart_ports_unique(smart_ports), "SKAR_1: two devices on one smart port");
+	static_assert(adi_ports_in_range(adi_ports), "SKAR_1: ADI port outside A-H");
+	static_assert(adi_ports_unique(adi_ports), "SKAR_1: two devices on one ADI port");
+#ifdef SKAR_STRICT_WIRING // opt in to refuse to build on a port nobody has checked
+	static_assert(intake_port_checked, "SKAR_1: the intake shared port 6 with frontFrontLft and port 7 is a guess; "
+	                                   "find the intake's port on the robot, put it in wiring::intake and set intake_port_checked");
+#endif
+}
 
 // PID Control
 okapi::IterativePosPIDController::Gains ks; 
@@ -53,6 +112,7 @@ std::shared_ptr<pros::ADIDigitalOut> front_piston;
 
 // Camera Initialization
 std::shared_ptr<GoalCamera> camera;
+std::shared_ptr<GoalTracker> goals;
 
 // IMU Initialization
 std::shared_ptr<pros::Imu> imu;
@@ -1,7 +1,7 @@
 #include "SKAR_2.hpp"
 
 void imu_turning_2(double target) {
-	imu_turning(target, drive_lft, drive_rt, imu, master);
+	imu_turning(target, drive_lft, drive_rt, sensors, display, ExitPolicy::within(3000), turn_gains);
 }
 
 /**
@@ -25,6 +25,46 @@ void on_center_button()
 	}
 }
 
+/**
+ * Puts the time from power on until auton could start on the brain screen,
+ * once both initialize() and the IMU calibration are done. Either one can
+ * finish last, so both call it. If the IMU has failed to calibrate it says
+ * so on the brain and the controller instead, and says again if it comes
+ * ready late.
+ */
+void report_ready()
+{
+	static std::atomic<bool> shown_failure{false};
+	uint32_t initialized = initialized_at.load();
+	if (initialized == 0)
+	{
+		return;
+	}
+	if (imu_calibration->get_failed())
+	{
+		if (!shown_failure.exchange(true))
+		{
+			pros::screen::print(pros::E_TEXT_MEDIUM, 9, "IMU NOT CALIBRATED: turns and balance have no heading");
+			display->print(1, 0, "IMU NOT READY");
+			printf("IMU not calibrated %u ms after power on\n", pros::millis());
+		}
+		return;
+	}
+	if (!imu_calibration->ready())
+	{
+		return;
+	}
+	uint32_t ready = std::max(initialized, imu_calibration->get_ready_time());
+	pros::screen::print(pros::E_TEXT_MEDIUM, 9, "ready %u ms after power on (IMU %u ms)", ready, imu_calibration->get_duration());
+	if (shown_failure)
+	{
+		display->print(1, 0, "IMU ready late");
+	}
+	printf("ready %u ms after power on: initialize %u ms, IMU calibration %u ms\n", ready, initialized, imu_calibration->get_duration());
+}
+
+void queue_auton_work(); // with the auton code below
+
 /**
  * Runs initialization code. This occurs as soon as the program is started.
  *
@@ -33,6 +73,12 @@ void on_center_button()
  */
 void initialize()
 {
+	// calibrating takes ~2 s, so start it first and build everything else meanwhile
+	imu = StaticDevice<pros::Imu, wiring::imu>::make(wiring::imu);
+	imu_calibration.reset(new ImuCalibration(imu));
+	imu_calibration->on_ready = [](uint32_t) { report_ready(); };
+	imu_calibration->on_failed = report_ready;
+	imu_calibration->start();
 
 	selector::init();
 
@@ -52,14 +98,14 @@ void initialize()
 	}
 
 	// Drive Motors
-	front_rt1.reset(new okapi::Motor(1, false, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	front_rt2.reset(new okapi::Motor(2, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	back_rt1.reset(new okapi::Motor(3, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	back_rt2.reset(new okapi::Motor(11, false, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	front_lft1.reset(new okapi::Motor(10, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	front_lft2.reset(new okapi::Motor(9, false, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	back_lft1.reset(new okapi::Motor(20, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	back_lft2.reset(new okapi::Motor(8, false, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
+	front_rt1 = make_motor<wiring::front_rt1>();
+	front_rt2 = make_motor<wiring::front_rt2>();
+	back_rt1 = make_motor<wiring::back_rt1>();
+	back_rt2 = make_motor<wiring::back_rt2>();
+	front_lft1 = make_motor<wiring::front_lft1>();
+	front_lft2 = make_motor<wiring::front_lft2>();
+	back_lft1 = make_motor<wiring::back_lft1>();
+	back_lft2 = make_motor<wiring::back_lft2>();
 
 	front_rt.reset(new okapi::MotorGroup({front_rt1, front_rt2}));
 	front_lft.reset(new okapi::MotorGroup({front_lft1, front_lft2}));
@@ -68,40 +114,99 @@ void initialize()
 
 	drive_lft.reset(new okapi::MotorGroup({front_lft1, front_lft2, back_lft1, back_lft2}));
 	drive_rt.reset(new okapi::MotorGroup({front_rt1, front_rt2, back_rt1, back_rt2}));
+
+	front_rt_cmd.reset(new CachedMotors({front_rt1, front_rt2}));
+	front_lft_cmd.reset(new CachedMotors({front_lft1, front_lft2}));
+	back_rt_cmd.reset(new CachedMotors({back_rt1, back_rt2}));
+	back_lft_cmd.reset(new CachedMotors({back_lft1, back_lft2}));
+	drive_lft_cmd.reset(new CachedMotors({front_lft1, front_lft2, back_lft1, back_lft2}));
+	drive_rt_cmd.reset(new CachedMotors({front_rt1, front_rt2, back_rt1, back_rt2}));
+
 	chassis = okapi::ChassisControllerBuilder()
 				  .withMotors(drive_lft, drive_rt)
 				  // Green gearset, 4 in wheel diam, 11.5 in wheel track
-				  .withDimensions({okapi::AbstractMotor::gearset::green, (3.0 / 5.0)}, {{3.25_in, 12.4375_in}, okapi::imev5GreenTPR})
+				  .withDimensions({wiring::drive.gearset, wiring::drive.ratio}, {{wiring::drive.wheel_diameter, wiring::drive.wheel_track}, wiring::drive.tpr})
 				  .withGains(ks, ks, ks)
 				  .build();
 
-	lift_front_lft.reset(new okapi::Motor(19, true, okapi::AbstractMotor::gearset::red, okapi::AbstractMotor::encoderUnits::rotations));
-	lift_front_rt.reset(new okapi::Motor(12, false, okapi::AbstractMotor::gearset::red, okapi::AbstractMotor::encoderUnits::rotations));
+	lift_front_lft = make_motor<wiring::lift_front_lft>();
+	lift_front_rt = make_motor<wiring::lift_front_rt>();
 	lift_front.reset(new okapi::MotorGroup({*lift_front_lft, *lift_front_rt}));
 	lift_front->setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
 
 	lift_front_control = okapi::AsyncPosControllerBuilder().withMotor(*lift_front).build();
 	lift_front_control->setTarget(FRONT_LIFT_INIT);
 
-	front_claw_piston.reset(new pros::ADIDigitalOut('A'));
-	back_tilter.reset(new pros::ADIDigitalOut('B'));
-	back_claw_piston.reset(new pros::ADIDigitalOut('C'));
+	front_claw_piston = StaticDevice<pros::ADIDigitalOut, wiring::front_claw_piston>::make(wiring::front_claw_piston);
+	back_tilter = StaticDevice<pros::ADIDigitalOut, wiring::back_tilter>::make(wiring::back_tilter);
+	back_claw_piston = StaticDevice<pros::ADIDigitalOut, wiring::back_claw_piston>::make(wiring::back_claw_piston);
 
 
-	intake_lft.reset(new okapi::Motor(14, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	intake_rt.reset(new okapi::Motor(13, false, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
+	intake_lft = make_motor<wiring::intake_lft>();
+	intake_rt = make_motor<wiring::intake_rt>();
 	intake.reset(new okapi::MotorGroup({*intake_lft, *intake_rt}));
+	intake_cmd.reset(new CachedMotors({intake_lft, intake_rt}));
 
 	intake->setBrakeMode(okapi::AbstractMotor::brakeMode::coast);
 
-	//camera.reset(new GoalCamera(17));
+	//camera = StaticDevice<GoalCamera, wiring::camera>::make(wiring::camera);
+	//goals.reset(new GoalTracker(camera));
+	//goals->start();
+
+	dist_sensor = StaticDevice<pros::Distance, wiring::dist_sensor>::make(wiring::dist_sensor);
+
+	sensors.reset(new SensorHub(imu, dist_sensor, drive_lft, drive_rt));
+	sensors->set_calibration(imu_calibration);
+	sensors->start();
 
-	imu.reset(new pros::Imu(4));
+	odometry.reset(new Odometry(sensors, wiring::drive));
+	odometry->start();
 
-	dist_sensor.reset(new pros::Distance(16));
+	// the generated tables stay in flash; their ids are their places in paths::all
+	trajectories.reset(new TrajectoryStore());
+	for (const PackedTrajectory &table : paths::all)
+	{
+		trajectories->add(table);
+	}
 
 	master.reset(new pros::Controller(pros::E_CONTROLLER_MASTER));
 	partner.reset(new pros::Controller(pros::E_CONTROLLER_PARTNER));
+
+	display.reset(new ControllerDisplay(master));
+	display->start();
+
+	telemetry.reset(new Telemetry());
+	telemetry_sampler.reset(new TelemetrySampler(telemetry,
+		{front_rt1, front_rt2, back_rt1, back_rt2, front_lft1, front_lft2, back_lft1, back_lft2,
+		 lift_front_lft, lift_front_rt, intake_lft, intake_rt},
+		sensors));
+	if (pros::usd::is_installed())
+	{
+		telemetry_sampler->start();
+	}
+
+	recorder.reset(new InputRecorder());
+	recorder->on_full = [] { display->print(2, 0, "Recording full"); }; // Y still saves it
+	precompute.reset(new Precompute());
+	precompute->on_idle = queue_auton_work;
+
+	initialized_at = std::max<uint32_t>(pros::millis(), 1); // 0 means not yet
+	report_ready();
+}
+
+/*
+	Deletes the step tasks of an autonomous graph that PROS cut off at the end
+	of the period and stops the drive they were commanding.
+*/
+void stop_auton()
+{
+	std::shared_ptr<ActionGraph> graph = running_graph;
+	running_graph = nullptr;
+	if (graph)
+	{
+		int deleted = graph->cancel();
+		printf("auton: cut off, %d step tasks deleted\n", deleted);
+	}
 }
 
 /**
@@ -109,7 +214,11 @@ void initialize()
  * the VEX Competition Switch, following either autonomous or opcontrol. When
  * the robot is enabled, this task will exit.
  */
-void disabled() {}
+void disabled()
+{
+	stop_auton();
+	precompute->start();
+}
 
 /**
  * Runs after initialize(), and before autonomous when connected to the Field
@@ -120,7 +229,559 @@ void disabled() {}
  * This task will exit when the robot is enabled and autonomous or opcontrol
  * starts.
  */
-void competition_initialize() {}
+void competition_initialize()
+{
+	precompute->start();
+}
+
+// Graph steps for the mechanisms SKAR_2 uses in auton
+
+// A chassis move that finishes once settled, or after timeout ms; by default
+// the motion_timeout() of the distance at velocity rpm
+int drive_step(ActionGraph &g, const char *name, std::vector<int> after, okapi::QLength distance, double velocity, uint32_t timeout = 0)
+{
+	if (timeout == 0)
+	{
+		timeout = motion_timeout(distance.convert(okapi::meter) / (velocity / wiring::drive.rpm_per_mps()));
+	}
+	ExitPolicy exit = ExitPolicy::within(timeout);
+	return g.task(name, after, [distance, velocity, exit] {
+		chassis->setMaxVelocity(velocity);
+		move_distance(chassis, sensors, distance, exit);
+	});
+}
+
+// Follows waypoints in skills' field coordinates, where the robot starts at the origin facing +x
+int path_step(ActionGraph &g, const char *name, std::vector<int> after, std::vector<okapi::Point> waypoints, double velocity, bool reverse = false, uint32_t timeout = 0)
+{
+	PursuitGains gains = path_gains;
+	gains.max_velocity = velocity;
+	std::shared_ptr<PursuitPath> path(new PursuitPath(waypoints, gains));
+	ExitPolicy exit = ExitPolicy::within(timeout > 0 ? timeout : motion_timeout(path->length() / velocity));
+	return g.task(name, after, [path, reverse, exit] {
+		follow_path(*path, reverse, odometry, drive_lft, drive_rt, sensors, wiring::drive, exit);
+	});
+}
+
+/*
+	Opens paths/NAME.traj on the SD card for the built in trajectory table,
+	if there is one and it is a good copy of something else. A file that is
+	damaged, of another format version or named for another path is left
+	out, and so is one whose data matches the table's CRC, since the table
+	is the same path without the card. Says on the terminal and the
+	controller which it found. Gives up between chunks of the file once the
+	precompute is cancelled, and then says nothing.
+*/
+std::shared_ptr<TrajectoryStream> open_sd_trajectory(const PackedTrajectory &table, const Precompute &p)
+{
+	char path[64];
+	snprintf(path, sizeof(path), "/usd/paths/%s.traj", table.name);
+	FILE *file = fopen(path, "rb");
+	if (file == NULL)
+	{
+		return nullptr;
+	}
+	fclose(file);
+
+	std::shared_ptr<TrajectoryStream> stream(new TrajectoryStream());
+	uint32_t built_in = trajectory_data_crc(table);
+	bool opened = stream->open(path, [&p] { return p.cancelled(); });
+	if (p.cancelled())
+	{
+		return nullptr;
+	}
+	if (!opened || strcmp(stream->name, table.name) != 0)
+	{
+		printf("trajectory %s: %s is damaged, out of date or for another path; using the built in one\n", table.name, path);
+		display->print(2, 0, "BAD %s.traj", table.name);
+		return nullptr;
+	}
+	if (stream->data_crc == built_in)
+	{
+		printf("trajectory %s: %s is the built in one\n", table.name, path);
+		return nullptr;
+	}
+	printf("trajectory %s: %s replaces the built in one (crc %08x, built in %08x), %.2f s against %.2f s\n", table.name,
+	       path, stream->data_crc, built_in, stream->length * stream->dt, table.length * table.dt);
+	display->print(2, 0, "SD %s.traj", table.name);
+	return stream;
+}
+
+/*
+	Runs trajectory id from the store, e.g. paths::ring_sweep_id, from
+	wherever the robot is. If the robot was disabled long enough for
+	precompute to find a paths/NAME.traj on the SD card that replaces it,
+	that is streamed off the card instead, so a path can be retuned without
+	downloading the program again. Prints which one it ran.
+*/
+int trajectory_step(ActionGraph &g, const char *name, std::vector<int> after, uint16_t id, uint32_t timeout = 0)
+{
+	return g.task(name, after, [id, timeout] {
+		const PackedTrajectory &table = trajectories->get(id);
+		auto found = sd_trajectories.find(id);
+		if (found != sd_trajectories.end())
+		{
+			TrajectoryStream &stream = *found->second;
+			printf("trajectory %s: from the SD card\n", table.name);
+			ExitPolicy exit = ExitPolicy::within(timeout > 0 ? timeout : motion_timeout(stream.length * stream.dt));
+			follow_trajectory(stream, odometry, drive_lft, drive_rt, sensors, wiring::drive, exit);
+		}
+		else
+		{
+			printf("trajectory %s: built in\n", table.name);
+			ExitPolicy exit = ExitPolicy::within(timeout > 0 ? timeout : motion_timeout(table.length * table.dt));
+			follow_trajectory(table, odometry, drive_lft, drive_rt, sensors, wiring::drive, exit);
+		}
+	});
+}
+
+int turn_step(ActionGraph &g, const char *name, std::vector<int> after, double target)
+{
+	return g.task(name, after, [target] { imu_turning_2(target); });
+}
+
+// isSettled() works in motor rotations with okapi's default 50 unit error, so
+// it is always true for the lift; check the error against a real tolerance
+bool lift_at_target(uint32_t t)
+{
+	return std::abs(lift_front_control->getError()) < LIFT_TOLERANCE || t >= 2000;
+}
+
+int lift_step(ActionGraph &g, const char *name, std::vector<int> after, double target)
+{
+	return g.add(name, after, [target] { lift_front_control->setTarget(target); }, lift_at_target);
+}
+
+// Pistons give no feedback, so a piston step lasts as long as it takes to actuate
+int piston_step(ActionGraph &g, const char *name, std::vector<int> after, std::shared_ptr<pros::ADIDigitalOut> piston, bool value, uint32_t ms)
+{
+	return g.add(name, after, [piston, value] { piston->set_value(value); }, ActionGraph::elapsed(ms));
+}
+
+int intake_step(ActionGraph &g, const char *name, std::vector<int> after, int voltage)
+{
+	return g.add(name, after, [voltage] { intake->moveVoltage(voltage); }, ActionGraph::at_once());
+}
+
+/*
+	Skills as a graph. The order is the old sequential routine's; steps only
+	wait on what they physically need, so the lift travels while the robot
+	drives and turns, and a turn starts once a goal is clamped rather than
+	after the tilter has finished moving.
+*/
+void build_skills(ActionGraph &g)
+{
+	double move_vel = 105;
+
+	//grabbing the balance goal
+	int open_front = piston_step(g, "front claw release", {}, front_claw_piston, FRONT_CLAW_RELEASE, 0);
+	int open_back = piston_step(g, "back claw release", {}, back_claw_piston, BACK_CLAW_RELEASE, 0);
+	int tilt_down = piston_step(g, "back tilter down", {}, back_tilter, BACK_TILTER_DOWN, 750);
+	int back_in = drive_step(g, "back into balance goal", {open_front, open_back, tilt_down}, -15_in, move_vel);
+	int grab_back = piston_step(g, "back claw grab", {back_in}, back_claw_piston, BACK_CLAW_GRAB, 500);
+	int tilt_up = piston_step(g, "back tilter up", {grab_back}, back_tilter, BACK_TILTER_UP, 500);
+
+	//grabbing left goal: out 15in at 20 deg, then 4.75ft at 103 deg, without stopping between
+	int to_left = path_step(g, "path to left goal", {grab_back}, {{-15_in, 0_in}, {-0.9_in, 5.1_in}, {-13.7_in, 60.7_in}}, PATH_VELOCITY);
+	int grab_left = piston_step(g, "front claw grab left", {to_left, tilt_up}, front_claw_piston, FRONT_CLAW_GRAB, 500);
+
+	//grabbing rings: 1.5ft on, then 2.5ft at 180 deg
+	int lift_plat = lift_step(g, "lift to platform", {grab_left}, FRONT_LIFT_PLAT);
+	int intake_on = intake_step(g, "intake in", {grab_left}, INTAKE_IN);
+	int rings = path_step(g, "path through rings", {grab_left}, {{-13.7_in, 60.7_in}, {-17.8_in, 78.2_in}, {-47.8_in, 78.2_in}}, PATH_VELOCITY * 0.7);
+	int settle_rings = g.wait("rings settle", {rings, intake_on}, 1000);
+	int turn_90 = turn_step(g, "turn 90", {settle_rings}, 90);
+
+	//placing the left goal onto the balance
+	int to_balance = drive_step(g, "drive to balance", {turn_90}, 2.25_ft, move_vel, 750);
+	int intake_off = intake_step(g, "intake off", {to_balance}, 0);
+	int lift_place = lift_step(g, "lift to place", {to_balance, lift_plat}, FRONT_LIFT_PLAT_PLACE);
+	int square_90 = turn_step(g, "square up 90", {to_balance}, 90);
+	int drop_left = piston_step(g, "front claw release left", {square_90, lift_place}, front_claw_piston, FRONT_CLAW_RELEASE, 0);
+
+	//place the alliance goal
+	//drop, move back, claw dowm, turn around and lift the goal, and drop
+	//Drop alliance
+	int tilt_drop = piston_step(g, "back tilter down", {drop_left}, back_tilter, BACK_TILTER_DOWN, 0);
+	int back_off = drive_step(g, "back off 1.25ft", {drop_left, tilt_drop}, -1.25_ft, move_vel);
+	int drop_alliance = piston_step(g, "back claw release", {back_off}, back_claw_piston, BACK_CLAW_RELEASE, 500);
+	int lift_down = lift_step(g, "lift down", {drop_alliance, intake_off}, FRONT_LIFT_DOWN);
+	int clear = drive_step(g, "drive 0.75ft", {drop_alliance}, 0.75_ft, move_vel);
+	//Regrab alliance
+	int turn_m90 = turn_step(g, "turn -90", {clear}, -90);
+	int to_alliance = drive_step(g, "drive to alliance", {turn_m90}, 1.35_ft, move_vel);
+	int grab_alliance = piston_step(g, "front claw grab alliance", {to_alliance, lift_down}, front_claw_piston, FRONT_CLAW_GRAB, 250);
+	int lift_alliance = lift_step(g, "lift alliance", {grab_alliance}, FRONT_LIFT_PLAT);
+	//Grab big yellow
+	int turn_90b = turn_step(g, "turn 90", {grab_alliance}, 90);
+	int back_yellow = drive_step(g, "back into yellow", {turn_90b}, -1.5_ft, 60);
+	int grab_yellow = piston_step(g, "back claw grab yellow", {back_yellow}, back_claw_piston, BACK_CLAW_GRAB, 500);
+	int tilt_yellow = piston_step(g, "back tilter up", {grab_yellow}, back_tilter, BACK_TILTER_UP, 0);
+	//Place Yellow
+	int turn_80 = turn_step(g, "turn 80", {grab_yellow, tilt_yellow}, 80);
+	int to_place = drive_step(g, "drive to balance", {turn_80}, 4.25_ft, move_vel, 2000);
+	int lift_place2 = lift_step(g, "lift to place", {to_place, lift_alliance}, FRONT_LIFT_PLAT_PLACE);
+	int drop_alliance2 = piston_step(g, "front claw release alliance", {lift_place2}, front_claw_piston, FRONT_CLAW_RELEASE, 500);
+
+	//grab Alliance
+	int back_3 = drive_step(g, "back off 3in", {drop_alliance2}, -3_in, move_vel);
+	int turn_0 = turn_step(g, "turn 0", {back_3}, 0);
+	int lift_down2 = lift_step(g, "lift down", {back_3}, FRONT_LIFT_DOWN);
+	int to_alliance2 = drive_step(g, "drive 5ft", {turn_0}, 5_ft, move_vel);
+	int grab_alliance2 = piston_step(g, "front claw grab alliance", {to_alliance2, lift_down2}, front_claw_piston, FRONT_CLAW_GRAB, 500);
+	int back_1 = drive_step(g, "back off 1ft", {grab_alliance2}, -1_ft, move_vel);
+	int lift_plat2 = lift_step(g, "lift to platform", {grab_alliance2}, FRONT_LIFT_PLAT);
+
+	//Go to balance: 4ft on, then round to 180 deg and 6ft to the wall in one trajectory
+	int turn_m90b = turn_step(g, "turn -90", {back_1}, -90);
+	int intake_on2 = intake_step(g, "intake in", {turn_m90b}, INTAKE_IN);
+	int sweep = trajectory_step(g, "sweep rings to the wall", {turn_m90b}, paths::ring_sweep_id, 6000);
+	int back_1b = drive_step(g, "back off 1ft", {sweep}, -1_ft, move_vel);
+	int intake_off2 = intake_step(g, "intake off", {back_1b, intake_on2}, 0);
+	int turn_m180b = turn_step(g, "square up -180", {back_1b}, -180);
+	int back_4 = drive_step(g, "back 4ft", {turn_m180b}, -4_ft, move_vel, 750);
+	int turn_m90c = turn_step(g, "turn -90", {back_4}, -90);
+	int line_up = drive_step(g, "line up with balance", {turn_m90c}, 1.65_ft, move_vel);
+	int lift_down3 = g.add("lift down for balance", {line_up, lift_plat2, intake_off2},
+						   [] {
+							   chassis->setMaxVelocity(80);
+							   drive_lft->setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
+							   drive_rt->setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
+							   lift_front_control->setTarget(FRONT_LIFT_DOWN);
+						   },
+						   lift_at_target);
+	int balanced = g.task("balance and hold", {lift_down3}, [] { balance(drive_lft, drive_rt, sensors, display, 2000); });
+	g.add("release", {balanced},
+		  [] {
+			  back_tilter->set_value(BACK_TILTER_DOWN);
+			  drive_lft->moveVoltage(0);
+			  drive_rt->moveVoltage(0);
+		  },
+		  ActionGraph::at_once());
+}
+
+// What driver control has toggled, packed into the mechanism word a recording keeps
+struct DriverState
+{
+	int intake_flag = 0;
+	bool front_flag = false;
+	bool back_lock = true;
+	bool back_tilt = true;
+	bool chassis_hold = false;
+
+	uint32_t pack() const
+	{
+		return (intake_flag + 1) | front_flag << 2 | back_lock << 3 | back_tilt << 4 | chassis_hold << 5;
+	}
+
+	void unpack(uint32_t word)
+	{
+		intake_flag = (int)(word & 3) - 1;
+		front_flag = word & (1 << 2);
+		back_lock = word & (1 << 3);
+		back_tilt = word & (1 << 4);
+		chassis_hold = word & (1 << 5);
+	}
+};
+
+/**
+ * Driver control on the controllers, or on a recording of it when player is
+ * set, in which case it returns when the recording runs out. Y starts and
+ * stops recording the controllers to the SD card.
+ */
+void driver_control(std::shared_ptr<InputPlayer> player)
+{
+	DriverState state;
+	int back_timer = 0;
+	int front_timer = 0;
+	int y_timer = -1000;
+
+	int double_tap = 0;
+	int move_volt = 11000;
+	int dt = 0;
+	bool restored = false;
+	FixedRateLoop loop(20);
+	// X and Y are master only; the partner drives the mechanisms
+	uint32_t mechanism_buttons = ControllerInput::buttons({DIGITAL_R1, DIGITAL_R2, DIGITAL_L1, DIGITAL_L2, DIGITAL_UP,
+		DIGITAL_DOWN, DIGITAL_LEFT, DIGITAL_RIGHT, DIGITAL_A, DIGITAL_B});
+	ControllerInput input(master, partner, mechanism_buttons | ControllerInput::buttons({DIGITAL_X, DIGITAL_Y}),
+		mechanism_buttons);
+	while (true)
+	{
+		if (player)
+		{
+			if (!player->next(input))
+			{
+				break;
+			}
+			dt = player->tick_length();
+			if (!restored && state.pack() != player->get_mechanism())
+			{
+				// the recording started partway through a match; put the mechanisms where they were
+				state.unpack(player->get_mechanism());
+				front_claw_piston->set_value(state.front_flag);
+				back_claw_piston->set_value(!state.back_lock);
+				back_tilter->set_value(!state.back_tilt);
+			}
+			restored = true;
+		}
+		else
+		{
+			input.poll();
+		}
+
+		if (y_timer > 0) {
+			y_timer = y_timer - dt;
+		}
+
+		// Driving Mechanics
+		double y = input.analog(ANALOG_LEFT_Y);
+		double x = 0; // input.analog(ANALOG_LEFT_X);
+		double z = -input.analog(ANALOG_RIGHT_X);
+		double lft_fix = player ? player->left_correction : 0;
+		double rt_fix = player ? player->right_correction : 0;
+
+		front_rt_cmd->moveVoltage((y + x + z) / 127 * move_volt + rt_fix);
+		back_rt_cmd->moveVoltage((y - x + z) / 127 * move_volt + rt_fix);
+		front_lft_cmd->moveVoltage((y - x - z) / 127 * move_volt + lft_fix);
+		back_lft_cmd->moveVoltage((y + x - z) / 127 * move_volt + lft_fix);
+
+		if (input.held(DIGITAL_R2))
+		{
+			lift_front_control->setTarget(FRONT_LIFT_DOWN);
+			state.intake_flag = 0;
+			// front_claw_control->setTarget(0);
+		}
+		else if (input.held(DIGITAL_R1))
+		{
+			lift_front_control->setTarget(FRONT_LIFT_PLAT);
+			// front_claw_control->setTarget(1.0/4.0);
+		}
+		else if (lift_front_control->isSettled())
+		{
+			lift_front->moveVelocity(0);
+		}
+
+		
+
+		if (input.pressed(DIGITAL_LEFT))
+		{
+			state.chassis_hold = !state.chassis_hold;
+		}
+
+		if (state.chassis_hold)
+		{
+			drive_lft_cmd->setBrakeMode(okapi::AbstractMotor::brakeMode::brake);
+			drive_rt_cmd->setBrakeMode(okapi::AbstractMotor::brakeMode::brake);
+			move_volt = 6000;
+		}
+		else
+		{
+			drive_lft_cmd->setBrakeMode(okapi::AbstractMotor::brakeMode::coast);
+			drive_rt_cmd->setBrakeMode(okapi::AbstractMotor::brakeMode::coast);
+			move_volt = 11000;
+		}
+
+		// Intake
+		if (input.held(DIGITAL_UP))
+		{
+			state.intake_flag = -1;
+		}
+		else if (input.held(DIGITAL_DOWN))
+		{
+			state.intake_flag = 1;
+		}
+		else if (input.held(DIGITAL_RIGHT))
+		{
+			state.intake_flag = 0;
+			double_tap++;
+		}
+		if (state.intake_flag == 1)
+		{
+			intake_cmd->moveVoltage(12000);
+		}
+		else if (state.intake_flag == -1)
+		{
+			intake_cmd->moveVoltage(-12000);
+		}
+		else
+		{
+			intake_cmd->moveVoltage(0);
+		}
+
+		
+		if (input.pressed(DIGITAL_B))
+		{
+			state.front_flag = !state.front_flag;
+			front_claw_piston->set_value(state.front_flag);
+		}	
+
+		if (y_timer == -1000 && input.pressed(DIGITAL_L1))
+		{
+			if(state.back_lock) {
+				state.back_tilt = true;	
+				back_tilter->set_value(!state.back_tilt);
+			}
+			else {
+				y_timer = 500;
+			}
+			state.back_lock = true;
+			back_claw_piston->set_value(!state.back_lock);
+		}
+		else if (input.held(DIGITAL_L2))
+		{
+			state.back_tilt = false;
+			back_tilter->set_value(!state.back_tilt);
+		}
+
+		// an eight second spin in place, so only in the pits, never on a competition field
+		if (!player && !pros::competition::is_connected() && input.double_tapped(DIGITAL_X))
+		{
+			turn_gains = measure_turn_gains(drive_lft, drive_rt, sensors, turn_gains);
+			display->print(2, 0, "S%.0f V%.1f A%.2f", turn_gains.kS, turn_gains.kV, turn_gains.kA);
+			CachedMotors::invalidate();
+		}
+
+		if (!state.back_tilt && input.pressed(DIGITAL_A)) {
+			state.back_lock = !state.back_lock;
+			back_claw_piston->set_value(!state.back_lock);
+		}
+
+		if(y_timer != -1000 && y_timer <= 0) {
+			state.back_tilt = true;
+			back_tilter->set_value(!state.back_tilt);
+			y_timer = -1000;
+		}
+
+		if (!player && input.pressed(DIGITAL_Y))
+		{
+			if (!recorder->recording())
+			{
+				recorder->start();
+				display->print(2, 0, "Recording");
+			}
+			else if (recorder->stop())
+			{
+				display->print(2, 0, "Saved %u ticks", recorder->get_ticks());
+			}
+			else
+			{
+				display->print(2, 0, "No SD card");
+			}
+		}
+
+		double lft_pos = drive_lft->getPosition();
+		double rt_pos = drive_rt->getPosition();
+		if (player)
+		{
+			player->check(state.pack(), lft_pos, rt_pos);
+		}
+		else
+		{
+			recorder->record(input.latest(), state.pack(), lft_pos, rt_pos);
+			dt = loop.next();
+			if (loop.report_every(500, "driver control"))
+			{
+				CachedMotors::report("driver control");
+			}
+		}
+	}
+}
+
+/*
+	Queues what the selected auton needs on the precompute service. It runs
+	whenever the service has nothing to do, so picking another auton while
+	disabled queues that one's work too; autonomous() and opcontrol() stop
+	the service and use whatever finished.
+*/
+void queue_auton_work()
+{
+	static std::vector<int> queued; // autons whose work is queued already
+	int auton = selector::auton;
+	if (std::find(queued.begin(), queued.end(), auton) != queued.end())
+	{
+		return;
+	}
+	queued.push_back(auton);
+	if (auton == 0)
+	{
+		// checking a trajectory file's CRC reads all of it off the card, which
+		// is fine now and not in the middle of the route
+		precompute->add("trajectory files", [](const Precompute &p) {
+			std::map<uint16_t, std::shared_ptr<TrajectoryStream>> found;
+			for (uint16_t id = 0; pros::usd::is_installed() && id < trajectories->size(); id++)
+			{
+				if (p.cancelled())
+				{
+					return false;
+				}
+				std::shared_ptr<TrajectoryStream> stream = open_sd_trajectory(trajectories->get(id), p);
+				if (stream)
+				{
+					found[id] = stream;
+				}
+			}
+			if (p.cancelled())
+			{
+				return false; // the last file may have been cut short
+			}
+			sd_trajectories = found;
+			return true;
+		});
+		// graph steps build their pursuit paths as they are added
+		precompute->add("skills graph", [](const Precompute &) {
+			std::shared_ptr<ActionGraph> g(new ActionGraph());
+			build_skills(*g);
+			skills_graph = g;
+			return true;
+		});
+	}
+	else if (abs(auton) == 4)
+	{
+		// finding the newest recording opens every file before it on the SD card
+		precompute->add("replay recording", [](const Precompute &) {
+			char path[48];
+			if (!latest_recording("/usd", path, sizeof(path)))
+			{
+				return true;
+			}
+			std::shared_ptr<InputPlayer> player(new InputPlayer(path));
+			if (player->load())
+			{
+				replay_player = player;
+			}
+			return true;
+		});
+	}
+	else
+	{
+		// the rush's goal filter starts from the distance the goal stands at,
+		// settled over the readings taken while disabled, not one noisy reading
+		// taken already moving
+		precompute->add("goal approach", [](const Precompute &p) {
+			std::shared_ptr<GoalApproach> approach(new GoalApproach(RUSH_CONTACT_MM, RUSH_CLAW_LEAD));
+			uint32_t last = 0;
+			int readings = 0;
+			while (readings < 10)
+			{
+				if (p.cancelled())
+				{
+					return false;
+				}
+				SensorSnapshot s = sensors->latest();
+				if (s.time != last && s.distance > 0 && s.distance_confidence >= approach->min_confidence)
+				{
+					approach->update(s);
+					last = s.time;
+					readings++;
+				}
+				pros::delay(20);
+			}
+			rush_approach = approach;
+			return true;
+		});
+	}
+}
 
 /**
  * Runs the user autonomous code. This function will be started in its own task
@@ -136,132 +797,61 @@ void competition_initialize() {}
 // original autonomous code
 void autonomous()
 {
+	precompute->stop();
 	lift_front_control->tarePosition();
 	chassis->stop();
 	chassis->setMaxVelocity(200);
 	if (selector::auton == 0)
 	{
-		int move_vel = 105;
-		chassis->setMaxVelocity(move_vel);
-		//grabbing the balance goal
-		front_claw_piston->set_value(FRONT_CLAW_RELEASE); 
-		back_claw_piston->set_value(BACK_CLAW_RELEASE); 
-
-		back_tilter->set_value(BACK_TILTER_DOWN); 
-		pros::delay(750);
-		chassis->moveDistance(-15_in);
-		back_claw_piston->set_value (BACK_CLAW_GRAB);
-		pros::delay(500);
-		back_tilter->set_value(BACK_TILTER_UP); 
-		pros::delay(500);
-		imu_turning_2(20);
-		chassis->moveDistance(15_in);
-		
-		//grabbing left goal
-		imu_turning_2(103);
-		chassis->moveDistance(4.75_ft);
-		front_claw_piston->set_value(FRONT_CLAW_GRAB);
-		pros::delay(500);
-
-        //grabbing rings
-		chassis->setMaxVelocity(move_vel*0.7);
-	    lift_front_control->setTarget(FRONT_LIFT_PLAT);
-		chassis->moveDistance(1.5_ft);
-		imu_turning_2(180);
-		intake->moveVoltage(INTAKE_IN);
-		chassis->moveDistance(2.5_ft);
-		pros::delay(1000);
-		chassis->setMaxVelocity(move_vel);
-		imu_turning_2(90);
-
-		//placing the left goal onto the balance
-		chassis->moveDistanceAsync(2.25_ft);
-		pros::delay(750);
-		chassis->stop();
-		intake->moveVoltage(0);
-	    lift_front_control->setTarget(FRONT_LIFT_PLAT_PLACE);
-		imu_turning_2(90);
-		front_claw_piston->set_value (FRONT_CLAW_RELEASE);
-
-		//place the alliance goal 
-		//drop, move back, claw dowm, turn around and lift the goal, and drop
-		//Drop alliance
-		back_tilter->set_value(BACK_TILTER_DOWN);
-		chassis->moveDistance(-1.25_ft);
-		back_claw_piston->set_value (BACK_CLAW_RELEASE);
-		pros::delay(500);
-		lift_front_control->setTarget(FRONT_LIFT_DOWN);
-		chassis->moveDistance(0.75_ft);
-		//Regrab alliance
-		imu_turning_2(-90);
-		chassis->moveDistance(1.35_ft);
-		front_claw_piston->set_value (FRONT_CLAW_GRAB);
-		pros::delay(250);
-		lift_front_control->setTarget(FRONT_LIFT_PLAT);
-		//Grab big yellow
-		imu_turning_2(90);
-		chassis->setMaxVelocity(60);
-		chassis->moveDistance(-1.5_ft);
-		chassis->setMaxVelocity(move_vel);
-		back_claw_piston->set_value(BACK_CLAW_GRAB);
-		pros::delay(500);
-		back_tilter->set_value(BACK_TILTER_UP);
-		//Place Yellow
-		imu_turning_2(80);
-		chassis->moveDistanceAsync(4.25_ft);
-		int timer = 0;
-		while(!chassis->isSettled() && timer <= 2000) {
-			pros::delay(100);
-			timer = timer+100;
-		}
-		chassis->stop();
-		lift_front_control->setTarget(FRONT_LIFT_PLAT_PLACE);
-		pros::delay(500);
-		front_claw_piston->set_value (FRONT_CLAW_RELEASE);
-		pros::delay(500);
-
-		//grab Alliance
-		chassis->moveDistance(-3_in);
-		imu_turning_2(0);
-		lift_front_control->setTarget(FRONT_LIFT_DOWN);
-		chassis->moveDistance(5_ft);
-		front_claw_piston->set_value(FRONT_CLAW_GRAB);
-		pros::delay(500);
-		chassis->moveDistance(-1_ft);
-		lift_front_control->setTarget(FRONT_LIFT_PLAT);
-
-		//Go to balance
-		imu_turning_2(-90);
-		intake->moveVoltage(INTAKE_IN);
-		chassis->moveDistance(4_ft);
-		imu_turning_2(-180);
-		chassis->moveDistanceAsync(6_ft);
-		timer = 0;
-		while(!chassis->isSettled() && timer <= 3500) {
-			pros::delay(100);
-			timer = timer+100;
-		}
-		chassis->moveDistance(-1_ft);
-		intake->moveVoltage(0);
-		imu_turning_2(-180);
-		chassis->moveDistanceAsync(-4_ft);
-		timer = 0;
-		while(!chassis->isSettled() && timer <= 750) {
-			pros::delay(100);
-			timer = timer+100;
-		}
-		imu_turning_2(-90);
-		chassis->moveDistance(1.65_ft);
-		chassis->setMaxVelocity(80);		
-		drive_lft->setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
-		drive_rt->setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
-		lift_front_control->setTarget(FRONT_LIFT_DOWN);
-		pros::delay(2000);
-		balance(chassis, imu, master);
-		pros::delay(2000);
-		back_tilter->set_value(BACK_TILTER_DOWN);
+		odometry->set_state(okapi::OdomState());
+		std::shared_ptr<ActionGraph> built = skills_graph;
+		skills_graph = nullptr; // a graph only runs once
+		if (!built)
+		{
+			built.reset(new ActionGraph());
+			build_skills(*built);
+		}
+		ActionGraph &skills = *built;
+		skills.on_start = [](int id) { telemetry->set_step(id); };
+		skills.on_cancel = [] {
+			chassis->stop();
+			drive_lft->moveVoltage(0);
+			drive_rt->moveVoltage(0);
+		};
+		running_graph = built;
+		skills.run();
+		running_graph = nullptr;
+		telemetry->set_step(TELEMETRY_NO_STEP);
+		telemetry->flush();
+		skills.report();
+		odometry->log();
+	}
+	else if (abs(selector::auton) == 4)
+	{
+		std::shared_ptr<InputPlayer> player = replay_player;
+		replay_player = nullptr;
+		if (!player)
+		{
+			char path[48];
+			if (!latest_recording("/usd", path, sizeof(path)))
+			{
+				display->print(2, 0, "No recording");
+				return;
+			}
+			player.reset(new InputPlayer(path));
+			if (!player->load())
+			{
+				display->print(2, 0, "Bad recording");
+				return;
+			}
+		}
+		player->correct = REPLAY_CORRECTION;
+		CachedMotors::invalidate();
+		driver_control(player);
 		drive_lft->moveVoltage(0);
 		drive_rt->moveVoltage(0);
+		intake->moveVoltage(0);
+		player->log();
 	}
 	else
 	{
@@ -269,54 +859,61 @@ void autonomous()
 		drive_rt->setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
 
 		//Grab Yellow
-		int DIST = 35;
+		int DIST = RUSH_CONTACT_MM;
 		drive_rt->moveVoltage(12000);
 		drive_lft->moveVoltage(12000);
 		front_claw_piston->set_value(true);
-		int move_time = 100;
 
 		drive_lft->setBrakeMode(okapi::AbstractMotor::brakeMode::brake);
 		drive_rt->setBrakeMode(okapi::AbstractMotor::brakeMode::brake);
-		int MAX_TIME = 1400;
-		int lowest_dist = dist_sensor->get();
-		while((dist_sensor->get() > DIST || dist_sensor->get() == 0) && move_time < MAX_TIME) {
-			// if(dist_sensor->get() < 350 && dist_sensor->get() != 0) {
-			// 	drive_rt->moveVoltage(6000);
-			// 	drive_lft->moveVoltage(6000);
-			// 	MAX_TIME = MAX_TIME+3;
-			// }
-			pros::delay(5);
-			move_time += 5;
-			lowest_dist = dist_sensor->get();
-			master->print(0, 0, "Dist: %d", lowest_dist);
+		uint32_t MAX_TIME = 1400;
+		GoalApproach approach(DIST, RUSH_CLAW_LEAD);
+		if (rush_approach)
+		{
+			approach = *rush_approach;
+			rush_approach = nullptr;
 		}
-		front_claw_piston->set_value(false);
+		uint32_t rush_start = pros::millis();
+		uint32_t now = rush_start;
+		bool grabbed = false;
+		bool braked = false;
+		while((!grabbed || !braked) && now - rush_start < MAX_TIME) {
+			SensorSnapshot s = sensors->latest();
+			approach.update(s);
+			if(!grabbed && approach.fire_claw()) {
+				front_claw_piston->set_value(FRONT_CLAW_GRAB);
+				grabbed = true;
+			}
+			if(!braked && approach.fire_brake()) {
+				drive_rt->moveVoltage(0);
+				drive_lft->moveVoltage(0);
+				braked = true;
+			}
+			display->print(0, 0, "Dist: %d", (int) s.distance);
+			pros::Task::delay_until(&now, 5);
+		}
+		front_claw_piston->set_value(FRONT_CLAW_GRAB);
 		drive_rt->moveVoltage(0);
 		drive_lft->moveVoltage(0);
-		if(false && dist_sensor->get() <= DIST) {
-			chassis->turnAngleAsync(90_deg);
-			pros::delay(3000);
-			chassis->stop();
-			chassis->moveDistanceAsync(-2_ft);
-			pros::delay(3000);
-			chassis->stop();
-			chassis->turnAngleAsync(45_deg);
-			pros::delay(3000);
-			chassis->stop();
-			chassis->moveDistanceAsync(3_ft);
-			pros::delay(3000);
-			chassis->stop();
+		if(false && sensors->latest().distance <= DIST) {
+			turn_angle(chassis, sensors, 90_deg, ExitPolicy::within(3000));
+			move_distance(chassis, sensors, -2_ft, ExitPolicy::within(3000));
+			turn_angle(chassis, sensors, 45_deg, ExitPolicy::within(3000));
+			move_distance(chassis, sensors, 3_ft, ExitPolicy::within(3000));
 		}
 		else {
-			pros::delay(150);
+			// let the claw finish closing, and see when the goal actually got there
+			for(uint32_t t = pros::millis(); pros::millis() - t < 150;) {
+				approach.update(sensors->latest());
+				pros::delay(5);
+			}
+			approach.log();
 			lift_front_control->setTarget(FRONT_LIFT_MOVE);
 			chassis->moveDistance(-4.5_ft);
 			chassis->setMaxVelocity(100);
 			chassis->turnAngle(-15_deg);
 			chassis->waitUntilSettled();
-			chassis->moveDistanceAsync(-2.5_ft);
-			pros::delay(1500);
-			chassis->stop();
+			move_distance(chassis, sensors, -2.5_ft, ExitPolicy::within(1500));
 			chassis->moveDistance(0.4_ft);
 			back_claw_piston->set_value(true);
 			back_tilter->set_value(true);
@@ -326,10 +923,9 @@ void autonomous()
 			chassis->waitUntilSettled();
 			// if (selector::auton < 0)
 			// {
-			// 	turn_to_goal(camera, drive_lft, drive_rt, BLUE);
+			// 	turn_to_goal(goals, drive_lft, drive_rt, BLUE);
 			// }
-			chassis->moveDistanceAsync(-2.5_ft);
-			pros::delay(1500);
+			move_distance(chassis, sensors, -2.5_ft, ExitPolicy::within(1500));
 			back_claw_piston->set_value(false);
 			pros::delay(500);
 			back_tilter->set_value(false);
@@ -344,7 +940,7 @@ void autonomous()
 		chassis->setMaxVelocity(40);
 		chassis->moveDistance(-1.75_ft);
 		intake->moveVoltage(INTAKE_IN);
-		if(dist_sensor->get() > DIST) {
+		if(sensors->latest().distance > DIST) {
 			front_claw_piston->set_value(false);
 		}
 		chassis->moveDistance(.75_ft);
@@ -370,8 +966,7 @@ void autonomous()
 	chassis->moveDistance(1.5_ft);
 	lift_front_control->setTarget(FRONT_LIFT_DOWN);
 	pros::delay(1500);
-	balance(chassis, imu, master);
-	pros::delay(2000);
+	balance(drive_lft, drive_rt, sensors, display, 2000);
 	back_tilter->set_value(BACK_TILTER_DOWN);
 	drive_lft->moveVoltage(0);
 	drive_rt->moveVoltage(0);
@@ -396,153 +991,11 @@ void autonomous()
  */
 void opcontrol()
 {
+	stop_auton();
+	precompute->stop();
 	chassis->stop();
+	// auton and the chassis controller wrote to the motors behind the cache's back
+	CachedMotors::invalidate();
 	chassis->setMaxVelocity(200);
-	int intake_flag = 0;
-	int chassis_mode_delay = 0;
-	int front_claw_timer = 0;
-	int back_claw_timer = 0;
-	bool front_flag = false;
-	bool back_lock = true;
-	bool back_tilt = true;
-	bool chassis_hold = false;
-	int back_timer = 0;
-	int front_timer = 0;
-	int y_timer = -1000;
-
-	int double_tap = 0;
-	int move_volt = 11000;
-	while (true)
-	{
-
-		// Driving Mechanics
-		double y = master->get_analog(ANALOG_LEFT_Y);
-		double x = 0; // master->get_analog(ANALOG_LEFT_X);
-		double z = -master->get_analog(ANALOG_RIGHT_X);
-
-		front_rt->moveVoltage((y + x + z) / 127 * move_volt);
-		back_rt->moveVoltage((y - x + z) / 127 * move_volt);
-		front_lft->moveVoltage((y - x - z) / 127 * move_volt);
-		back_lft->moveVoltage((y + x - z) / 127 * move_volt);
-
-		if (master->get_digital(DIGITAL_R2) || partner->get_digital(DIGITAL_R2))
-		{
-			lift_front_control->setTarget(FRONT_LIFT_DOWN);
-			intake_flag = 0;
-			// front_claw_control->setTarget(0);
-		}
-		else if (master->get_digital(DIGITAL_R1) || partner->get_digital(DIGITAL_R1))
-		{
-			lift_front_control->setTarget(FRONT_LIFT_PLAT);
-			// front_claw_control->setTarget(1.0/4.0);
-		}
-		else if (lift_front_control->isSettled())
-		{
-			lift_front->moveVelocity(0);
-		}
-
-		
-
-		if ((master->get_digital(DIGITAL_LEFT) || partner->get_digital(DIGITAL_LEFT)) && chassis_mode_delay <= 0)
-		{
-			chassis_hold = !chassis_hold;
-			chassis_mode_delay = 200;
-		}
-
-		if (chassis_hold)
-		{
-			drive_lft->setBrakeMode(okapi::AbstractMotor::brakeMode::brake);
-			drive_rt->setBrakeMode(okapi::AbstractMotor::brakeMode::brake);
-			move_volt = 6000;
-		}
-		else
-		{
-			drive_lft->setBrakeMode(okapi::AbstractMotor::brakeMode::coast);
-			drive_rt->setBrakeMode(okapi::AbstractMotor::brakeMode::coast);
-			move_volt = 11000;
-		}
-
-		// Intake
-		if (master->get_digital(DIGITAL_UP) || partner->get_digital(DIGITAL_UP))
-		{
-			intake_flag = -1;
-		}
-		else if (master->get_digital(DIGITAL_DOWN) || partner->get_digital(DIGITAL_DOWN))
-		{
-			intake_flag = 1;
-		}
-		else if (master->get_digital(DIGITAL_RIGHT) || partner->get_digital(DIGITAL_RIGHT))
-		{
-			intake_flag = 0;
-			double_tap++;
-		}
-		if (intake_flag == 1)
-		{
-			intake->moveVoltage(12000);
-		}
-		else if (intake_flag == -1)
-		{
-			intake->moveVoltage(-12000);
-		}
-		else
-		{
-			intake->moveVoltage(0);
-		}
-
-		
-		if (front_claw_timer <= 0 && (master->get_digital(DIGITAL_B) || partner->get_digital(DIGITAL_B)))
-		{
-			front_claw_timer = 300;
-			front_flag = !front_flag;
-			front_claw_piston->set_value(front_flag);
-		}	
-
-		if (y_timer == -1000 && (master->get_digital(DIGITAL_L1) || partner->get_digital(DIGITAL_L1)))
-		{
-			if(back_lock) {
-				back_tilt = true;	
-				back_tilter->set_value(!back_tilt);
-			}
-			else {
-				y_timer = 500;
-			}
-			back_lock = true;
-			back_claw_piston->set_value(!back_lock);
-		}
-		else if (master->get_digital(DIGITAL_L2) || partner->get_digital(DIGITAL_L2))
-		{
-			back_tilt = false;
-			back_tilter->set_value(!back_tilt);
-		}
-
-		if (!back_tilt && back_claw_timer <= 0 && (master->get_digital(DIGITAL_A) || partner->get_digital(DIGITAL_A))) {
-			back_lock = !back_lock;
-			back_claw_piston->set_value(!back_lock);
-			back_claw_timer = 300;
-		}
-
-		if(y_timer != -1000 && y_timer <= 0) {
-			back_tilt = true;
-			back_tilter->set_value(!back_tilt);
-			y_timer = -1000;
-		}
-
-		pros::delay(20);
-
-		if (chassis_mode_delay > 0)
-		{
-			chassis_mode_delay = chassis_mode_delay - 20;
-		}
-		if (front_claw_timer > 0)
-		{
-			front_claw_timer = front_claw_timer - 20;
-		}
-		if (back_claw_timer > 0)
-		{
-			back_claw_timer = back_claw_timer - 20;
-		}
-		if (y_timer > 0) {
-			y_timer = y_timer - 20;
-		}
-	}
-}
\ No newline at end of file
+	driver_control(nullptr);
+}
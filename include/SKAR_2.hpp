@@ -14,6 +14,62 @@
 #define AUTON_CPP
 #include "auton_util.cpp"
 #endif
+#ifndef MOTOR_CACHE_CPP
+#define MOTOR_CACHE_CPP
+#include "motor_cache.cpp"
+#endif
+#ifndef HARDWARE_CPP
+#define HARDWARE_CPP
+#include "hardware.cpp"
+#endif
+#include "SKAR_2_paths.hpp"
+
+#include <map>
+
+// Every port on the robot; the build fails if two devices share one
+namespace wiring
+{
+	using okapi::AbstractMotor;
+	using namespace okapi::literals;
+
+	constexpr MotorSpec front_rt1{1, false, AbstractMotor::gearset::green};
+	constexpr MotorSpec front_rt2{2, true, AbstractMotor::gearset::green};
+	constexpr MotorSpec back_rt1{3, true, AbstractMotor::gearset::green};
+	constexpr MotorSpec back_rt2{11, false, AbstractMotor::gearset::green};
+	constexpr MotorSpec front_lft1{10, true, AbstractMotor::gearset::green};
+	constexpr MotorSpec front_lft2{9, false, AbstractMotor::gearset::green};
+	constexpr MotorSpec back_lft1{20, true, AbstractMotor::gearset::green};
+	constexpr MotorSpec back_lft2{8, false, AbstractMotor::gearset::green};
+
+	constexpr MotorSpec lift_front_lft{19, true, AbstractMotor::gearset::red};
+	constexpr MotorSpec lift_front_rt{12, false, AbstractMotor::gearset::red};
+
+	constexpr MotorSpec intake_lft{14, true, AbstractMotor::gearset::green};
+	constexpr MotorSpec intake_rt{13, false, AbstractMotor::gearset::green};
+
+	constexpr uint8_t imu = 4;
+	constexpr uint8_t dist_sensor = 16;
+	constexpr uint8_t camera = 17; // not mounted right now
+
+	constexpr char front_claw_piston = 'A';
+	constexpr char back_tilter = 'B';
+	constexpr char back_claw_piston = 'C';
+
+	// 3.25 in wheels on a 3:5 reduction, 12.4375 in track
+	constexpr DriveSpec drive{AbstractMotor::gearset::green, 3.0 / 5.0, 3.25_in, 12.4375_in, okapi::imev5GreenTPR};
+
+	constexpr uint8_t smart_ports[] = {
+		front_rt1.port, front_rt2.port, back_rt1.port, back_rt2.port,
+		front_lft1.port, front_lft2.port, back_lft1.port, back_lft2.port,
+		lift_front_lft.port, lift_front_rt.port, intake_lft.port, intake_rt.port,
+		imu, dist_sensor, camera};
+	constexpr char adi_ports[] = {front_claw_piston, back_tilter, back_claw_piston};
+
+	static_assert(smart_ports_in_range(smart_ports), "SKAR_2: smart port outside 1-21");
+	static_assert(smart_ports_unique(smart_ports), "SKAR_2: two devices on one smart port");
+	static_assert(adi_ports_in_range(adi_ports), "SKAR_2: ADI port outside A-H");
+	static_assert(adi_ports_unique(adi_ports), "SKAR_2: two devices on one ADI port");
+}
 
 
 float FRONT_LIFT_GEAR_RATIO = 7.0/1.0;
@@ -23,10 +79,25 @@ double FRONT_LIFT_PLAT = 90.0/360.0*FRONT_LIFT_GEAR_RATIO;
 double FRONT_LIFT_DOWN = 1.0/360.0*FRONT_LIFT_GEAR_RATIO;
 double FRONT_LIFT_MOVE = 10.0/360.0*FRONT_LIFT_GEAR_RATIO;
 double FRONT_LIFT_INIT = 0/360.0*FRONT_LIFT_GEAR_RATIO;
+double LIFT_TOLERANCE = 5.0/360.0*FRONT_LIFT_GEAR_RATIO;
 
 bool FRONT_CLAW_GRAB = false;
 bool FRONT_CLAW_RELEASE = true;
 
+// Goal rush: ms from command until the claw has closed, and the reading that means the goal is in
+uint32_t RUSH_CLAW_LEAD = 100;
+int RUSH_CONTACT_MM = 35;
+
+// Driver recordings: Y in driver control starts and stops one, auton 4 replays the newest
+bool REPLAY_CORRECTION = true; // steer back onto the recorded drive encoder positions
+
+// IMU turns; double tap X in driver control, off the field, to measure kS/kV/kA
+TurnGains turn_gains;
+
+// Paths in skills; 0.75 m/s is the 105 rpm the chassis moves at
+PursuitGains path_gains;
+double PATH_VELOCITY = 0.75;
+
 bool BACK_TILTER_DOWN = true;
 bool BACK_TILTER_UP = false;
 
@@ -53,6 +124,14 @@ std::shared_ptr<okapi::MotorGroup> back_lft;
 std::shared_ptr<okapi::MotorGroup> drive_lft;
 std::shared_ptr<okapi::MotorGroup> drive_rt;
 
+// opcontrol writes through these so unchanged commands never reach the ports
+std::shared_ptr<CachedMotors> front_rt_cmd;
+std::shared_ptr<CachedMotors> back_rt_cmd;
+std::shared_ptr<CachedMotors> front_lft_cmd;
+std::shared_ptr<CachedMotors> back_lft_cmd;
+std::shared_ptr<CachedMotors> drive_lft_cmd;
+std::shared_ptr<CachedMotors> drive_rt_cmd;
+
 okapi::IterativePosPIDController::Gains ks;
 std::shared_ptr<okapi::ChassisController> chassis;
 
@@ -64,16 +143,49 @@ std::shared_ptr<okapi::AsyncPositionController<double, double>> lift_front_contr
 std::shared_ptr<okapi::Motor> intake_lft;
 std::shared_ptr<okapi::Motor> intake_rt;
 std::shared_ptr<okapi::MotorGroup> intake;
+std::shared_ptr<CachedMotors> intake_cmd;
 
 std::shared_ptr<pros::ADIDigitalOut> front_claw_piston;
 std::shared_ptr<pros::ADIDigitalOut> back_tilter;
 std::shared_ptr<pros::ADIDigitalOut> back_claw_piston;
 
 // std::shared_ptr<GoalCamera> camera;
+// std::shared_ptr<GoalTracker> goals;
  
 std::shared_ptr<pros::Imu> imu;
+std::shared_ptr<ImuCalibration> imu_calibration;
+std::atomic<uint32_t> initialized_at{0}; // pros::millis() when initialize() returned
 
 std::shared_ptr<pros::Distance> dist_sensor;
 
+std::shared_ptr<SensorHub> sensors;
+
+// field pose from the drive encoders and the IMU
+std::shared_ptr<Odometry> odometry;
+
+// every trajectory auton can follow, by id
+std::shared_ptr<TrajectoryStore> trajectories;
+// trajectory files on the SD card that replace a built in one, by id, opened while disabled
+std::map<uint16_t, std::shared_ptr<TrajectoryStream>> sd_trajectories;
+
 std::shared_ptr<pros::Controller> master;
-std::shared_ptr<pros::Controller> partner;
\ No newline at end of file
+std::shared_ptr<pros::Controller> partner;
+
+// everything printed to the master screen goes through here
+std::shared_ptr<ControllerDisplay> display;
+
+// 100 Hz log of every motor and sensor to the SD card
+std::shared_ptr<Telemetry> telemetry;
+std::shared_ptr<TelemetrySampler> telemetry_sampler;
+
+// driver control recordings on the SD card
+std::shared_ptr<InputRecorder> recorder;
+
+// work done while disabled before the match, and what it made
+std::shared_ptr<Precompute> precompute;
+std::shared_ptr<ActionGraph> skills_graph;
+std::shared_ptr<InputPlayer> replay_player;
+std::shared_ptr<GoalApproach> rush_approach;
+
+// the graph autonomous is running, so whatever mode comes next can stop its steps
+std::shared_ptr<ActionGraph> running_graph;
@@ -0,0 +1,249 @@
+// Generated by sim/tools/trajectory_gen from paths/SKAR_2.txt; edit that and run make -C sim paths
+#ifndef SKAR_2_PATHS_HPP
+#define SKAR_2_PATHS_HPP
+
+#include "trajectory.hpp"
+
+namespace paths
+{
+
+	constexpr float ring_sweep_x[] = {
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f, 0.271780014f,
+		0.271780014f, 0.271780014f, 0.271780014f, 0.271777034f, 0.271743596f, 0.271642804f, 0.271441817f, 0.271112144f,
+		0.270629644f, 0.26997453f, 0.269131035f, 0.268087178f, 0.266834438f, 0.265367389f, 0.263683259f, 0.261781573f,
+		0.259663641f, 0.257332325f, 0.254791588f, 0.252046287f, 0.249101803f, 0.245963931f, 0.242638648f, 0.239131942f,
+		0.235449776f, 0.23159799f, 0.227582157f, 0.223407641f, 0.219079554f, 0.214602664f, 0.209981486f, 0.205220237f,
+		0.200322822f, 0.195292905f, 0.19013387f, 0.18484889f, 0.179440871f, 0.173912555f, 0.16826652f, 0.162505209f,
+		0.156630903f, 0.150645882f, 0.144552305f, 0.138352409f, 0.132048413f, 0.125642642f, 0.119137585f, 0.112535886f,
+		0.105840467f, 0.0990545377f, 0.09218169f, 0.0852259323f, 0.0781917349f, 0.0710840598f, 0.0639083982f, 0.0566707365f,
+		0.0493775345f, 0.0420356207f, 0.0346520767f, 0.0272340644f, 0.0197886154f, 0.0123223793f, 0.00484137191f, -0.00264926814f,
+		-0.0101454714f, -0.0176443495f, -0.0251441654f, -0.0326441564f, -0.0401441567f, -0.047644157f, -0.0551441573f, -0.0626441613f,
+		-0.0701441616f, -0.0776441544f, -0.0851441547f, -0.092644155f, -0.100144155f, -0.107644156f, -0.115144156f, -0.122644156f,
+		-0.130144164f, -0.137644157f, -0.145144165f, -0.152644157f, -0.16014415f, -0.167644158f, -0.175144151f, -0.182644159f,
+		-0.190144151f, -0.197644159f, -0.205144152f, -0.212644145f, -0.220144153f, -0.227644145f, -0.235144153f, -0.242644146f,
+		-0.250144154f, -0.257644147f, -0.26514414f, -0.272644132f, -0.280144125f, -0.287644118f, -0.295144141f, -0.302644134f,
+		-0.310144126f, -0.317644119f, -0.325144112f, -0.332644105f, -0.340144098f, -0.347644091f, -0.355144083f, -0.362644076f,
+		-0.370144069f, -0.377644062f, -0.385144055f, -0.392644048f, -0.400144041f, -0.407644004f, -0.415143996f, -0.422643989f,
+		-0.430143982f, -0.437643975f, -0.445143968f, -0.452643931f, -0.460143924f, -0.467643917f, -0.47514388f, -0.482643872f,
+		-0.490143865f, -0.497643828f, -0.505143821f, -0.512643814f, -0.520143807f, -0.52764374f, -0.535143733f, -0.542643726f,
+		-0.550143659f, -0.557643652f, -0.565143645f, -0.572643638f, -0.580143571f, -0.587643564f, -0.595143557f, -0.60264349f,
+		-0.610143483f, -0.617643476f, -0.625143409f, -0.632643402f, -0.640143335f, -0.647643328f, -0.655143321f, -0.662643254f,
+		-0.670143247f, -0.67764318f, -0.685143173f, -0.692643106f, -0.700143099f, -0.707643032f, -0.715143025f, -0.722642958f,
+		-0.730142951f, -0.737642944f, -0.745142877f, -0.75264287f, -0.760142803f, -0.767642796f, -0.775142729f, -0.782642722f,
+		-0.790142655f, -0.797642648f, -0.805142581f, -0.812642574f, -0.820142508f, -0.8276425f, -0.835142434f, -0.842642426f,
+		-0.85014236f, -0.857642353f, -0.865142286f, -0.872642279f, -0.880142212f, -0.887642205f, -0.895142138f, -0.902642131f,
+		-0.910142064f, -0.917642057f, -0.92514205f, -0.932641983f, -0.940141976f, -0.947641909f, -0.955141902f, -0.962641895f,
+		-0.970141828f, -0.977641821f, -0.985141754f, -0.992641747f, -1.00014174f, -1.00764167f, -1.01514173f, -1.02264166f,
+		-1.03014159f, -1.03764164f, -1.04514158f, -1.05264151f, -1.06014156f, -1.0676415f, -1.07514143f, -1.08264148f,
+		-1.09014142f, -1.09764147f, -1.1051414f, -1.11264133f, -1.12014139f, -1.12764132f, -1.13514137f, -1.14264131f,
+		-1.15014136f, -1.15764129f, -1.16514134f, -1.17264128f, -1.18014121f, -1.18764126f, -1.1951412f, -1.20264125f,
+		-1.21014118f, -1.21764123f, -1.22514117f, -1.23264122f, -1.24014115f, -1.24764121f, -1.25514114f, -1.26264119f,
+		-1.27014112f, -1.27764118f, -1.28514111f, -1.29264116f, -1.30014122f, -1.30764115f, -1.3151412f, -1.32264113f,
+		-1.33014119f, -1.33764112f, -1.34514117f, -1.35264111f, -1.36014116f, -1.3676405f, -1.37505233f, -1.38231409f,
+		-1.38942587f, -1.3963877f, -1.40319943f, -1.40986121f, -1.41637301f, -1.42273474f, -1.4289465f, -1.43500829f,
+		-1.44092011f, -1.44668186f, -1.45229363f, -1.45775545f, -1.46306717f, -1.46822894f, -1.47324073f, -1.47810256f,
+		-1.48281431f, -1.48737609f, -1.49178791f, -1.49604964f, -1.50016141f, -1.50412321f, -1.50793493f, -1.5115968f,
+		-1.51510859f, -1.51847029f, -1.52168214f, -1.52474391f, -1.5276556f, -1.53041744f, -1.5330292f, -1.53549099f,
+		-1.53780282f, -1.53996456f, -1.54197633f, -1.54383814f, -1.54554987f, -1.54711163f, -1.54852343f, -1.54978526f,
+		-1.550897f, -1.55185878f, -1.55267048f, -1.55333233f, -1.55384409f, -1.55420589f, -1.55441761f, -1.55447996f,
+	};
+	constexpr float ring_sweep_y[] = {
+		2.83209991f, 2.83202505f, 2.83179998f, 2.83142495f, 2.83089995f, 2.83022499f, 2.82940006f, 2.82842493f,
+		2.82730007f, 2.82602501f, 2.82459998f, 2.82302499f, 2.82130003f, 2.81942511f, 2.81739998f, 2.81522489f,
+		2.81290007f, 2.81042504f, 2.80780005f, 2.8050251f, 2.80209994f, 2.79902506f, 2.79579997f, 2.79242492f,
+		2.7888999f, 2.78522491f, 2.78139997f, 2.77742505f, 2.77329993f, 2.76902509f, 2.76460004f, 2.76002502f,
+		2.75530005f, 2.7504251f, 2.74539995f, 2.74022508f, 2.7349f, 2.72942495f, 2.72379994f, 2.71802497f,
+		2.71210003f, 2.70602489f, 2.69980001f, 2.69342494f, 2.6868999f, 2.6802249f, 2.67339993f, 2.66642499f,
+		2.65930009f, 2.65202498f, 2.64459991f, 2.63709998f, 2.62960005f, 2.62210011f, 2.61459994f, 2.60710001f,
+		2.59960008f, 2.59209991f, 2.58459997f, 2.57710004f, 2.56960011f, 2.56209993f, 2.5546f, 2.54710007f,
+		2.5395999f, 2.53209996f, 2.52460003f, 2.5171001f, 2.50959992f, 2.50209999f, 2.49460006f, 2.48709989f,
+		2.47959995f, 2.47210002f, 2.46460009f, 2.45709991f, 2.44959998f, 2.44210005f, 2.43460011f, 2.42709994f,
+		2.41960001f, 2.41210008f, 2.40459991f, 2.39709997f, 2.38960004f, 2.38210011f, 2.37459993f, 2.3671f,
+		2.35960007f, 2.3520999f, 2.34459996f, 2.33710003f, 2.3296001f, 2.32209992f, 2.31459999f, 2.30710006f,
+		2.29959989f, 2.29209995f, 2.28460002f, 2.27710009f, 2.26959991f, 2.26209998f, 2.25460005f, 2.24710011f,
+		2.23959994f, 2.23210001f, 2.22460008f, 2.21709991f, 2.20959997f, 2.20210004f, 2.19460011f, 2.18709993f,
+		2.1796f, 2.17210007f, 2.1645999f, 2.15709996f, 2.14960003f, 2.1421001f, 2.13459992f, 2.12709999f,
+		2.11960006f, 2.11209989f, 2.10459995f, 2.09710002f, 2.08960009f, 2.08209991f, 2.07459998f, 2.06710005f,
+		2.05960011f, 2.05209994f, 2.04460001f, 2.03710008f, 2.02959991f, 2.02209997f, 2.01460004f, 2.00710011f,
+		1.99960005f, 1.9921f, 1.98459995f, 1.97710001f, 1.96959996f, 1.96210003f, 1.95459998f, 1.94710004f,
+		1.93959999f, 1.93210006f, 1.92460001f, 1.91709995f, 1.90960014f, 1.9021008f, 1.89460361f, 1.88711095f,
+		1.87962663f, 1.87215543f, 1.8647033f, 1.85727656f, 1.84988213f, 1.84252727f, 1.83521914f, 1.82796454f,
+		1.82077003f, 1.81364191f, 1.80658567f, 1.79960644f, 1.79270887f, 1.78589714f, 1.7791748f, 1.77254534f,
+		1.76601171f, 1.75957668f, 1.75324261f, 1.74701202f, 1.74088705f, 1.73487008f, 1.72896302f, 1.72316849f,
+		1.71748841f, 1.71192539f, 1.70648181f, 1.70116055f, 1.69596434f, 1.69089627f, 1.6859597f, 1.68115819f,
+		1.67649555f, 1.67197597f, 1.66760385f, 1.66338384f, 1.65932107f, 1.65542066f, 1.65168822f, 1.64812958f,
+		1.64475048f, 1.6415571f, 1.63855541f, 1.63575125f, 1.6331501f, 1.63075697f, 1.62857628f, 1.62661099f,
+		1.62486315f, 1.62333274f, 1.62201762f, 1.62091339f, 1.62001228f, 1.61930346f, 1.61877239f, 1.61840022f,
+		1.6181643f, 1.61803734f, 1.61798787f, 1.61798f, 1.61798f, 1.61798f, 1.61797988f, 1.61797976f,
+		1.61797965f, 1.61797941f, 1.61797905f, 1.61797857f, 1.61797798f, 1.61797726f, 1.61797631f, 1.61797523f,
+		1.61797404f, 1.61797261f, 1.61797094f, 1.61796904f, 1.61796701f, 1.61796463f, 1.61796212f, 1.61795926f,
+		1.61795616f, 1.61795282f, 1.61794913f, 1.61794531f, 1.61794102f, 1.61793649f, 1.61793172f, 1.6179266f,
+		1.61792111f, 1.61791527f, 1.61790919f, 1.61790276f, 1.61789596f, 1.61788881f, 1.61788142f, 1.61787355f,
+		1.61786544f, 1.61785686f, 1.61784804f, 1.61783874f, 1.6178292f, 1.61781931f, 1.61780906f, 1.61779833f,
+		1.61778736f, 1.61777604f, 1.61776435f, 1.61775231f, 1.6177398f, 1.61772704f, 1.61771393f, 1.61770046f,
+		1.61768675f, 1.61767256f, 1.61765802f, 1.61764324f, 1.6176281f, 1.6176126f, 1.61759686f, 1.61758065f,
+		1.61756432f, 1.61754751f, 1.61753047f, 1.61751306f, 1.61749542f, 1.61747754f, 1.6174593f, 1.61744082f,
+		1.61742198f, 1.61740303f, 1.61738372f, 1.61736417f, 1.61734438f, 1.61732423f, 1.61730397f, 1.61728346f,
+		1.61726284f, 1.61724186f, 1.61722076f, 1.61719942f, 1.61717796f, 1.61715627f, 1.61713433f, 1.6171124f,
+		1.61709011f, 1.61706781f, 1.6170454f, 1.61702275f, 1.6170001f, 1.61697721f, 1.61695433f, 1.61693132f,
+		1.61690819f, 1.61688495f, 1.6168617f, 1.61683846f, 1.61681509f, 1.61679161f, 1.61676824f, 1.61674476f,
+		1.61672127f, 1.61669779f, 1.6166743f, 1.61665094f, 1.61662745f, 1.61660409f, 1.61658072f, 1.61655736f,
+		1.61653411f, 1.61651099f, 1.61648786f, 1.61646485f, 1.61644185f, 1.61641908f, 1.61639631f, 1.61637378f,
+		1.61635137f, 1.61632895f, 1.61630678f, 1.61628485f, 1.61626291f, 1.61624122f, 1.61621976f, 1.61619842f,
+		1.61617732f, 1.61615646f, 1.61613572f, 1.61611521f, 1.61609495f, 1.61607492f, 1.61605513f, 1.61603558f,
+		1.61601627f, 1.61599731f, 1.61597848f, 1.61596f, 1.61594176f, 1.61592388f, 1.61590624f, 1.61588883f,
+		1.61587179f, 1.6158551f, 1.61583865f, 1.61582255f, 1.61580682f, 1.61579132f, 1.61577618f, 1.6157614f,
+		1.61574686f, 1.61573279f, 1.61571896f, 1.61570549f, 1.61569238f, 1.61567962f, 1.61566722f, 1.61565518f,
+		1.6156435f, 1.61563218f, 1.61562121f, 1.6156106f, 1.61560035f, 1.61559045f, 1.6155808f, 1.61557162f,
+		1.6155628f, 1.61555433f, 1.61554611f, 1.61553836f, 1.61553085f, 1.61552382f, 1.61551702f, 1.61551058f,
+		1.6155045f, 1.61549866f, 1.6154933f, 1.61548817f, 1.61548328f, 1.61547875f, 1.61547458f, 1.61547089f,
+		1.61546743f, 1.61546421f, 1.61546135f, 1.61545885f, 1.61545646f, 1.61545444f, 1.61545253f, 1.61545086f,
+		1.61544943f, 1.61544812f, 1.61544693f, 1.61544597f, 1.61544502f, 1.61544418f, 1.61544359f, 1.61544299f,
+		1.61544251f, 1.61544204f, 1.61544168f, 1.61544132f, 1.61544108f, 1.61544085f, 1.61544073f, 1.61544049f,
+		1.61544037f, 1.61544037f, 1.61544025f, 1.61544013f, 1.61544013f, 1.61544013f, 1.61544001f, 1.61544001f,
+		1.61544001f, 1.61544001f, 1.61544001f, 1.61544001f, 1.61544001f, 1.61544001f, 1.61544001f, 1.61544001f,
+		1.61544001f, 1.61544001f, 1.61544001f, 1.61544001f, 1.61544001f, 1.61544001f, 1.61544001f, 1.61544001f,
+	};
+	constexpr float ring_sweep_heading[] = {
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f, -1.57079637f,
+		-1.57079637f, -1.57079637f, -1.57079637f, -1.57236183f, -1.57896566f, -1.59023452f, -1.60559797f, -1.62447906f,
+		-1.64631319f, -1.67056286f, -1.69672775f, -1.72435284f, -1.75303304f, -1.78241575f, -1.81220031f, -1.84213746f,
+		-1.87202513f, -1.90170455f, -1.93105555f, -1.95999146f, -1.98845422f, -2.0164094f, -2.04384232f, -2.07075381f,
+		-2.09715796f, -2.12307763f, -2.14854431f, -2.17359495f, -2.1982708f, -2.22261643f, -2.24667835f, -2.27050519f,
+		-2.29414678f, -2.31765318f, -2.34107542f, -2.36446452f, -2.38787174f, -2.41134834f, -2.43494487f, -2.45871258f,
+		-2.48270059f, -2.50695825f, -2.53153253f, -2.55646896f, -2.58181f, -2.60759354f, -2.63385296f, -2.66061401f,
+		-2.68789339f, -2.71569657f, -2.74401331f, -2.77281547f, -2.80205274f, -2.83164668f, -2.8614881f, -2.89142966f,
+		-2.92128253f, -2.95081162f, -2.97973156f, -3.00770545f, -3.03434277f, -3.05920291f, -3.08179855f, -3.1016016f,
+		-3.11805439f, -3.13058186f, -3.13860917f, -3.14158559f, -3.14159155f, -3.14158821f, -3.14158225f, -3.14157438f,
+		-3.14156437f, -3.14155197f, -3.1415379f, -3.14152169f, -3.14150357f, -3.14148378f, -3.14146209f, -3.14143872f,
+		-3.14141369f, -3.14138722f, -3.14135933f, -3.14132977f, -3.14129901f, -3.14126682f, -3.14123344f, -3.14119887f,
+		-3.14116311f, -3.14112639f, -3.14108849f, -3.14104962f, -3.14101005f, -3.14096928f, -3.14092803f, -3.14088583f,
+		-3.14084291f, -3.14079952f, -3.14075541f, -3.14071083f, -3.14066577f, -3.14062023f, -3.14057422f, -3.14052796f,
+		-3.14048123f, -3.14043427f, -3.1403873f, -3.14034009f, -3.14029264f, -3.1402452f, -3.14019775f, -3.14015007f,
+		-3.14010262f, -3.14005518f, -3.14000797f, -3.139961f, -3.13991404f, -3.13986754f, -3.13982105f, -3.13977504f,
+		-3.13972926f, -3.13968396f, -3.13963914f, -3.13959455f, -3.13955069f, -3.13950706f, -3.13946414f, -3.13942194f,
+		-3.13938022f, -3.13933921f, -3.13929868f, -3.13925886f, -3.13922f, -3.13918161f, -3.13914418f, -3.13910747f,
+		-3.13907146f, -3.13903642f, -3.13900232f, -3.13896894f, -3.13893652f, -3.13890505f, -3.13887453f, -3.13884497f,
+		-3.1388166f, -3.13878894f, -3.13876247f, -3.13873696f, -3.13871241f, -3.13868904f, -3.13866687f, -3.13864565f,
+		-3.13862562f, -3.13860655f, -3.13858867f, -3.13857198f, -3.13855648f, -3.13854218f, -3.13852882f, -3.1385169f,
+		-3.13850617f, -3.1384964f, -3.13848805f, -3.13848066f, -3.1384747f, -3.1384697f, -3.13846612f, -3.13846374f,
+		-3.13846254f, -3.13846254f, -3.13846374f, -3.13846636f, -3.13846993f, -3.13847494f, -3.1384809f, -3.13848829f,
+		-3.13849664f, -3.13850641f, -3.13851738f, -3.1385293f, -3.13854265f, -3.1385572f, -3.13857269f, -3.13858938f,
+		-3.13860726f, -3.13862634f, -3.13864636f, -3.13866758f, -3.13868999f, -3.13871336f, -3.13873792f, -3.13876343f,
+		-3.13878989f, -3.13881755f, -3.13884616f, -3.13887572f, -3.13890624f, -3.13893771f, -3.13897014f, -3.13900352f,
+		-3.13903785f, -3.1390729f, -3.1391089f, -3.13914561f, -3.13918304f, -3.13922143f, -3.13926053f, -3.13930011f,
+		-3.13934064f, -3.13938165f, -3.13942361f, -3.13946581f, -3.13950872f, -3.13955235f, -3.13959622f, -3.13964081f,
+		-3.13968563f, -3.13973093f, -3.13977671f, -3.13982272f, -3.13986921f, -3.13991594f, -3.13996267f, -3.14000988f,
+		-3.14005709f, -3.14010453f, -3.14015198f, -3.14019942f, -3.14024687f, -3.14029431f, -3.14034176f, -3.14038897f,
+		-3.14043617f, -3.1404829f, -3.14052963f, -3.14057589f, -3.1406219f, -3.14066744f, -3.1407125f, -3.14075708f,
+		-3.14080119f, -3.14084458f, -3.1408875f, -3.1409297f, -3.14097095f, -3.14101148f, -3.14105082f, -3.14108825f,
+		-3.14112425f, -3.14115834f, -3.14119101f, -3.141222f, -3.14125156f, -3.14127946f, -3.14130569f, -3.14133048f,
+		-3.14135385f, -3.14137554f, -3.14139605f, -3.14141512f, -3.141433f, -3.14144945f, -3.14146471f, -3.14147878f,
+		-3.14149165f, -3.14150357f, -3.14151454f, -3.14152431f, -3.14153337f, -3.14154124f, -3.14154863f, -3.14155507f,
+		-3.14156079f, -3.1415658f, -3.14157033f, -3.14157414f, -3.14157772f, -3.14158058f, -3.14158297f, -3.14158511f,
+		-3.14158678f, -3.14158821f, -3.1415894f, -3.14159012f, -3.14159083f, -3.14159155f, -3.14159179f, -3.14159226f,
+		-3.14159226f, -3.1415925f, -3.1415925f, -3.14159274f, -3.14159274f, -3.14159274f, -3.14159274f, 3.14159274f,
+	};
+	constexpr float ring_sweep_velocity[] = {
+		0.0f, 0.0149999997f, 0.0299999993f, 0.0450000018f, 0.0599999987f, 0.075000003f, 0.0900000036f, 0.104999997f,
+		0.119999997f, 0.135000005f, 0.150000006f, 0.165000007f, 0.180000007f, 0.194999993f, 0.209999993f, 0.224999994f,
+		0.239999995f, 0.254999995f, 0.270000011f, 0.284999996f, 0.300000012f, 0.314999998f, 0.330000013f, 0.344999999f,
+		0.360000014f, 0.375f, 0.389999986f, 0.405000001f, 0.419999987f, 0.435000002f, 0.449999988f, 0.465000004f,
+		0.479999989f, 0.495000005f, 0.50999999f, 0.524999976f, 0.540000021f, 0.555000007f, 0.569999993f, 0.584999979f,
+		0.600000024f, 0.61500001f, 0.629999995f, 0.644999981f, 0.660000026f, 0.675000012f, 0.689999998f, 0.704999983f,
+		0.720000029f, 0.735000014f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.75f,
+		0.75f, 0.75f, 0.75f, 0.75f, 0.75f, 0.748677731f, 0.733677745f, 0.718677759f,
+		0.703677714f, 0.688677728f, 0.673677742f, 0.658677757f, 0.643677771f, 0.628677726f, 0.61367774f, 0.598677754f,
+		0.583677769f, 0.568677723f, 0.553677738f, 0.538677752f, 0.523677766f, 0.508677721f, 0.493677735f, 0.47867775f,
+		0.463677734f, 0.448677748f, 0.433677733f, 0.418677747f, 0.403677732f, 0.388677746f, 0.373677731f, 0.358677745f,
+		0.343677729f, 0.328677744f, 0.313677728f, 0.298677742f, 0.283677727f, 0.268677741f, 0.253677756f, 0.23867774f,
+		0.22367774f, 0.208677739f, 0.193677738f, 0.178677738f, 0.163677737f, 0.148677737f, 0.133677736f, 0.118677743f,
+		0.103677742f, 0.0886777416f, 0.073677741f, 0.0586777404f, 0.0436777435f, 0.0286777411f, 0.0136777414f, 0.0f,
+	};
+	constexpr PackedTrajectory ring_sweep{"ring_sweep", 0.01f, 440, ring_sweep_x, ring_sweep_y, ring_sweep_heading, ring_sweep_velocity};
+
+	enum Id : uint16_t {
+		ring_sweep_id,
+	};
+
+	constexpr PackedTrajectory all[] = {
+		ring_sweep,
+	};
+}
+
+#endif
@@ -37,14 +37,14 @@ void initialize()
 	ks.kD = 0;
 	ks.kBias = 0;
 
-	front_rt1.reset(new okapi::Motor(1, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	front_rt2.reset(new okapi::Motor(2, false, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	back_rt1.reset(new okapi::Motor(3, false, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	back_rt2.reset(new okapi::Motor(4, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	front_lft1.reset(new okapi::Motor(5, false, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	front_lft2.reset(new okapi::Motor(6, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	back_lft1.reset(new okapi::Motor(7, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
-	back_lft2.reset(new okapi::Motor(8, false, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations));
+	front_rt1 = make_motor<wiring::front_rt1>();
+	front_rt2 = make_motor<wiring::front_rt2>();
+	back_rt1 = make_motor<wiring::back_rt1>();
+	back_rt2 = make_motor<wiring::back_rt2>();
+	front_lft1 = make_motor<wiring::front_lft1>();
+	front_lft2 = make_motor<wiring::front_lft2>();
+	back_lft1 = make_motor<wiring::back_lft1>();
+	back_lft2 = make_motor<wiring::back_lft2>();
 
 	front_rt.reset(new okapi::MotorGroup({front_rt1, front_rt2}));
 	front_lft.reset(new okapi::MotorGroup({front_lft1, front_lft2}));
@@ -57,11 +57,11 @@ void initialize()
 	chassis = okapi::ChassisControllerBuilder()
 				  .withMotors(drive_lft, drive_rt)
 				  // Green gearset, 4 in wheel diam, 11.5 in wheel track
-				  .withDimensions(okapi::AbstractMotor::gearset::green, {{3.25_in, 14.5_in}, okapi::imev5GreenTPR})
+				  .withDimensions({wiring::drive.gearset, wiring::drive.ratio}, {{wiring::drive.wheel_diameter, wiring::drive.wheel_track}, wiring::drive.tpr})
 				  .withGains(ks, ks)
 				  .build();
 	// IMU
-	imu.reset(new pros::Imu(10));
+	imu = StaticDevice<pros::Imu, wiring::imu>::make(wiring::imu);
 
 	master.reset(new pros::Controller(pros::E_CONTROLLER_MASTER));
 }
@@ -149,6 +149,7 @@ void opcontrol()
 {
 
 	int move_volt = 11000;
+	FixedRateLoop loop(20);
 	while (true)
 	{
 		double y = master->get_analog(ANALOG_LEFT_Y);
@@ -156,6 +157,8 @@ void opcontrol()
 		double z = -master->get_analog(ANALOG_RIGHT_X);
 		drive_lft->moveVoltage((y + x - z) / 127 * move_volt);
 		drive_rt->moveVoltage((y - x + z) / 127 * move_volt);
+		loop.next();
+		loop.report_every(500, "driver control");
 	}
 }
 
@@ -2,6 +2,39 @@
 #include "okapi/api.hpp"
 #include <vector>
 
+#ifndef HARDWARE_CPP
+#define HARDWARE_CPP
+#include "hardware.cpp"
+#endif
+
+// Every port on the robot; the build fails if two devices share one
+namespace wiring
+{
+	using okapi::AbstractMotor;
+	using namespace okapi::literals;
+
+	constexpr MotorSpec front_rt1{1, true, AbstractMotor::gearset::green};
+	constexpr MotorSpec front_rt2{2, false, AbstractMotor::gearset::green};
+	constexpr MotorSpec back_rt1{3, false, AbstractMotor::gearset::green};
+	constexpr MotorSpec back_rt2{4, true, AbstractMotor::gearset::green};
+	constexpr MotorSpec front_lft1{5, false, AbstractMotor::gearset::green};
+	constexpr MotorSpec front_lft2{6, true, AbstractMotor::gearset::green};
+	constexpr MotorSpec back_lft1{7, true, AbstractMotor::gearset::green};
+	constexpr MotorSpec back_lft2{8, false, AbstractMotor::gearset::green};
+
+	constexpr uint8_t imu = 10;
+
+	constexpr DriveSpec drive{AbstractMotor::gearset::green, 1.0, 3.25_in, 14.5_in, okapi::imev5GreenTPR};
+
+	constexpr uint8_t smart_ports[] = {
+		front_rt1.port, front_rt2.port, back_rt1.port, back_rt2.port,
+		front_lft1.port, front_lft2.port, back_lft1.port, back_lft2.port,
+		imu};
+
+	static_assert(smart_ports_in_range(smart_ports), "SKAR_3: smart port outside 1-21");
+	static_assert(smart_ports_unique(smart_ports), "SKAR_3: two devices on one smart port");
+}
+
 okapi::IterativePosPIDController::Gains ks; 
 
 std::shared_ptr<okapi::Motor> front_rt1;
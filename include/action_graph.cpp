@@ -0,0 +1,188 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+    Autonomous routine as a graph of steps instead of a straight line.
+
+    A step starts as soon as every step it comes after has finished, so
+    mechanisms that don't depend on each other move at the same time instead
+    of waiting out fixed delays. Each step has a start action, which must not
+    block, and a completion condition polled every few ms; blocking helpers
+    like imu_turning run on their own task through task().
+
+    After run() the graph knows when each step started and finished, and
+    report() prints the critical path: the chain of steps that actually
+    decided how long the routine took.
+
+    PROS deletes the autonomous task when the period ends, but not the
+    tasks its steps started, which would go on driving into driver control.
+    The graph keeps their handles; cancel() deletes whichever are still
+    running and calls on_cancel, e.g. to stop the drive. Call it once the
+    task that ran run() is gone, from opcontrol() and disabled().
+*/
+class ActionGraph {
+    public:
+    typedef std::function<void()> Action;
+    typedef std::function<bool(uint32_t)> Condition; // ms since the step started
+
+    std::function<void(int)> on_start; // called with each step's id as it starts, e.g. for telemetry
+    std::function<void()> on_cancel;   // called by cancel() after the step tasks are deleted
+
+    static Condition elapsed(uint32_t ms) {
+        return [ms](uint32_t t) { return t >= ms; };
+    }
+
+    static Condition at_once() {
+        return [](uint32_t) { return true; };
+    }
+
+    int add(const char *name, std::vector<int> after, Action start, Condition done, Action finish = nullptr) {
+        Step step;
+        step.name = name;
+        step.after = after;
+        step.start = start;
+        step.done = done;
+        step.finish = finish;
+        steps.push_back(step);
+        return steps.size() - 1;
+    }
+
+    // A blocking body run on its own task; the step is done when it returns
+    int task(const char *name, std::vector<int> after, Action body) {
+        std::shared_ptr<std::atomic<bool>> returned(new std::atomic<bool>(false));
+        return add(name, after,
+                   [this, body, returned, name] {
+                       StepTask running;
+                       running.task.reset(new pros::Task([body, returned] { body(); returned->store(true); }, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name));
+                       running.returned = returned;
+                       tasks.push_back(running);
+                   },
+                   [returned](uint32_t) { return returned->load(); });
+    }
+
+    // Deletes the step tasks still running; returns how many there were
+    int cancel() {
+        int deleted = 0;
+        for (StepTask &running : tasks) {
+            // a task that has set returned is about to end by itself, and may already have
+            if (!running.returned->load()) {
+                running.task->remove();
+                running.returned->store(true);
+                deleted++;
+            }
+        }
+        tasks.clear();
+        if (on_cancel) {
+            on_cancel();
+        }
+        return deleted;
+    }
+
+    int wait(const char *name, std::vector<int> after, uint32_t ms) {
+        return add(name, after, [] {}, elapsed(ms));
+    }
+
+    // Runs every step and returns the total time in ms
+    uint32_t run(uint32_t poll = 5) {
+        started_at = pros::millis();
+        size_t finished = 0;
+        uint32_t now = started_at;
+        while (finished < steps.size()) {
+            for (size_t i = 0; i < steps.size(); i++) {
+                Step &s = steps[i];
+                if (s.state == WAITING && ready(s)) {
+                    s.state = RUNNING;
+                    s.started = pros::millis();
+                    if (on_start) {
+                        on_start(i);
+                    }
+                    s.start();
+                }
+                if (s.state == RUNNING && s.done(pros::millis() - s.started)) {
+                    s.state = FINISHED;
+                    s.finished = pros::millis();
+                    if (s.finish) {
+                        s.finish();
+                    }
+                    finished++;
+                }
+            }
+            if (finished < steps.size()) {
+                pros::Task::delay_until(&now, poll);
+            }
+        }
+        total = pros::millis() - started_at;
+        return total;
+    }
+
+    void report() {
+        if (steps.empty()) {
+            return;
+        }
+        // walk back from the last step to finish through whichever
+        // prerequisite finished last, i.e. the one that held each step up
+        std::vector<int> path;
+        int at = 0;
+        for (size_t i = 1; i < steps.size(); i++) {
+            if (steps[i].finished > steps[at].finished) {
+                at = i;
+            }
+        }
+        while (at >= 0) {
+            path.push_back(at);
+            int gate = -1;
+            for (int dep : steps[at].after) {
+                if (gate < 0 || steps[dep].finished > steps[gate].finished) {
+                    gate = dep;
+                }
+            }
+            at = gate;
+        }
+
+        printf("auton: %u ms, %u steps, critical path:\n", total, (unsigned) steps.size());
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            const Step &s = steps[*it];
+            printf("  %6u +%5u  #%-3d %s\n", s.started - started_at, s.finished - s.started, *it, s.name.c_str());
+        }
+    }
+
+    private:
+    enum State { WAITING, RUNNING, FINISHED };
+
+    struct Step {
+        std::string name;
+        std::vector<int> after;
+        Action start;
+        Condition done;
+        Action finish;
+        State state = WAITING;
+        uint32_t started = 0;
+        uint32_t finished = 0;
+    };
+
+    struct StepTask {
+        std::shared_ptr<pros::Task> task;
+        std::shared_ptr<std::atomic<bool>> returned;
+    };
+
+    std::vector<Step> steps;
+    std::vector<StepTask> tasks; // started by task() steps, in start order
+    uint32_t started_at = 0;
+    uint32_t total = 0;
+
+    bool ready(const Step &s) const {
+        for (int dep : s.after) {
+            if (steps[dep].state != FINISHED) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
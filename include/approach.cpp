@@ -0,0 +1,165 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+#ifndef SENSORS_CPP
+#define SENSORS_CPP
+#include "sensors.cpp"
+#endif
+
+#include <string>
+
+/*
+    Drives into a goal and fires the claw early enough that it lands when
+    the goal reaches the claw instead of a few frames after.
+
+    The distance sensor only has a new reading about every 33 ms and each one
+    is already old when we get it, so instead of waiting for a raw reading
+    under the contact distance it runs an alpha-beta filter on the readings
+    for distance and closing speed. Readings the sensor has little confidence
+    in are dropped, repeats of the last reading only advance the prediction,
+    and the sensor's own object velocity is blended into the closing speed.
+
+    From that it predicts the time to contact, and the claw fires once the
+    time left is no more than how long the claw takes to close. The
+    prediction assumes the closing speed holds, so the robot has to keep
+    driving until contact: the brake fires at the predicted contact, not
+    ahead of it. Braking any earlier slows the robot, the goal arrives late,
+    and the claw is shut before it gets there or the robot stops short. A
+    raw reading under the contact distance always fires both, like the old
+    loop did.
+
+    A reading that first comes in under the contact distance dates contact
+    by interpolating from the reading before and taking off the sensor lag.
+    After the goal is in, log() prints how long it took from the claw
+    trigger to that contact, which is the number to tune the lead against.
+*/
+class GoalApproach {
+    public:
+    double contact_mm = 35;       // a reading this close means the goal is in the claw
+    uint32_t claw_lead = 100;     // ms from claw command until it has closed
+    uint32_t sensor_lag = 20;     // ms a reading trails the robot
+    int32_t min_confidence = 20;  // 0-63, only meaningful past 200 mm
+    double alpha = 0.5;
+    double beta = 0.2;
+    double velocity_weight = 0.3; // share of the sensor's object velocity in the closing speed
+
+    GoalApproach(double contact_mm_ = 35, uint32_t claw_lead_ = 100) {
+        contact_mm = contact_mm_;
+        claw_lead = claw_lead_;
+    }
+
+    void update(const SensorSnapshot &s) {
+        update(s.time, s.distance, s.distance_confidence, s.distance_velocity);
+    }
+
+    // mm and confidence as from pros::Distance, velocity in m/s toward the sensor
+    void update(uint32_t time, int32_t mm, int32_t confidence, double velocity) {
+        now = time;
+        if (mm > 0 && mm <= contact_mm && !contacted) {
+            contacted = true;
+            double crossed = time;
+            if (tracking && last_mm > contact_mm && measured_at < time) {
+                crossed = measured_at + (last_mm - contact_mm) / (last_mm - mm) * (time - measured_at);
+            }
+            contact_at = crossed - sensor_lag;
+        }
+        if (mm <= 0 || (mm > 200 && confidence < min_confidence) || mm == last_mm) {
+            return;
+        }
+        last_mm = mm;
+
+        if (!tracking) {
+            distance = mm;
+            closing = velocity > 0 ? velocity : 0;
+            measured_at = time;
+            tracking = true;
+            return;
+        }
+
+        double dt = time - measured_at;
+        if (dt <= 0) {
+            return;
+        }
+        double predicted = distance - closing * dt;
+        double residual = mm - predicted;
+        distance = predicted + alpha * residual;
+        closing -= beta * residual / dt;
+        if (confidence >= min_confidence && velocity > 0) {
+            closing += velocity_weight * (velocity - closing); // m/s is mm/ms
+        }
+        measured_at = time;
+    }
+
+    // Predicted ms until contact, -1 while there is no estimate or nothing is closing in
+    double time_to_contact() const {
+        if (!tracking || closing <= 0) {
+            return -1;
+        }
+        double ahead = distance - closing * ((now - measured_at) + sensor_lag) - contact_mm;
+        return ahead > 0 ? ahead / closing : 0;
+    }
+
+    // True once it is time to close the claw; latches
+    bool fire_claw() {
+        if (claw_at == 0 && due(claw_lead)) {
+            claw_at = now;
+            claw_predicted = time_to_contact();
+        }
+        return claw_at != 0;
+    }
+
+    // True once the goal is predicted or measured to be in; latches
+    bool fire_brake() {
+        if (brake_at == 0 && due(0)) {
+            brake_at = now;
+        }
+        return brake_at != 0;
+    }
+
+    bool in_contact() const {
+        return contacted;
+    }
+
+    void log() const {
+        if (claw_at == 0) {
+            printf("approach: claw never fired\n");
+            return;
+        }
+        printf("approach: claw fired at %u ms with a %u ms lead, predicted %.0f ms, contact %s\n", claw_at, claw_lead,
+               claw_predicted, lead_text(claw_at).c_str());
+    }
+
+    private:
+    bool tracking = false;
+    double distance = 0; // mm at measured_at
+    double closing = 0;  // mm/ms
+    int32_t last_mm = -1;
+    uint32_t measured_at = 0;
+    uint32_t now = 0;
+
+    uint32_t claw_at = 0;
+    uint32_t brake_at = 0;
+    bool contacted = false;
+    double contact_at = 0; // ms, when the goal got there rather than when a reading said so
+    double claw_predicted = -1;
+
+    bool due(uint32_t lead) const {
+        if (contacted) {
+            return true;
+        }
+        double ttc = time_to_contact();
+        return ttc >= 0 && ttc <= lead;
+    }
+
+    std::string lead_text(uint32_t fired) const {
+        char text[32];
+        if (fired == 0 || !contacted) {
+            snprintf(text, sizeof(text), "never");
+        }
+        else {
+            snprintf(text, sizeof(text), "%.0f ms later", contact_at - fired);
+        }
+        return text;
+    }
+};
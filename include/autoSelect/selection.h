@@ -5,7 +5,7 @@
 //selector configuration
 #define HUE 360
 #define DEFAULT 0 // 2 is for the right side and 1 is for the left side
-#define AUTONS "Left", "Right RightYellow", "Right CenterYellow"
+#define AUTONS "Left", "Right RightYellow", "Right CenterYellow", "Replay"
 
 namespace selector{
 
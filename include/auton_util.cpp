@@ -10,146 +10,293 @@
 #define VISION_CPP
 #include "vision.cpp"
 #endif
+#ifndef SENSORS_CPP
+#define SENSORS_CPP
+#include "sensors.cpp"
+#endif
+#ifndef LOOP_TIMER_CPP
+#define LOOP_TIMER_CPP
+#include "loop_timer.cpp"
+#endif
+#ifndef CONTROLLER_INPUT_CPP
+#define CONTROLLER_INPUT_CPP
+#include "controller_input.cpp"
+#endif
+#ifndef CONTROLLER_DISPLAY_CPP
+#define CONTROLLER_DISPLAY_CPP
+#include "controller_display.cpp"
+#endif
+#ifndef MOTION_CPP
+#define MOTION_CPP
+#include "motion.cpp"
+#endif
+#ifndef APPROACH_CPP
+#define APPROACH_CPP
+#include "approach.cpp"
+#endif
+#ifndef TURN_PROFILE_CPP
+#define TURN_PROFILE_CPP
+#include "turn_profile.cpp"
+#endif
+#ifndef ACTION_GRAPH_CPP
+#define ACTION_GRAPH_CPP
+#include "action_graph.cpp"
+#endif
+#ifndef TELEMETRY_CPP
+#define TELEMETRY_CPP
+#include "telemetry.cpp"
+#endif
+#ifndef INPUT_REPLAY_CPP
+#define INPUT_REPLAY_CPP
+#include "input_replay.cpp"
+#endif
+#ifndef ODOMETRY_CPP
+#define ODOMETRY_CPP
+#include "odometry.cpp"
+#endif
+#ifndef PURE_PURSUIT_CPP
+#define PURE_PURSUIT_CPP
+#include "pure_pursuit.cpp"
+#endif
+#ifndef RAMSETE_CPP
+#define RAMSETE_CPP
+#include "ramsete.cpp"
+#endif
+#ifndef PRECOMPUTE_CPP
+#define PRECOMPUTE_CPP
+#include "precompute.cpp"
+#endif
 
 
-class PID_Controller {
-    public:
-    double kp = 0;
-    double ki = 0;
-    double kd = 0;
-    double dt = 0;
-    double sum = 0;
-    double last_err = 0;
-
-    PID_Controller(double kp_, double ki_, double kd_, double dt_) {
-        kp = kp_;
-        ki = ki_;
-        kd = kd_;
-        dt = dt_;
-    }
-
-    void reset(double err) {
-        sum = 0;
-        last_err = err;
-    }
-
-    double update(double err) {
-        sum = sum + err*dt;
-        double output = kp*err + ki*sum + kd*(err-last_err)/dt;
-        last_err = err;
-        return output;
-    }
-};
-
-void turn_to_goal(std::shared_ptr<GoalCamera> camera,
+// Aims at the tracked goal of a color, steering on its filtered position and velocity
+void turn_to_goal(std::shared_ptr<GoalTracker> tracker,
                   std::shared_ptr<okapi::MotorGroup> lft,
                   std::shared_ptr<okapi::MotorGroup> rt,
                   goal_color c)
 {
-    double x, y;
-    std::tie(x, y) = camera->get_by_sig(c);
-
     int err_thresh = 20;
-    int fov_angle = 60;
     int settled_time = 0;
-    int dt = 10;
-    int settled_thresh = 0;
-    int total_time = 0;
+    int settled_thresh = 150;
+    uint32_t dt = tracker->get_period();
+    uint32_t total_time = 0;
     double kp = 9000;
     double ki = 50;
+    double kd = 600;
 
-    while (total_time < 2000 && (abs(x) > err_thresh || settled_thresh <= 150))
+    uint32_t now = pros::millis();
+    while (total_time < 2000 && settled_time <= settled_thresh)
     {
-        std::tie(x, y) = camera->get_by_sig(c);
-        double v_prop = x / VISION_FOV_WIDTH * 2;
-        double sign = 1;
-        if (v_prop < 0)
+        const VisionFrame frame = tracker->latest();
+        const TrackedGoal *goal = frame.best(c);
+        if (goal == nullptr)
         {
-            sign = -1;
-        }
-        lft->moveVoltage(-kp * v_prop - ki * dt * sign);
-        rt->moveVoltage(kp * v_prop + ki * dt * sign);
-
-        if (abs(x) < err_thresh)
-        {
-            settled_time += dt;
+            // lost it; hold still rather than chase noise
+            lft->moveVoltage(0);
+            rt->moveVoltage(0);
+            settled_time = 0;
         }
         else
         {
-            settled_time = 0;
+            double v_prop = goal->x / VISION_FOV_WIDTH * 2;
+            double rate_prop = goal->vx / VISION_FOV_WIDTH * 2;
+            double sign = 1;
+            if (v_prop < 0)
+            {
+                sign = -1;
+            }
+            double output = kp * v_prop + kd * rate_prop + ki * dt * sign;
+            lft->moveVoltage(-output);
+            rt->moveVoltage(output);
+
+            if (abs(goal->x) < err_thresh)
+            {
+                settled_time += dt;
+            }
+            else
+            {
+                settled_time = 0;
+            }
         }
-        pros::delay(dt);
+        pros::Task::delay_until(&now, dt);
         total_time += dt;
     }
     lft->moveVoltage(0);
     rt->moveVoltage(0);
 }
 
-void balance(std::shared_ptr<okapi::ChassisController> chassis, std::shared_ptr<pros::Imu> imu, std::shared_ptr<pros::Controller> master)
-{
-    master->print(1, 1, "roll: %f", imu->get_pitch());
-    double orig_velocity = chassis->getMaxVelocity();
-    chassis->setMaxVelocity(70);
-    double original_pitch = imu->get_pitch();
-    chassis->moveDistanceAsync(3.2_ft);
+/*
+    Gains for balance(). Speeds are drive rpm; pitch is degrees from where the
+    robot started, taken positive the way it tilts while climbing on.
+*/
+struct BalanceGains {
+    double climb_speed = 120;  // rpm until the robot is on the ramp
+    double on_ramp = 15;       // deg of pitch that means it is climbing
+    double kP = 8;             // rpm per deg of pitch
+    double kD = 1;             // rpm per deg/s of pitch rate
+    double max_speed = 100;    // rpm once on the ramp
+    double tip_rate = 20;      // deg/s toward level that means the platform is tipping
+    double level = 2.5;        // deg
+    double level_rate = 5;     // deg/s
+    uint32_t settle = 250;     // ms within level before it counts as balanced
+};
+
+/*
+    Drives onto the platform and balances it, closing the loop on pitch and
+    pitch rate every sensor frame.
 
-    double pitch_change_thresh = 21;
+    Until the pitch passes on_ramp it just climbs. After that the speed is
+    kP * pitch + kD * pitch rate, so it slows as the platform starts to come
+    down and backs up if it went too far; while the platform is swinging
+    toward level faster than tip_rate it stops and lets it. Within level the
+    drive holds position, and hold_ms after it first counted as balanced it
+    returns with the drive still in hold. Prints the time it took to balance.
+    Waits up to the timeout for the IMU to finish calibrating before it starts.
 
-    while (abs(imu->get_pitch() - original_pitch) < pitch_change_thresh)
-    {   
-        master->print(1, 1, "pitch: %d vs %d", (int) imu->get_pitch(), (int) original_pitch);
-        pros::delay(30);
+    Which way gyro y turns with pitch depends on how the IMU is mounted, and
+    a wrong sign would flip the D term and the tip check. So while climbing
+    it compares gyro y with how the pitch actually changes frame to frame,
+    and takes the sign from that once it is on the ramp. Without enough
+    climb to tell, the pitch rate comes from those frame to frame changes.
+*/
+motion_exit balance(std::shared_ptr<okapi::MotorGroup> drive_lft, std::shared_ptr<okapi::MotorGroup> drive_rt, std::shared_ptr<SensorHub> sensors, std::shared_ptr<ControllerDisplay> display, uint32_t hold_ms = 0, const ExitPolicy &exit = ExitPolicy::within(10000), const BalanceGains &gains = BalanceGains())
+{
+    if (!sensors->wait_for_imu(exit.timeout)) {
+        return EXIT_TIMEOUT;
     }
-    chassis->stop();
-    chassis->setMaxVelocity(40);
-    chassis->moveDistanceAsync(31_in);
-    pros::delay(500);
-    original_pitch = imu->get_pitch();
-    pitch_change_thresh = 4;
+    drive_lft->setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
+    drive_rt->setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
+    double flat = sensors->latest().pitch;
+    double dir = 0; // 0 until on the ramp
+    uint32_t start = pros::millis();
+    uint32_t now = start;
+    uint32_t level_since = 0;
+    uint32_t balanced_at = 0;
+    motion_exit result = EXIT_SETTLED;
+    SensorSnapshot last = sensors->latest();
+    double sign_votes = 0; // sum of gyro y times pitch change on the climb
+    double rate_sign = 0;  // gyro y into the pitch sense, 0 until known
 
-    while (abs(imu->get_pitch() - original_pitch) < pitch_change_thresh)
-    {
-        // if(chassis->isSettled()) {
-        //     chassis->moveDistanceAsync(1_in);
-        // }
-        master->print(1, 1, "on_roll: %d vs %d", (int) imu->get_pitch(), (int) original_pitch);
-        pros::delay(30);
+    while (true) {
+        SensorSnapshot frame = sensors->latest();
+        if (exit.timeout > 0 && pros::millis() - start >= exit.timeout) {
+            result = EXIT_TIMEOUT;
+            break;
+        }
+        if (exit.condition && exit.condition(frame)) {
+            result = EXIT_CONDITION;
+            break;
+        }
+        double pitch = frame.pitch - flat;
+        double rate = 0;
+        if (frame.time != last.time) {
+            double change = frame.pitch - last.pitch;
+            if (dir == 0) {
+                sign_votes += change * frame.gyro.y;
+            }
+            rate = change / ((frame.time - last.time) / 1000.0);
+            last = frame;
+        }
+        if (rate_sign != 0) {
+            rate = rate_sign * frame.gyro.y;
+        }
+
+        double speed = gains.climb_speed;
+        if (dir == 0 && abs(pitch) >= gains.on_ramp) {
+            dir = pitch > 0 ? 1 : -1;
+            rate_sign = sign_votes > 0 ? 1 : sign_votes < 0 ? -1 : 0;
+            printf("balance: on the ramp, gyro y sign %s\n", rate_sign > 0 ? "+" : rate_sign < 0 ? "-" : "unknown");
+        }
+        if (dir != 0) {
+            pitch *= dir;
+            rate *= dir;
+            speed = gains.kP * pitch + gains.kD * rate;
+            speed = std::max(-gains.max_speed, std::min(gains.max_speed, speed));
+            if (rate < -gains.tip_rate) {
+                speed = 0;
+            }
+
+            if (abs(pitch) < gains.level && abs(rate) < gains.level_rate) {
+                speed = 0;
+                if (level_since == 0) {
+                    level_since = frame.time;
+                }
+                if (balanced_at == 0 && frame.time - level_since >= gains.settle) {
+                    balanced_at = frame.time;
+                    printf("balance: level after %u ms\n", balanced_at - start);
+                    display->print(1, 0, "level: %u ms", balanced_at - start);
+                }
+            }
+            else {
+                level_since = 0;
+            }
+        }
+        if (balanced_at != 0 && exit.settle && frame.time - balanced_at >= hold_ms) {
+            break;
+        }
+
+        drive_lft->moveVelocity(speed);
+        drive_rt->moveVelocity(speed);
+        pros::Task::delay_until(&now, sensors->get_period());
     }
-    chassis->stop();
-    chassis->setMaxVelocity(orig_velocity);
+    drive_lft->moveVelocity(0);
+    drive_rt->moveVelocity(0);
+    if (balanced_at == 0) {
+        printf("balance: not level after %u ms, pitch %.1f\n", pros::millis() - start, sensors->latest().pitch - flat);
+    }
+    return result;
 }
 
-void imu_turning(double target, std::shared_ptr<okapi::MotorGroup> drive_lft, std::shared_ptr<okapi::MotorGroup> drive_rt, std::shared_ptr<pros::IMU> imu, std::shared_ptr<pros::Controller> master)
+/*
+	Turns to an absolute IMU rotation along a trapezoidal profile, with
+	feedforward from the gains and feedback on angle and gyro rate. Done as
+	soon as the profile has run out and both the angle and the rate are in
+	tolerance; gives up after 3 s by default so an IMU that can't reach the
+	target doesn't stall the routine. Waits up to the timeout for the IMU to
+	finish calibrating before it starts.
+*/
+motion_exit imu_turning(double target, std::shared_ptr<okapi::MotorGroup> drive_lft, std::shared_ptr<okapi::MotorGroup> drive_rt, std::shared_ptr<SensorHub> sensors, std::shared_ptr<ControllerDisplay> display, const ExitPolicy &exit = ExitPolicy::within(3000), const TurnGains &gains = TurnGains())
 {
-	double heading = imu->get_rotation(); // initial heading
-	double kp = 2.3;
-	double ki = 0;
-	double kd = .13;
-
-	double dt = 5;
-	double tol = 1.5;
-	PID_Controller controller = PID_Controller(kp, ki, kd, dt/1000);
-	double err = target-heading;
-	controller.reset(err);
-	double steady_time = 400;
-	double below_tol_time = 0;
-    while (abs(err) >= tol || below_tol_time < steady_time)
-    {	
-		heading = imu->get_rotation();
-		err = heading - target;
-		double output = controller.update(err);
-        output = output/abs(output)*std::min(abs(output), (double) 12000);
-		drive_lft->moveVelocity(-output);
-		drive_rt->moveVelocity(output);
-        master->print(1, 1, "pow: %d, rot: %d, ", (int) err, (int) output);
-		if(abs(err) < tol) {
-			below_tol_time = below_tol_time + dt;
+	if (!sensors->wait_for_imu(exit.timeout)) {
+		return EXIT_TIMEOUT;
+	}
+	double heading = sensors->latest().rotation; // initial heading
+	TrapezoidProfile profile(target - heading, gains.max_velocity, gains.max_acceleration);
+	motion_exit result = EXIT_SETTLED;
+	uint32_t start = pros::millis();
+	uint32_t now = start;
+	while (true)
+	{
+		SensorSnapshot frame = sensors->latest();
+		if (exit.timeout > 0 && pros::millis() - start >= exit.timeout) {
+			result = EXIT_TIMEOUT;
+			break;
 		}
-		else {
-			below_tol_time = 0;
+		if (exit.condition && exit.condition(frame)) {
+			result = EXIT_CONDITION;
+			break;
 		}
-		pros::delay(dt);
-    }
-    drive_lft->moveVelocity(0);
-    drive_rt->moveVelocity(0);
-}
\ No newline at end of file
+		double t = (pros::millis() - start) / 1000.0;
+		ProfilePoint want = profile.sample(t);
+		double rate = turn_rate(frame, gains);
+		double err = heading + want.position - frame.rotation;
+		if (exit.settle && t >= profile.duration() && abs(target - frame.rotation) < gains.tolerance && abs(rate) < gains.rate_tolerance) {
+			break;
+		}
+
+		double output = gains.kV * want.velocity + gains.kA * want.acceleration
+		              + gains.kP * err + gains.kD * (want.velocity - rate);
+		// kS also once the profile is done, or a small error never breaks static friction
+		double push = want.velocity != 0 ? want.velocity : (abs(err) > gains.tolerance / 2 ? err : 0);
+		if (push != 0) {
+			output += push > 0 ? gains.kS : -gains.kS;
+		}
+		output = std::max(-12000.0, std::min(12000.0, output));
+		drive_lft->moveVoltage(output);
+		drive_rt->moveVoltage(-output);
+		display->print(1, 1, "err: %d, out: %d", (int) (target - frame.rotation), (int) output);
+		pros::Task::delay_until(&now, sensors->get_period());
+	}
+	drive_lft->moveVoltage(0);
+	drive_rt->moveVoltage(0);
+	return result;
+}
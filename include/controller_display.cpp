@@ -0,0 +1,121 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+
+#include <atomic>
+#include <cstdarg>
+#include <cstring>
+
+/*
+    Controller screen output that never blocks the caller.
+
+    The controller only takes one screen update about every 50 ms, so print()
+    just formats into a per-line mailbox and returns. A low priority task sends
+    the newest text of one changed line per update, round robin. Text that was
+    overwritten before it could be sent is dropped, never queued.
+
+    Each line's mailbox is a small ring of slots. A writer takes a ticket,
+    fills slot ticket % SLOTS, then publishes the ticket. The slot sequence is
+    odd while it is being written; the sender skips the line until the next
+    round if a slot changed while it was copying.
+*/
+class ControllerDisplay {
+    public:
+    ControllerDisplay(std::shared_ptr<pros::Controller> controller_, uint32_t period_ = 50) {
+        controller = controller_;
+        period = period_;
+    }
+
+    void start() {
+        if (sender) {
+            return;
+        }
+        sender.reset(new pros::Task([this] { run(); }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Controller Display"));
+    }
+
+    void print(uint8_t line, uint8_t col, const char *fmt, ...) __attribute__((format(printf, 4, 5))) {
+        if (line >= LINES) {
+            return;
+        }
+        Mailbox &box = boxes[line];
+        uint32_t ticket = box.next.fetch_add(1) + 1;
+        Slot &slot = box.slots[ticket % SLOTS];
+
+        slot.seq.store(ticket * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(slot.text, sizeof(slot.text), fmt, args);
+        va_end(args);
+        slot.col = col;
+        slot.seq.store(ticket * 2 + 2, std::memory_order_release);
+
+        // publish, unless a later print on this line already has
+        uint32_t seen = box.latest.load(std::memory_order_relaxed);
+        while (seen < ticket && !box.latest.compare_exchange_weak(seen, ticket, std::memory_order_release)) {
+        }
+    }
+
+    private:
+    static const int LINES = 3;
+    static const int SLOTS = 4;
+    static const int WIDTH = 19;
+
+    struct Slot {
+        std::atomic<uint32_t> seq{0};
+        uint8_t col = 0;
+        char text[WIDTH + 1] = "";
+    };
+
+    struct Mailbox {
+        std::atomic<uint32_t> next{0};
+        std::atomic<uint32_t> latest{0};
+        Slot slots[SLOTS];
+        uint32_t sent = 0; // only touched by the sender
+    };
+
+    std::shared_ptr<pros::Controller> controller;
+    uint32_t period;
+    std::shared_ptr<pros::Task> sender;
+    Mailbox boxes[LINES];
+    int next_line = 0;
+
+    void run() {
+        uint32_t now = pros::millis();
+        while (true) {
+            send_one();
+            pros::Task::delay_until(&now, period);
+        }
+    }
+
+    void send_one() {
+        for (int i = 0; i < LINES; i++) {
+            int line = (next_line + i) % LINES;
+            Mailbox &box = boxes[line];
+            uint32_t ticket = box.latest.load(std::memory_order_acquire);
+            if (ticket == box.sent) {
+                continue;
+            }
+
+            Slot &slot = box.slots[ticket % SLOTS];
+            char text[WIDTH + 1];
+            uint8_t col = slot.col;
+            memcpy(text, slot.text, sizeof(text));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != ticket * 2 + 2) {
+                continue; // rewritten under us; a newer ticket is on its way
+            }
+
+            // pad so a shorter line clears what the last one left behind
+            if (col >= WIDTH) {
+                col = 0;
+            }
+            text[WIDTH - col] = '\0';
+            controller->print(line, col, "%-*s", WIDTH - col, text);
+            box.sent = ticket;
+            next_line = (line + 1) % LINES;
+            return;
+        }
+    }
+};
@@ -0,0 +1,145 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+
+// One frame of driver input, master and partner merged
+struct InputSnapshot {
+    uint32_t time = 0;
+    uint32_t held = 0;          // bit per button, see ControllerInput::bit
+    uint32_t pressed = 0;       // went down this frame
+    uint32_t released = 0;      // came up this frame
+    uint32_t double_tapped = 0; // pressed again within the double tap window
+    int32_t analog[4] = {0, 0, 0, 0}; // master sticks after the deadband
+};
+
+/*
+    Reads the buttons of both controllers once per frame into a bitmask and
+    derives edge events from the previous frame, so a toggle is a
+    pressed() check instead of a countdown timer. A button counts as held if
+    it is held on either controller; the sticks come from the master.
+
+    PROS has no bulk read, so a frame costs one call per button read, but
+    nothing else in the loop talks to the controllers. Pass each controller
+    the mask of the buttons the robot maps on it, made with buttons(), and
+    only those are read; the rest never show as held.
+*/
+class ControllerInput {
+    public:
+    int deadband = 5;
+    uint32_t double_tap_ms = 300;
+
+    ControllerInput(std::shared_ptr<pros::Controller> master_,
+                    std::shared_ptr<pros::Controller> partner_,
+                    uint32_t master_buttons_ = ALL_BUTTONS,
+                    uint32_t partner_buttons_ = ALL_BUTTONS,
+                    int deadband_ = 5,
+                    uint32_t double_tap_ms_ = 300) {
+        master = master_;
+        partner = partner_;
+        master_buttons = master_buttons_;
+        partner_buttons = partner_buttons_;
+        deadband = deadband_;
+        double_tap_ms = double_tap_ms_;
+    }
+
+    static uint32_t bit(pros::controller_digital_e_t button) {
+        return 1u << (button - pros::E_CONTROLLER_DIGITAL_L1);
+    }
+
+    static uint32_t buttons(std::initializer_list<pros::controller_digital_e_t> list) {
+        uint32_t mask = 0;
+        for (pros::controller_digital_e_t button : list) {
+            mask |= bit(button);
+        }
+        return mask;
+    }
+
+    const InputSnapshot &poll() {
+        int32_t analog[4] = {0, 0, 0, 0};
+        if (master) {
+            for (int ch = 0; ch < 4; ch++) {
+                int32_t value = master->get_analog((pros::controller_analog_e_t) ch);
+                analog[ch] = abs(value) <= deadband ? 0 : value;
+            }
+        }
+        return feed(pros::millis(), read_buttons(master, master_buttons) | read_buttons(partner, partner_buttons), analog);
+    }
+
+    // Takes a frame from somewhere other than the controllers, e.g. a recording
+    const InputSnapshot &feed(uint32_t time, uint32_t held, const int32_t analog[4]) {
+        InputSnapshot next;
+        next.time = time;
+        next.held = held;
+        next.pressed = next.held & ~frame.held;
+        next.released = ~next.held & frame.held;
+
+        for (int i = 0; i < BUTTONS; i++) {
+            if (!(next.pressed & (1u << i))) {
+                continue;
+            }
+            if (last_press[i] != 0 && next.time - last_press[i] <= double_tap_ms) {
+                next.double_tapped |= 1u << i;
+                last_press[i] = 0; // a third tap starts a new pair
+            }
+            else {
+                last_press[i] = next.time;
+            }
+        }
+
+        for (int ch = 0; ch < 4; ch++) {
+            next.analog[ch] = analog[ch];
+        }
+
+        frame = next;
+        return frame;
+    }
+
+    const InputSnapshot &latest() const {
+        return frame;
+    }
+
+    bool held(pros::controller_digital_e_t button) const {
+        return frame.held & bit(button);
+    }
+
+    bool pressed(pros::controller_digital_e_t button) const {
+        return frame.pressed & bit(button);
+    }
+
+    bool released(pros::controller_digital_e_t button) const {
+        return frame.released & bit(button);
+    }
+
+    bool double_tapped(pros::controller_digital_e_t button) const {
+        return frame.double_tapped & bit(button);
+    }
+
+    int32_t analog(pros::controller_analog_e_t channel) const {
+        return frame.analog[channel];
+    }
+
+    private:
+    static const int BUTTONS = pros::E_CONTROLLER_DIGITAL_A - pros::E_CONTROLLER_DIGITAL_L1 + 1;
+    static const uint32_t ALL_BUTTONS = (1u << BUTTONS) - 1;
+
+    std::shared_ptr<pros::Controller> master;
+    std::shared_ptr<pros::Controller> partner;
+    uint32_t master_buttons;
+    uint32_t partner_buttons;
+    InputSnapshot frame;
+    uint32_t last_press[BUTTONS] = {0};
+
+    static uint32_t read_buttons(const std::shared_ptr<pros::Controller> &controller, uint32_t wanted) {
+        uint32_t mask = 0;
+        if (!controller) {
+            return mask;
+        }
+        for (int i = 0; i < BUTTONS; i++) {
+            if ((wanted & (1u << i)) && controller->get_digital((pros::controller_digital_e_t) (pros::E_CONTROLLER_DIGITAL_L1 + i))) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+    }
+};
@@ -0,0 +1,122 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+#ifndef OKAPI_H
+#define OKAPI_H
+#include "okapi/api.hpp"
+#endif
+
+#include <new>
+#include <utility>
+
+/*
+    Robot wiring as constexpr data. Each SKAR_*.hpp describes its devices in
+    a wiring namespace, lists every smart port and ADI port it uses, and
+    static_asserts that none is out of range or used twice, so a wiring
+    mistake fails the build instead of fighting over a motor on the field.
+
+    Devices are built from that description into static storage.
+    StaticDevice<T, key> holds room for one T per wiring entry and constructs
+    it on the first make(), which has to be in initialize() or later because
+    device constructors talk to the kernel. make() returns a shared_ptr that
+    aliases the storage without owning it: there is no heap block behind it,
+    and copying it never touches a reference count. That is still the type
+    OkapiLib's builders and our own helpers take, so nothing downstream
+    changes.
+*/
+
+struct MotorSpec {
+    uint8_t port;             // smart port 1-21
+    bool reversed;
+    okapi::AbstractMotor::gearset gearset;
+};
+
+struct DriveSpec {
+    okapi::AbstractMotor::gearset gearset;
+    double ratio;             // motor:wheel, what okapi's chassis builder takes
+    okapi::QLength wheel_diameter;
+    okapi::QLength wheel_track;
+    double tpr;               // encoder ticks per wheel revolution
+
+    // Motor rpm that moves the wheels at 1 m/s
+    double rpm_per_mps() const {
+        return 60 / (M_PI * wheel_diameter.convert(okapi::meter)) * ratio;
+    }
+
+    // The gearset's top speed in rpm
+    double max_rpm() const {
+        return gearset == okapi::AbstractMotor::gearset::red ? 100 : gearset == okapi::AbstractMotor::gearset::blue ? 600 : 200;
+    }
+};
+
+template <size_t N>
+constexpr bool smart_ports_in_range(const uint8_t (&ports)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (ports[i] < 1 || ports[i] > 21) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <size_t N>
+constexpr bool smart_ports_unique(const uint8_t (&ports)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < i; j++) {
+            if (ports[i] == ports[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ADI ports are 'A'-'H', either case, as 0-7
+constexpr int adi_index(char port) {
+    return port >= 'a' ? port - 'a' : port - 'A';
+}
+
+template <size_t N>
+constexpr bool adi_ports_in_range(const char (&ports)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (adi_index(ports[i]) < 0 || adi_index(ports[i]) > 7) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <size_t N>
+constexpr bool adi_ports_unique(const char (&ports)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < i; j++) {
+            if (adi_index(ports[i]) == adi_index(ports[j])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename T, const auto &key>
+class StaticDevice {
+    public:
+    template <typename... Args>
+    static std::shared_ptr<T> make(Args &&...args) {
+        if (!built) {
+            new (storage) T(std::forward<Args>(args)...);
+            built = true;
+        }
+        return std::shared_ptr<T>(std::shared_ptr<T>(), reinterpret_cast<T *>(storage));
+    }
+
+    private:
+    alignas(T) static inline unsigned char storage[sizeof(T)];
+    static inline bool built = false;
+};
+
+template <const MotorSpec &spec>
+std::shared_ptr<okapi::Motor> make_motor(okapi::AbstractMotor::encoderUnits units = okapi::AbstractMotor::encoderUnits::rotations) {
+    return StaticDevice<okapi::Motor, spec>::make(spec.port, spec.reversed, spec.gearset, units);
+}
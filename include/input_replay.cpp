@@ -0,0 +1,514 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+#ifndef CONTROLLER_INPUT_CPP
+#define CONTROLLER_INPUT_CPP
+#include "controller_input.cpp"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+/*
+    Driver control recordings.
+
+    The driver loop hands InputRecorder every tick's controller state (held
+    buttons and the four sticks), a word packing its mechanism state, and the
+    drive encoders. Most ticks change little, so a tick only stores what
+    changed since the one before:
+
+        1nnnnnnn     n ticks (1-127) in a row where nothing changed
+        0xkaaaah     h held buttons changed, aaaa which sticks changed,
+                     k drive encoder keyframe, x an extra byte follows:
+                     bit 0 the tick wasn't one period long,
+                     bit 1 the mechanism word changed
+
+    followed by, in order, the held buttons xor the previous ones, each
+    changed stick's delta, the tick length in ms, the mechanism word xor the
+    previous one, and the left and right drive deltas since the last
+    keyframe in 1/10 degree. Numbers are LEB128 varints, the signed
+    ones zigzag encoded. A minute of driving takes a few KB, so the
+    recording stays in RAM and is written out when it stops. If it fills
+    max_bytes it keeps what it has and ignores later ticks, calling on_full
+    once, but still waits for stop() to write it: that is a blocking SD
+    card write, which belongs to whoever asked for it, not the driver loop.
+
+    Recordings go to <dir>/drv_NNN.bin, the first number not already used.
+*/
+
+#define REPLAY_MAGIC "SKDR"
+#define REPLAY_VERSION 1
+
+struct ReplayHeader {
+    char magic[4];            // REPLAY_MAGIC
+    uint16_t version;         // REPLAY_VERSION
+    uint16_t period;          // ms, the driver loop's tick
+    uint32_t ticks;
+    uint16_t keyframe;        // ticks between drive encoder keyframes
+    uint16_t reserved;
+};
+
+static_assert(sizeof(ReplayHeader) == 16, "replay header layout changed, bump REPLAY_VERSION");
+
+// Path of the newest <dir>/drv_NNN.bin; false if there are none
+bool latest_recording(const char *dir, char *path, size_t size) {
+    bool found = false;
+    char candidate[48];
+    for (int n = 0; n < 1000; n++) {
+        snprintf(candidate, sizeof(candidate), "%s/drv_%03d.bin", dir, n);
+        FILE *existing = fopen(candidate, "rb");
+        if (existing == NULL) {
+            break;
+        }
+        fclose(existing);
+        snprintf(path, size, "%s", candidate);
+        found = true;
+    }
+    return found;
+}
+
+class InputRecorder {
+    public:
+    std::function<void()> on_full; // runs on the recording task when the buffer fills
+
+    InputRecorder(const char *dir_ = "/usd", uint16_t period_ = 20, uint16_t keyframe_ = 5, size_t max_bytes_ = 64 * 1024) {
+        snprintf(dir, sizeof(dir), "%s", dir_);
+        period = period_;
+        keyframe = keyframe_;
+        max_bytes = max_bytes_;
+    }
+
+    bool recording() const {
+        return active;
+    }
+
+    void start() {
+        data.clear();
+        data.reserve(max_bytes);
+        last = InputSnapshot();
+        last_mechanism = 0;
+        idle = 0;
+        ticks = 0;
+        full = false;
+        active = true;
+    }
+
+    // Call once per driver tick, after the tick has acted on frame; positions in encoder degrees
+    void record(const InputSnapshot &frame, uint32_t mechanism, double left, double right) {
+        if (!active || full) {
+            return;
+        }
+        if (data.size() + MAX_TICK_BYTES > max_bytes) {
+            full = true; // keep what there is until stop()
+            end_idle();
+            if (on_full) {
+                on_full();
+            }
+            return;
+        }
+
+        int32_t left_tenths = lround(left * 10);
+        int32_t right_tenths = lround(right * 10);
+        if (ticks == 0) {
+            left_base = left_tenths;
+            right_base = right_tenths;
+            key_left = key_right = 0;
+        }
+        uint32_t length = ticks == 0 ? period : frame.time - last.time;
+
+        uint8_t flags = 0;
+        uint8_t extra = 0;
+        if (frame.held != last.held) {
+            flags |= HELD;
+        }
+        for (int ch = 0; ch < 4; ch++) {
+            if (frame.analog[ch] != last.analog[ch]) {
+                flags |= STICK << ch;
+            }
+        }
+        if (ticks % keyframe == 0) {
+            flags |= KEYFRAME;
+        }
+        if (length != period) {
+            extra |= LATE;
+        }
+        if (mechanism != last_mechanism) {
+            extra |= MECHANISM;
+        }
+        if (extra) {
+            flags |= EXTRA;
+        }
+
+        if (flags == 0) {
+            if (++idle == 127) {
+                end_idle();
+            }
+        }
+        else {
+            end_idle();
+            data.push_back(flags);
+            if (extra) {
+                data.push_back(extra);
+            }
+            if (flags & HELD) {
+                put_varint(frame.held ^ last.held);
+            }
+            for (int ch = 0; ch < 4; ch++) {
+                if (flags & (STICK << ch)) {
+                    put_signed(frame.analog[ch] - last.analog[ch]);
+                }
+            }
+            if (extra & LATE) {
+                put_varint(length);
+            }
+            if (extra & MECHANISM) {
+                put_varint(mechanism ^ last_mechanism);
+            }
+            if (flags & KEYFRAME) {
+                put_signed(left_tenths - left_base - key_left);
+                put_signed(right_tenths - right_base - key_right);
+                key_left = left_tenths - left_base;
+                key_right = right_tenths - right_base;
+            }
+        }
+
+        last = frame;
+        last_mechanism = mechanism;
+        ticks++;
+    }
+
+    // Writes the recording to the next free drv_NNN.bin; false if there is nowhere to write
+    bool stop() {
+        if (!active) {
+            return false;
+        }
+        active = false;
+        end_idle();
+
+        FILE *file = NULL;
+        for (int n = 0; n < 1000 && file == NULL; n++) {
+            snprintf(path, sizeof(path), "%s/drv_%03d.bin", dir, n);
+            FILE *existing = fopen(path, "rb");
+            if (existing != NULL) {
+                fclose(existing);
+                continue;
+            }
+            file = fopen(path, "wb");
+            if (file == NULL) {
+                return false;
+            }
+        }
+        if (file == NULL) {
+            return false;
+        }
+
+        ReplayHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, REPLAY_MAGIC, 4);
+        header.version = REPLAY_VERSION;
+        header.period = period;
+        header.ticks = ticks;
+        header.keyframe = keyframe;
+        fwrite(&header, sizeof(header), 1, file);
+        fwrite(data.data(), 1, data.size(), file);
+        fclose(file);
+        return true;
+    }
+
+    uint32_t get_ticks() const {
+        return ticks;
+    }
+
+    bool is_full() const {
+        return full;
+    }
+
+    size_t get_bytes() const {
+        return sizeof(ReplayHeader) + data.size();
+    }
+
+    const char *get_path() const {
+        return path;
+    }
+
+    // tick byte layout, see the top of this file
+    static const uint8_t HELD = 0x01;
+    static const uint8_t STICK = 0x02;
+    static const uint8_t KEYFRAME = 0x20;
+    static const uint8_t EXTRA = 0x40;
+    static const uint8_t IDLE = 0x80;
+    static const uint8_t LATE = 0x01;
+    static const uint8_t MECHANISM = 0x02;
+
+    private:
+    static const size_t MAX_TICK_BYTES = 2 + 5 + 4 * 5 + 5 + 5 + 2 * 5;
+
+    char dir[32];
+    char path[48] = "";
+    uint16_t period;
+    uint16_t keyframe;
+    size_t max_bytes;
+
+    bool active = false;
+    bool full = false;
+    std::vector<uint8_t> data;
+    InputSnapshot last;
+    uint32_t last_mechanism = 0;
+    int32_t left_base = 0;
+    int32_t right_base = 0;
+    int32_t key_left = 0;
+    int32_t key_right = 0;
+    uint8_t idle = 0;
+    uint32_t ticks = 0;
+
+    void end_idle() {
+        if (idle > 0) {
+            data.push_back(IDLE | idle);
+            idle = 0;
+        }
+    }
+
+    void put_varint(uint32_t value) {
+        while (value >= 0x80) {
+            data.push_back((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        data.push_back(value);
+    }
+
+    void put_signed(int32_t value) {
+        put_varint(((uint32_t) value << 1) ^ (uint32_t) (value >> 31));
+    }
+};
+
+/*
+    Plays a recording back into a ControllerInput, so the driver code that
+    made it runs again on the same input. Each tick is fed when it came in
+    the recording, counted from the first one; a late tick doesn't move the
+    ones after it, so the replay stays on the recorded timeline instead of
+    drifting behind it. The frames carry the recorded times too, which keeps
+    double taps and timers exactly as they were.
+
+    At each keyframe check() compares the drive encoders with the recording.
+    With correct set, the difference becomes a voltage the driver loop adds
+    to each side until the next keyframe, pulling the robot back onto the
+    recorded path when it slips or starts a little off.
+
+    log() prints the benchmark: how far each tick was from its recorded time,
+    how far the drive was from its recorded position, and how many ticks
+    ended with different mechanism state than when they were recorded.
+*/
+class InputPlayer {
+    public:
+    bool correct = false;
+    double correction_kP = 20; // mV per encoder degree behind the recording
+    double max_correction = 4000; // mV
+    double correction_deadband = 2; // deg; smaller errors leave the recorded commands alone
+
+    double left_correction = 0; // mV, add to the left side of the drive
+    double right_correction = 0;
+
+    InputPlayer(const char *path_) {
+        snprintf(path, sizeof(path), "%s", path_);
+    }
+
+    // Reads the whole recording; false if it is missing or not a recording
+    bool load() {
+        FILE *file = fopen(path, "rb");
+        if (file == NULL) {
+            return false;
+        }
+        bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+                  memcmp(header.magic, REPLAY_MAGIC, 4) == 0 &&
+                  header.version == REPLAY_VERSION &&
+                  header.period > 0 && header.keyframe > 0;
+        data.clear();
+        uint8_t chunk[256];
+        size_t got;
+        while (ok && (got = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            data.insert(data.end(), chunk, chunk + got);
+        }
+        fclose(file);
+        return ok;
+    }
+
+    // Waits for the next recorded tick and feeds it to input; false once the recording is over
+    bool next(ControllerInput &input) {
+        if (tick >= header.ticks || !decode()) {
+            return false;
+        }
+        if (tick == 0) {
+            wake = pros::millis();
+            start_us = pros::micros();
+            start_ms = wake;
+        }
+        else {
+            pros::Task::delay_until(&wake, length);
+        }
+        offset += tick == 0 ? 0 : length;
+
+        int64_t error_us = (int64_t) pros::micros() - (int64_t) (start_us + (uint64_t) offset * 1000);
+        uint32_t late_us = error_us > 0 ? error_us : -error_us;
+        total_error_us += late_us;
+        max_error_us = std::max(max_error_us, late_us);
+        if (late_us >= 1000) {
+            late_ticks++;
+        }
+
+        input.feed(start_ms + offset, held, analog);
+        tick++;
+        return true;
+    }
+
+    // ms between this tick and the one before it in the recording
+    uint32_t tick_length() const {
+        return length;
+    }
+
+    // Mechanism state the current tick ended with when it was recorded
+    uint32_t get_mechanism() const {
+        return mechanism;
+    }
+
+    // Call after the tick has run, with what it did; positions in encoder degrees
+    void check(uint32_t mechanism_, double left, double right) {
+        if (mechanism_ != mechanism) {
+            mismatches++;
+        }
+        if (tick == 1) {
+            left_base = left;
+            right_base = right;
+        }
+        if (!keyframe) {
+            return;
+        }
+        double left_error = key_left / 10.0 - (left - left_base);
+        double right_error = key_right / 10.0 - (right - right_base);
+        double error = std::max(fabs(left_error), fabs(right_error));
+        total_drive_error += error;
+        max_drive_error = std::max(max_drive_error, error);
+        keyframes++;
+        if (correct) {
+            left_correction = correction(left_error);
+            right_correction = correction(right_error);
+        }
+    }
+
+    void log() const {
+        printf("replay %s: %u of %u ticks, %u ms\n", path, tick, (unsigned) header.ticks, offset);
+        printf("  tick error mean %u us, max %u us, %u ticks late by 1 ms or more\n",
+               tick > 0 ? (uint32_t) (total_error_us / tick) : 0, max_error_us, late_ticks);
+        printf("  drive error mean %.1f deg, max %.1f deg over %u keyframes%s\n",
+               keyframes > 0 ? total_drive_error / keyframes : 0.0, max_drive_error, keyframes,
+               correct ? ", corrected" : "");
+        printf("  mechanism mismatches %u\n", mismatches);
+    }
+
+    private:
+    char path[48];
+    ReplayHeader header = {};
+    std::vector<uint8_t> data;
+    size_t pos = 0;
+    uint8_t idle = 0;
+    bool corrupt = false;
+
+    // the current tick
+    uint32_t tick = 0;
+    uint32_t length = 0;
+    uint32_t held = 0;
+    int32_t analog[4] = {0, 0, 0, 0};
+    uint32_t mechanism = 0;
+    bool keyframe = false;
+    int32_t key_left = 0; // 1/10 degrees since the first tick
+    int32_t key_right = 0;
+
+    uint32_t wake = 0;
+    uint32_t start_ms = 0;
+    uint64_t start_us = 0;
+    uint32_t offset = 0; // recorded ms since the first tick
+    double left_base = 0;
+    double right_base = 0;
+
+    uint64_t total_error_us = 0;
+    uint32_t max_error_us = 0;
+    uint32_t late_ticks = 0;
+    double total_drive_error = 0;
+    double max_drive_error = 0;
+    uint32_t keyframes = 0;
+    uint32_t mismatches = 0;
+
+    double correction(double error) const {
+        if (fabs(error) < correction_deadband) {
+            return 0;
+        }
+        return std::clamp(error * correction_kP, -max_correction, max_correction);
+    }
+
+    bool decode() {
+        length = header.period;
+        keyframe = false;
+        if (idle > 0) {
+            idle--;
+            return true;
+        }
+        if (pos >= data.size()) {
+            return false;
+        }
+        uint8_t flags = data[pos++];
+        if (flags & InputRecorder::IDLE) {
+            idle = (flags & ~InputRecorder::IDLE) - 1;
+            return true;
+        }
+        uint8_t extra = 0;
+        if ((flags & InputRecorder::EXTRA) && pos < data.size()) {
+            extra = data[pos++];
+        }
+        if (flags & InputRecorder::HELD) {
+            held ^= get_varint();
+        }
+        for (int ch = 0; ch < 4; ch++) {
+            if (flags & (InputRecorder::STICK << ch)) {
+                analog[ch] += get_signed();
+            }
+        }
+        if (extra & InputRecorder::LATE) {
+            length = get_varint();
+        }
+        if (extra & InputRecorder::MECHANISM) {
+            mechanism ^= get_varint();
+        }
+        if (flags & InputRecorder::KEYFRAME) {
+            key_left += get_signed();
+            key_right += get_signed();
+            keyframe = true;
+        }
+        return !corrupt;
+    }
+
+    uint32_t get_varint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (pos >= data.size()) {
+                corrupt = true;
+                return 0;
+            }
+            uint8_t b = data[pos++];
+            value |= (uint32_t) (b & 0x7F) << shift;
+            if (!(b & 0x80)) {
+                return value;
+            }
+        }
+        corrupt = true;
+        return 0;
+    }
+
+    int32_t get_signed() {
+        uint32_t value = get_varint();
+        return (int32_t) (value >> 1) ^ -(int32_t) (value & 1);
+    }
+};
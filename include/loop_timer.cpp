@@ -0,0 +1,76 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+
+/*
+    Runs a loop body at a fixed period. Call next() at the end of every
+    iteration; it sleeps until the next tick with pros::Task::delay_until, so
+    the period doesn't stretch by however long the body took, and returns the
+    milliseconds that actually passed since the previous tick started.
+
+    If the body runs past the next tick, that tick is counted as an overrun
+    and the schedule restarts from now instead of firing the missed ticks
+    back to back.
+
+    report_every() prints the counts to the terminal every so many ticks and
+    starts the worst cases over, so a slow stretch shows up in the log next
+    to whatever the robot was doing then.
+*/
+class FixedRateLoop {
+    public:
+    uint32_t period = 0;       // ms
+    uint32_t ticks = 0;
+    uint32_t overruns = 0;
+    uint32_t last_exec_us = 0; // time the body took last tick
+    uint32_t max_exec_us = 0;
+    uint32_t max_jitter_us = 0; // latest wake-up after a tick was due
+
+    FixedRateLoop(uint32_t period_) {
+        period = period_;
+        deadline = pros::millis();
+        tick_start_us = pros::micros();
+    }
+
+    uint32_t next() {
+        uint64_t now_us = pros::micros();
+        last_exec_us = now_us - tick_start_us;
+        max_exec_us = std::max(max_exec_us, last_exec_us);
+
+        uint32_t prev = deadline;
+        deadline += period;
+        if (pros::millis() > deadline) {
+            overruns++;
+            deadline = pros::millis();
+        }
+        else {
+            pros::Task::delay_until(&prev, period);
+        }
+
+        uint64_t woke_us = pros::micros();
+        uint64_t due_us = (uint64_t) deadline * 1000;
+        if (woke_us > due_us) {
+            max_jitter_us = std::max(max_jitter_us, (uint32_t) (woke_us - due_us));
+        }
+        uint32_t elapsed = (woke_us - tick_start_us + 500) / 1000;
+        tick_start_us = woke_us;
+        ticks++;
+        return elapsed;
+    }
+
+    // Call after next(); prints and resets the worst cases once every `every` ticks, and says if it did
+    bool report_every(uint32_t every, const char *name) {
+        if (every == 0 || ticks % every != 0) {
+            return false;
+        }
+        printf("%s: %u ticks of %u ms, %u overruns, body %u us (worst %u us), worst late wake-up %u us\n", name,
+               ticks, period, overruns, last_exec_us, max_exec_us, max_jitter_us);
+        max_exec_us = 0;
+        max_jitter_us = 0;
+        return true;
+    }
+
+    private:
+    uint32_t deadline;
+    uint64_t tick_start_us;
+};
@@ -0,0 +1,134 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+#ifndef OKAPI_H
+#define OKAPI_H
+#include "okapi/api.hpp"
+#endif
+#ifndef SENSORS_CPP
+#define SENSORS_CPP
+#include "sensors.cpp"
+#endif
+
+#include <functional>
+
+// Why a motion primitive returned
+enum motion_exit
+{
+    EXIT_SETTLED = 1,
+    EXIT_CONDITION = 2,
+    EXIT_TIMEOUT = 3
+};
+
+/*
+    When a motion is over: once the controller settles, once the hard
+    timeout runs out, or once a sensor predicate holds, whichever comes first.
+
+    ExitPolicy::within(1500).until([](const SensorSnapshot &s) { return s.distance < 35; })
+*/
+struct ExitPolicy {
+    uint32_t timeout = 0; // ms, 0 waits as long as it takes
+    bool settle = true;
+    std::function<bool(const SensorSnapshot &)> condition;
+
+    static ExitPolicy within(uint32_t ms) {
+        ExitPolicy p;
+        p.timeout = ms;
+        return p;
+    }
+
+    ExitPolicy &until(std::function<bool(const SensorSnapshot &)> condition_) {
+        condition = condition_;
+        return *this;
+    }
+
+    ExitPolicy &no_settle() {
+        settle = false;
+        return *this;
+    }
+};
+
+/*
+    A hard timeout for a move expected to take `seconds`: twice that plus a
+    second to get going and settle, so a move that stalls against a wall or
+    a goal gives up instead of holding the routine forever.
+*/
+inline uint32_t motion_timeout(double seconds) {
+    return (uint32_t) (2000 * std::abs(seconds)) + 1000;
+}
+
+/*
+    Blocks the calling task until the policy says the current chassis motion
+    is over, then stops the chassis.
+
+    The caller checks isSettled() and the predicate on every sensor frame
+    itself, so it returns within a frame of the exit condition and at the
+    timeout to the ms. Nothing else is left running: if the caller is
+    deleted mid-move, e.g. with the autonomous task, the wait goes with it.
+*/
+motion_exit wait_for_motion(std::shared_ptr<okapi::ChassisController> chassis, std::shared_ptr<SensorHub> sensors, const ExitPolicy &exit)
+{
+    uint32_t start = pros::millis();
+    uint32_t now = start;
+    motion_exit reason = EXIT_TIMEOUT;
+    while (true) {
+        if (exit.condition && exit.condition(sensors->latest())) {
+            reason = EXIT_CONDITION;
+            break;
+        }
+        if (exit.settle && chassis->isSettled()) {
+            reason = EXIT_SETTLED;
+            break;
+        }
+        uint32_t elapsed = pros::millis() - start;
+        if (exit.timeout > 0 && elapsed >= exit.timeout) {
+            break;
+        }
+        uint32_t period = sensors->get_period();
+        if (exit.timeout > 0) {
+            period = std::min(period, exit.timeout - elapsed);
+        }
+        pros::Task::delay_until(&now, period);
+    }
+    chassis->stop();
+    return reason;
+}
+
+motion_exit move_distance(std::shared_ptr<okapi::ChassisController> chassis, std::shared_ptr<SensorHub> sensors, okapi::QLength distance, const ExitPolicy &exit = ExitPolicy())
+{
+    chassis->moveDistanceAsync(distance);
+    return wait_for_motion(chassis, sensors, exit);
+}
+
+motion_exit turn_angle(std::shared_ptr<okapi::ChassisController> chassis, std::shared_ptr<SensorHub> sensors, okapi::QAngle angle, const ExitPolicy &exit = ExitPolicy())
+{
+    chassis->turnAngleAsync(angle);
+    return wait_for_motion(chassis, sensors, exit);
+}
+
+/*
+    Stops the drive on the brake whatever its brake mode, and puts the mode
+    back once the wheels have stopped or after 250 ms. A velocity 0 command
+    goes by the brake mode, so a follower that ends at speed would otherwise
+    coast well past its end point.
+*/
+void brake_stop(std::shared_ptr<okapi::MotorGroup> drive_lft, std::shared_ptr<okapi::MotorGroup> drive_rt, std::shared_ptr<SensorHub> sensors)
+{
+    okapi::AbstractMotor::brakeMode mode = drive_lft->getBrakeMode();
+    drive_lft->setBrakeMode(okapi::AbstractMotor::brakeMode::brake);
+    drive_rt->setBrakeMode(okapi::AbstractMotor::brakeMode::brake);
+    drive_lft->moveVelocity(0);
+    drive_rt->moveVelocity(0);
+    uint32_t start = pros::millis();
+    uint32_t now = start;
+    while (now - start < 250) {
+        SensorSnapshot frame = sensors->latest();
+        if (std::abs(frame.left_velocity) < 5 && std::abs(frame.right_velocity) < 5) {
+            break;
+        }
+        pros::Task::delay_until(&now, sensors->get_period());
+    }
+    drive_lft->setBrakeMode(mode);
+    drive_rt->setBrakeMode(mode);
+}
@@ -0,0 +1,106 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+#ifndef OKAPI_H
+#define OKAPI_H
+#include "okapi/api.hpp"
+#endif
+
+// What was last sent to a smart port
+struct MotorPortState {
+    enum Output { NONE, VOLTAGE, VELOCITY };
+
+    Output mode = NONE;
+    std::int16_t value = 0;
+    okapi::AbstractMotor::brakeMode brake = okapi::AbstractMotor::brakeMode::invalid;
+    uint32_t output_time = 0;
+    uint32_t brake_time = 0;
+};
+
+/*
+    Motor commands that only reach the smart port when they change.
+
+    The last voltage/velocity and brake mode sent to each port is kept in one
+    table, so groups that share motors (front_rt and drive_rt) still see each
+    other's writes. A port is rewritten anyway once refresh_ms has passed, in
+    case something outside the cache (okapi controllers, auton code) has
+    commanded it since. Call invalidate() after such code has run to force the
+    next command through. report() prints how many commands reached a port
+    and how many the cache kept back since the last report.
+*/
+class CachedMotors {
+    public:
+    inline static uint32_t writes = 0;
+    inline static uint32_t suppressed = 0;
+    inline static uint32_t refresh_ms = 500;
+
+    CachedMotors(std::initializer_list<std::shared_ptr<okapi::Motor>> motors_) : motors(motors_) {}
+
+    void moveVoltage(std::int16_t voltage) {
+        for (auto &m : motors) {
+            MotorPortState &p = ports[m->getPort()];
+            if (fresh(p.output_time) && p.mode == MotorPortState::VOLTAGE && p.value == voltage) {
+                suppressed++;
+                continue;
+            }
+            m->moveVoltage(voltage);
+            p.mode = MotorPortState::VOLTAGE;
+            p.value = voltage;
+            p.output_time = pros::millis();
+            writes++;
+        }
+    }
+
+    void moveVelocity(std::int16_t velocity) {
+        for (auto &m : motors) {
+            MotorPortState &p = ports[m->getPort()];
+            if (fresh(p.output_time) && p.mode == MotorPortState::VELOCITY && p.value == velocity) {
+                suppressed++;
+                continue;
+            }
+            m->moveVelocity(velocity);
+            p.mode = MotorPortState::VELOCITY;
+            p.value = velocity;
+            p.output_time = pros::millis();
+            writes++;
+        }
+    }
+
+    void setBrakeMode(okapi::AbstractMotor::brakeMode mode) {
+        for (auto &m : motors) {
+            MotorPortState &p = ports[m->getPort()];
+            if (fresh(p.brake_time) && p.brake == mode) {
+                suppressed++;
+                continue;
+            }
+            m->setBrakeMode(mode);
+            p.brake = mode;
+            p.brake_time = pros::millis();
+            writes++;
+        }
+    }
+
+    static void report(const char *name) {
+        uint32_t total = writes + suppressed;
+        printf("%s: %u motor commands, %u sent, %u suppressed (%.0f%%)\n", name, total, writes, suppressed,
+               total > 0 ? 100.0 * suppressed / total : 0.0);
+        writes = 0;
+        suppressed = 0;
+    }
+
+    static void invalidate() {
+        for (auto &p : ports) {
+            p = MotorPortState();
+        }
+    }
+
+    private:
+    inline static MotorPortState ports[22];
+
+    std::vector<std::shared_ptr<okapi::Motor>> motors;
+
+    static bool fresh(uint32_t written) {
+        return pros::millis() - written < refresh_ms;
+    }
+};
@@ -0,0 +1,188 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+#ifndef OKAPI_H
+#define OKAPI_H
+#include "okapi/api.hpp"
+#endif
+#ifndef SEQLOCK_CPP
+#define SEQLOCK_CPP
+#include "seqlock.cpp"
+#endif
+#ifndef SENSORS_CPP
+#define SENSORS_CPP
+#include "sensors.cpp"
+#endif
+#ifndef HARDWARE_CPP
+#define HARDWARE_CPP
+#include "hardware.cpp"
+#endif
+
+#include <atomic>
+#include <cmath>
+
+// One odometry step, published as a whole
+struct OdomFrame {
+    uint32_t time = 0;        // sensor frame it was worked out from, 0 until the first step
+    okapi::OdomState state;   // okapi's frame transformation: x forward from the start, y right, theta clockwise
+    double travelled = 0;     // m along the path, forward or back
+    double encoder_theta = 0; // deg, the heading the encoders alone give
+    bool imu_heading = false; // theta came from the IMU rather than the encoders
+};
+
+/*
+    Where the robot is on the field, from the drive encoders and the IMU.
+
+    A 100 Hz task takes the newest sensor frame and integrates the change in
+    each side's encoder along an arc, as okapi's TwoEncoderOdometry does: a
+    step that turns the robot by dθ moves it 2 sin(dθ/2) / dθ of the distance
+    the wheels rolled, along the heading halfway through the step. The
+    encoders are the raw counts, so the chassis taring its sensors at the
+    start of every move doesn't show up as motion.
+
+    The heading is the IMU's once it is calibrated, since scrub in turns
+    throws the difference between the sides off by far more than the IMU
+    drifts over a match; until then it is the encoders'. The encoder heading
+    keeps being integrated either way, and how far it has wandered from the
+    IMU says how much the wheels are slipping.
+
+    latest() hands out the newest OdomFrame through a Seqlock like
+    SensorHub's, so motion code reads the pose without waiting on the task.
+    set_state() puts the robot at a known pose, and log() prints where it
+    thinks the robot is and how far the encoder heading has wandered.
+*/
+class Odometry {
+    public:
+    Odometry(std::shared_ptr<SensorHub> sensors_, const DriveSpec &drive, uint32_t period_ = 10) {
+        sensors = sensors_;
+        // the chassis' own scale: moveDistance(d) drives d * tpr / (pi * diameter) * ratio counts
+        meters_per_count = M_PI * drive.wheel_diameter.convert(okapi::meter) / (drive.tpr * drive.ratio);
+        track = drive.wheel_track.convert(okapi::meter);
+        period = period_;
+    }
+
+    void start() {
+        if (integrator) {
+            return;
+        }
+        step();
+        integrator.reset(new pros::Task([this] { run(); }, TASK_PRIORITY_MAX - 3, TASK_STACK_DEPTH_DEFAULT, "Odometry"));
+    }
+
+    OdomFrame latest() const {
+        return frame.read();
+    }
+
+    okapi::OdomState get_state() const {
+        return latest().state;
+    }
+
+    // Puts the robot at state from the next step on, e.g. its starting tile
+    void set_state(const okapi::OdomState &state) {
+        lock.take();
+        x = state.x.convert(okapi::meter);
+        y = state.y.convert(okapi::meter);
+        theta = state.theta.convert(okapi::radian);
+        imu_offset = theta - rotation;
+        encoder_theta = theta;
+        publish();
+        lock.give();
+    }
+
+    void log() const {
+        OdomFrame f = latest();
+        printf("odometry: at %.3f, %.3f m, %.1f deg after %.2f m; encoder heading %+.1f deg off the IMU\n",
+               f.state.x.convert(okapi::meter), f.state.y.convert(okapi::meter), f.state.theta.convert(okapi::degree),
+               f.travelled, f.encoder_theta - f.state.theta.convert(okapi::degree));
+    }
+
+    private:
+    std::shared_ptr<SensorHub> sensors;
+    double meters_per_count;
+    double track;
+    uint32_t period;
+
+    std::shared_ptr<pros::Task> integrator;
+    pros::Mutex lock; // between the task and set_state(); readers go through the Seqlock
+    Seqlock<OdomFrame> frame;
+
+    uint32_t last_frame = 0;
+    int32_t last_left = 0;
+    int32_t last_right = 0;
+    double rotation = 0;   // rad, IMU rotation at the last step
+    double imu_offset = 0; // rad from IMU rotation to theta
+    bool imu_heading = false;
+    double x = 0;
+    double y = 0;
+    double theta = 0;
+    double encoder_theta = 0;
+    double travelled = 0;
+    uint32_t time = 0;
+
+    void run() {
+        uint32_t now = pros::millis();
+        while (true) {
+            pros::Task::delay_until(&now, period);
+            step();
+        }
+    }
+
+    void step() {
+        SensorSnapshot s = sensors->latest();
+        lock.take();
+        if (s.frame == last_frame) {
+            lock.give();
+            return;
+        }
+        double imu = s.rotation * M_PI / 180;
+        if (last_frame == 0) {
+            // nothing to integrate yet
+            rotation = imu;
+            imu_offset = theta - imu;
+        }
+        else {
+            double left = (s.left_counts - last_left) * meters_per_count;
+            double right = (s.right_counts - last_right) * meters_per_count;
+            double arc = (left + right) / 2;
+            double encoder_turn = (left - right) / track;
+
+            double turn = imu_heading ? imu - rotation : encoder_turn;
+            rotation = imu;
+
+            double chord = turn == 0 ? arc : 2 * std::sin(turn / 2) * arc / turn;
+            double mid = theta + turn / 2;
+            x += chord * std::cos(mid);
+            y += chord * std::sin(mid);
+            if (imu_heading) {
+                theta = imu + imu_offset;
+            }
+            else {
+                theta += turn;
+                if (s.imu_ready) {
+                    // carry on from the encoder heading rather than jump
+                    imu_offset = theta - imu;
+                    imu_heading = true;
+                }
+            }
+            encoder_theta += encoder_turn;
+            travelled += std::abs(arc);
+        }
+        last_frame = s.frame;
+        last_left = s.left_counts;
+        last_right = s.right_counts;
+        time = s.time;
+        publish();
+        lock.give();
+    }
+
+    void publish() {
+        OdomFrame next;
+        next.time = time;
+        next.state = {x * okapi::meter, y * okapi::meter, theta * okapi::radian};
+        next.travelled = travelled;
+        next.encoder_theta = encoder_theta * 180 / M_PI;
+        next.imu_heading = imu_heading;
+        frame.write(next);
+    }
+};
@@ -0,0 +1,141 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+    Work done while the robot sits disabled on the field, so autonomous
+    doesn't pay for it after the match starts.
+
+    add() queues an item; start() runs the queue in order on a task just
+    above idle priority, so it only gets the brain when every other task is
+    waiting. Whenever the queue is empty the task calls on_idle, which can
+    queue more, e.g. for a new auton selection. PROS deletes disabled() and
+    competition_initialize() wherever they are when the robot is enabled,
+    so all they should do is call start(); anything that might hold the
+    queue's lock runs on the service's own task.
+
+    stop() is for the first thing autonomous and opcontrol do. It tells the
+    running item to give up, waits for it to return, drops whatever hasn't
+    started and prints which items finished. An item that runs for a while
+    should check cancelled() between pieces of work and return false if it
+    is set, and only publish its result once it has all of it, so a cut
+    short item leaves nothing half built behind. Whatever it was making is
+    then done the usual way at the start of the period.
+
+    The queue only runs once: after stop(), add() and start() do nothing.
+*/
+class Precompute {
+    public:
+    // Returns whether it finished; false if it gave up because cancelled() was set
+    typedef std::function<bool(const Precompute &)> Work;
+
+    std::function<void()> on_idle; // runs on the service's task whenever nothing is queued
+
+    void add(const char *name, Work work) {
+        lock.take();
+        if (!stopped) {
+            Item item;
+            item.name = name;
+            item.work = work;
+            items.push_back(item);
+        }
+        lock.give();
+    }
+
+    void start() {
+        if (worker || stopped) {
+            return;
+        }
+        worker.reset(new pros::Task([this] { run(); }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Precompute"));
+    }
+
+    bool cancelled() const {
+        return cancel.load(std::memory_order_relaxed);
+    }
+
+    void stop() {
+        lock.take();
+        bool first = !stopped;
+        stopped = true;
+        lock.give();
+        if (!first) {
+            return;
+        }
+        cancel.store(true, std::memory_order_relaxed);
+        uint32_t start = pros::millis();
+        while (busy.load(std::memory_order_acquire)) {
+            pros::delay(1);
+        }
+        uint32_t waited = pros::millis() - start;
+        if (items.empty()) {
+            return;
+        }
+
+        size_t done = 0;
+        for (const Item &item : items) {
+            done += item.state == DONE;
+        }
+        printf("precompute: %u of %u items done before the match (stopping took %u ms)\n", (unsigned) done,
+               (unsigned) items.size(), waited);
+        for (const Item &item : items) {
+            const char *state = item.state == DONE ? "done" : item.state == CUT_SHORT ? "cut short" : "not started";
+            printf("  %-12s %5u ms  %s\n", state, item.took, item.name.c_str());
+        }
+    }
+
+    private:
+    enum State { QUEUED, DONE, CUT_SHORT };
+
+    struct Item {
+        std::string name;
+        Work work;
+        State state = QUEUED;
+        uint32_t took = 0; // ms it ran for
+    };
+
+    std::vector<Item> items;
+    pros::Mutex lock;
+    bool stopped = false;
+    std::atomic<bool> cancel{false};
+    std::atomic<bool> busy{false}; // an item is running; stop() waits on it
+    std::shared_ptr<pros::Task> worker;
+
+    void run() {
+        while (!cancelled()) {
+            lock.take();
+            size_t next = 0;
+            while (next < items.size() && items[next].state != QUEUED) {
+                next++;
+            }
+            bool found = next < items.size() && !stopped;
+            Work work;
+            if (found) {
+                work = items[next].work;
+                busy.store(true, std::memory_order_release);
+            }
+            lock.give();
+            if (!found) {
+                if (on_idle && !cancelled()) {
+                    on_idle();
+                }
+                pros::delay(20);
+                continue;
+            }
+
+            uint32_t start = pros::millis();
+            bool done = work(*this);
+            lock.take();
+            // items only grows, so next still points at the same item
+            items[next].state = done ? DONE : CUT_SHORT;
+            items[next].took = pros::millis() - start;
+            lock.give();
+            busy.store(false, std::memory_order_release);
+        }
+    }
+};
@@ -0,0 +1,322 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+#ifndef OKAPI_H
+#define OKAPI_H
+#include "okapi/api.hpp"
+#endif
+#ifndef MOTION_CPP
+#define MOTION_CPP
+#include "motion.cpp"
+#endif
+#ifndef ODOMETRY_CPP
+#define ODOMETRY_CPP
+#include "odometry.cpp"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+/*
+    Gains for follow_path(). Lengths are m, speeds m/s, curvature 1/m. The
+    lookahead shrinks from max_lookahead toward min_lookahead as the path
+    ahead bends, so the robot cuts straights smoothly and still holds a
+    corner; the speed is capped at turn_speed / curvature so it slows into
+    the bends, and at what it can stop in before the end.
+*/
+struct PursuitGains {
+    double max_velocity = 1.0;
+    double min_velocity = 0.12;     // so it doesn't crawl the last few cm
+    double max_acceleration = 2.0;
+    double turn_speed = 1.5;        // m/s allowed at 1 m radius
+    double min_lookahead = 0.2;
+    double max_lookahead = 0.5;
+    double lookahead_gain = 2.0;    // the lookahead is halfway down on a bend this many m in radius
+    double tolerance = 0.03;        // how close to the end counts as there
+    double spacing = 0.05;          // between path points
+};
+
+/*
+    A waypoint list filled in to evenly spaced points, each with the arc
+    length up to it, the path's curvature there and the speed to pass it at.
+
+    Finding the closest point is the only search follow_path() does every
+    tick, so the segments are bucketed into a grid of cell-sized squares by
+    the cells their bounding boxes touch. closest() only looks at the
+    segments in the robot's cell and the eight around it, and only those
+    ahead of the last answer by less than window of arc length, so a path
+    that crosses itself never jumps to the wrong pass. If the robot is off
+    the path by more than a cell it scans the window instead.
+*/
+class PursuitPath {
+    public:
+    PursuitGains gains;
+
+    PursuitPath(const std::vector<okapi::Point> &waypoints, const PursuitGains &gains_ = PursuitGains(), double cell_ = 0.25) {
+        gains = gains_;
+        cell = cell_;
+        fill(waypoints);
+        profile();
+        build_index();
+    }
+
+    size_t size() const {
+        return x.size();
+    }
+
+    double length() const {
+        return s.back();
+    }
+
+    // Arc length of the closest point on the path, no less than from and no more than window past it
+    double closest(double px, double py, double from, double window) const {
+        size_t first = segment_at(from);
+        double best = -1;
+        double best_d = 0;
+        int cx = key_of(px);
+        int cy = key_of(py);
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                auto found = grid.find(key(cx + dx, cy + dy));
+                if (found == grid.end()) {
+                    continue;
+                }
+                for (uint16_t i : found->second) {
+                    if (i < first || s[i] > from + window) {
+                        continue;
+                    }
+                    consider(i, px, py, from, best, best_d);
+                }
+            }
+        }
+        if (best < 0) {
+            for (size_t i = first; i + 1 < size() && s[i] <= from + window; i++) {
+                consider(i, px, py, from, best, best_d);
+            }
+        }
+        return best < 0 ? from : best;
+    }
+
+    // The point at arc length at; past the end it carries on along the last segment
+    void point_at(double at, double &px, double &py) const {
+        size_t i = segment_at(at);
+        double t = (at - s[i]) / (s[i + 1] - s[i]);
+        if (i + 2 < size()) {
+            t = std::min(t, 1.0);
+        }
+        px = x[i] + t * (x[i + 1] - x[i]);
+        py = y[i] + t * (y[i + 1] - y[i]);
+    }
+
+    // Largest curvature between arc lengths from and to
+    double curvature_between(double from, double to) const {
+        double most = 0;
+        for (size_t i = segment_at(from); i < size() && s[i] <= to; i++) {
+            most = std::max(most, curvature[i]);
+        }
+        return most;
+    }
+
+    double velocity_at(double at) const {
+        size_t i = segment_at(at);
+        double t = std::min(1.0, (at - s[i]) / (s[i + 1] - s[i]));
+        return velocity[i] + t * (velocity[i + 1] - velocity[i]);
+    }
+
+    double end_x() const {
+        return x.back();
+    }
+
+    double end_y() const {
+        return y.back();
+    }
+
+    private:
+    double cell;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> s;
+    std::vector<double> curvature;
+    std::vector<double> velocity;
+    std::unordered_map<uint32_t, std::vector<uint16_t>> grid;
+
+    void fill(const std::vector<okapi::Point> &waypoints) {
+        for (size_t w = 0; w < waypoints.size(); w++) {
+            double wx = waypoints[w].x.convert(okapi::meter);
+            double wy = waypoints[w].y.convert(okapi::meter);
+            if (w > 0) {
+                double ax = x.back();
+                double ay = y.back();
+                double span = std::hypot(wx - ax, wy - ay);
+                int steps = (int) std::ceil(span / gains.spacing);
+                for (int k = 1; k < steps; k++) {
+                    add(ax + (wx - ax) * k / steps, ay + (wy - ay) * k / steps);
+                }
+                if (span == 0) {
+                    continue;
+                }
+            }
+            add(wx, wy);
+        }
+        if (size() == 1) {
+            add(x[0], y[0]); // one point still needs a segment
+        }
+    }
+
+    void add(double px, double py) {
+        s.push_back(x.empty() ? 0 : s.back() + std::hypot(px - x.back(), py - y.back()));
+        x.push_back(px);
+        y.push_back(py);
+    }
+
+    // Curvature from the circle through each point and the points min_lookahead either side, then the speed to pass it at
+    void profile() {
+        size_t n = size();
+        size_t reach = std::max<size_t>(1, (size_t) std::round(gains.min_lookahead / gains.spacing));
+        curvature.assign(n, 0);
+        velocity.assign(n, gains.max_velocity);
+        for (size_t i = 1; i + 1 < n; i++) {
+            size_t a = i > reach ? i - reach : 0;
+            size_t b = std::min(n - 1, i + reach);
+            double abx = x[b] - x[a], aby = y[b] - y[a];
+            double aix = x[i] - x[a], aiy = y[i] - y[a];
+            double ibx = x[b] - x[i], iby = y[b] - y[i];
+            double product = std::hypot(abx, aby) * std::hypot(aix, aiy) * std::hypot(ibx, iby);
+            if (product > 1e-9) {
+                curvature[i] = 2 * std::abs(aix * iby - aiy * ibx) / product;
+            }
+            if (curvature[i] > 0) {
+                velocity[i] = std::min(gains.max_velocity, gains.turn_speed / curvature[i]);
+            }
+        }
+        velocity[n - 1] = 0;
+        for (size_t i = n - 1; i-- > 0;) {
+            velocity[i] = std::min(velocity[i], std::sqrt(velocity[i + 1] * velocity[i + 1] + 2 * gains.max_acceleration * (s[i + 1] - s[i])));
+        }
+    }
+
+    void build_index() {
+        for (size_t i = 0; i + 1 < size(); i++) {
+            int x0 = key_of(std::min(x[i], x[i + 1])), x1 = key_of(std::max(x[i], x[i + 1]));
+            int y0 = key_of(std::min(y[i], y[i + 1])), y1 = key_of(std::max(y[i], y[i + 1]));
+            for (int cx = x0; cx <= x1; cx++) {
+                for (int cy = y0; cy <= y1; cy++) {
+                    grid[key(cx, cy)].push_back(i);
+                }
+            }
+        }
+    }
+
+    int key_of(double v) const {
+        return (int) std::floor(v / cell);
+    }
+
+    static uint32_t key(int cx, int cy) {
+        return (uint32_t) (cx & 0xffff) << 16 | (uint32_t) (cy & 0xffff);
+    }
+
+    // Segment i, the last one if at is past the end
+    size_t segment_at(double at) const {
+        size_t i = std::upper_bound(s.begin(), s.end(), at) - s.begin();
+        return std::min(i > 0 ? i - 1 : 0, size() - 2);
+    }
+
+    void consider(size_t i, double px, double py, double from, double &best, double &best_d) const {
+        double dx = x[i + 1] - x[i];
+        double dy = y[i + 1] - y[i];
+        double len2 = dx * dx + dy * dy;
+        double t = len2 > 0 ? ((px - x[i]) * dx + (py - y[i]) * dy) / len2 : 0;
+        t = std::max(0.0, std::min(1.0, t));
+        double d = std::hypot(x[i] + t * dx - px, y[i] + t * dy - py);
+        double at = std::max(from, s[i] + t * (s[i + 1] - s[i]));
+        if (best < 0 || d < best_d) {
+            best = at;
+            best_d = d;
+        }
+    }
+};
+
+/*
+    Follows a path without stopping at its corners: every 10 ms it finds the
+    closest point on the path, aims at the point one lookahead further along,
+    and drives the arc through it at the path's speed there. Done once the
+    robot is within tolerance of the end or has passed it. With reverse the
+    robot backs along the path.
+
+    Wheel speeds go to the motors' velocity control, converted with the same
+    scale odometry uses. Prints how long it took and how far from the end it
+    stopped.
+*/
+motion_exit follow_path(const PursuitPath &path, bool reverse, std::shared_ptr<Odometry> odom, std::shared_ptr<okapi::MotorGroup> drive_lft, std::shared_ptr<okapi::MotorGroup> drive_rt, std::shared_ptr<SensorHub> sensors, const DriveSpec &drive, const ExitPolicy &exit = ExitPolicy())
+{
+    const PursuitGains &g = path.gains;
+    double track = drive.wheel_track.convert(okapi::meter);
+    double rpm_per_mps = drive.rpm_per_mps();
+    double max_rpm = drive.max_rpm();
+    uint32_t dt = 10;
+
+    double along = 0;
+    double speed = 0;
+    motion_exit result = EXIT_SETTLED;
+    uint32_t start = pros::millis();
+    uint32_t now = start;
+    while (true) {
+        if (exit.timeout > 0 && pros::millis() - start >= exit.timeout) {
+            result = EXIT_TIMEOUT;
+            break;
+        }
+        if (exit.condition && exit.condition(sensors->latest())) {
+            result = EXIT_CONDITION;
+            break;
+        }
+        okapi::OdomState pose = odom->get_state();
+        double px = pose.x.convert(okapi::meter);
+        double py = pose.y.convert(okapi::meter);
+        double theta = pose.theta.convert(okapi::radian) + (reverse ? M_PI : 0);
+
+        along = path.closest(px, py, along, 2 * g.max_lookahead);
+        double left_over = std::hypot(path.end_x() - px, path.end_y() - py);
+        double ahead = (path.end_x() - px) * std::cos(theta) + (path.end_y() - py) * std::sin(theta);
+        if (exit.settle && (left_over < g.tolerance || (along >= path.length() - g.max_lookahead && ahead <= 0))) {
+            break;
+        }
+
+        double bend = path.curvature_between(along, along + g.max_lookahead);
+        double lookahead = g.min_lookahead + (g.max_lookahead - g.min_lookahead) / (1 + g.lookahead_gain * bend);
+        double cx, cy;
+        path.point_at(along + lookahead, cx, cy);
+        // the carrot in the robot's frame: forward and to the right
+        double fwd = (cx - px) * std::cos(theta) + (cy - py) * std::sin(theta);
+        double side = -(cx - px) * std::sin(theta) + (cy - py) * std::cos(theta);
+        double dist2 = fwd * fwd + side * side;
+        double curve = dist2 > 1e-6 ? 2 * side / dist2 : 0;
+
+        double target = std::max(g.min_velocity, std::min(path.velocity_at(along), std::sqrt(2 * g.max_acceleration * left_over)));
+        speed = std::min(target, speed + g.max_acceleration * dt / 1000.0);
+
+        double left = speed * (1 + curve * track / 2) * rpm_per_mps;
+        double right = speed * (1 - curve * track / 2) * rpm_per_mps;
+        double over = std::max(std::abs(left), std::abs(right)) / max_rpm;
+        if (over > 1) {
+            left /= over;
+            right /= over;
+        }
+        if (reverse) {
+            std::swap(left, right);
+            left = -left;
+            right = -right;
+        }
+        drive_lft->moveVelocity(left);
+        drive_rt->moveVelocity(right);
+        pros::Task::delay_until(&now, dt);
+    }
+    brake_stop(drive_lft, drive_rt, sensors);
+
+    okapi::OdomState end = odom->get_state();
+    printf("follow: %.2f m in %u ms, stopped %.3f m from the end\n", path.length(), pros::millis() - start,
+           std::hypot(path.end_x() - end.x.convert(okapi::meter), path.end_y() - end.y.convert(okapi::meter)));
+    return result;
+}
@@ -0,0 +1,155 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+#ifndef OKAPI_H
+#define OKAPI_H
+#include "okapi/api.hpp"
+#endif
+#ifndef MOTION_CPP
+#define MOTION_CPP
+#include "motion.cpp"
+#endif
+#ifndef ODOMETRY_CPP
+#define ODOMETRY_CPP
+#include "odometry.cpp"
+#endif
+#include "trajectory_format.hpp"
+
+#include <cmath>
+#include <vector>
+
+/*
+    Gains for follow_trajectory(), as in the RAMSETE paper: b (1/m^2) sets
+    how hard it pulls back onto the path, zeta (0-1) how damped that is.
+    The motors' velocity control takes a moment to catch up with a command,
+    so the speed and turn rate fed forward are taken lead s ahead.
+*/
+struct RamseteGains {
+    double b = 2.0;
+    double zeta = 0.7;
+    double lead = 0.06;
+};
+
+// Angle in rad wrapped to [-pi, pi)
+double wrap_angle(double a)
+{
+    return a - 2 * M_PI * std::floor((a + M_PI) / (2 * M_PI));
+}
+
+/*
+    Tracks a centre trajectory closed loop instead of playing the wheel
+    profiles open loop the way AsyncMotionProfileController does, so a bump
+    or a slipping wheel gets corrected instead of becoming a permanent error
+    in where the robot ends up.
+
+    Every 10 ms it takes the trajectory's pose, speed and turn rate at that
+    time as feedforward and adds the RAMSETE feedback law on the odometry
+    pose's error in the robot's frame; the result goes to the wheels'
+    velocity control. The trajectory is relative to where the robot is when
+    it starts, like a motion profile; its first point is the robot's pose.
+    Prints the worst tracking error and how far off the final pose it ended.
+
+    Trajectory is a PackedTrajectory in memory or a TrajectoryStream off
+    the SD card; it only needs the pose and speed at each point. If a
+    stream can't be read partway, the robot stops there and it returns
+    EXIT_TIMEOUT.
+*/
+template <typename Trajectory>
+motion_exit follow_trajectory(Trajectory &t, std::shared_ptr<Odometry> odom, std::shared_ptr<okapi::MotorGroup> drive_lft, std::shared_ptr<okapi::MotorGroup> drive_rt, std::shared_ptr<SensorHub> sensors, const DriveSpec &drive, const ExitPolicy &exit = ExitPolicy(), const RamseteGains &gains = RamseteGains())
+{
+    size_t length = t.length;
+    float x0, y0, heading0, v;
+    if (length == 0 || !t.point(0, x0, y0, heading0, v)) {
+        return EXIT_SETTLED;
+    }
+    double track = drive.wheel_track.convert(okapi::meter);
+    double rpm_per_mps = drive.rpm_per_mps();
+    double max_rpm = drive.max_rpm();
+    uint32_t dt = 10;
+
+    // where the trajectory's first point is on the field
+    okapi::OdomState origin = odom->get_state();
+    double turn = origin.theta.convert(okapi::radian) - heading0;
+    double ox = origin.x.convert(okapi::meter);
+    double oy = origin.y.convert(okapi::meter);
+    // point i on the field, with its heading and speed; false if it couldn't be read
+    auto field = [&](size_t i, double &x, double &y, double &heading, double &speed) {
+        float px, py, ph, pv;
+        if (!t.point(i, px, py, ph, pv)) {
+            return false;
+        }
+        double rx = px - x0;
+        double ry = py - y0;
+        x = ox + rx * std::cos(turn) - ry * std::sin(turn);
+        y = oy + rx * std::sin(turn) + ry * std::cos(turn);
+        heading = ph + turn;
+        speed = pv;
+        return true;
+    };
+
+    double worst = 0;
+    motion_exit result = EXIT_SETTLED;
+    uint32_t start = pros::millis();
+    uint32_t now = start;
+    while (true) {
+        if (exit.timeout > 0 && pros::millis() - start >= exit.timeout) {
+            result = EXIT_TIMEOUT;
+            break;
+        }
+        if (exit.condition && exit.condition(sensors->latest())) {
+            result = EXIT_CONDITION;
+            break;
+        }
+        size_t i = (size_t) ((pros::millis() - start) / 1000.0 / t.dt);
+        if (i >= length) {
+            break;
+        }
+        size_t ahead = std::min(length - 1, i + (size_t) std::round(gains.lead / t.dt));
+        double rx, ry, rtheta, rv, ax, ay, ah, vr;
+        if (!field(i, rx, ry, rtheta, rv) || !field(ahead, ax, ay, ah, vr)) {
+            result = EXIT_TIMEOUT;
+            break;
+        }
+        double wr = t.turn_rate(ahead);
+
+        okapi::OdomState pose = odom->get_state();
+        double theta = pose.theta.convert(okapi::radian);
+        double dx = rx - pose.x.convert(okapi::meter);
+        double dy = ry - pose.y.convert(okapi::meter);
+        double ex = dx * std::cos(theta) + dy * std::sin(theta);
+        double ey = -dx * std::sin(theta) + dy * std::cos(theta);
+        double etheta = wrap_angle(rtheta - theta);
+        worst = std::max(worst, std::hypot(ex, ey));
+
+        double k = 2 * gains.zeta * std::sqrt(wr * wr + gains.b * vr * vr);
+        double sinc = std::abs(etheta) < 1e-6 ? 1 : std::sin(etheta) / etheta;
+        double v = vr * std::cos(etheta) + k * ex;
+        double w = wr + k * etheta + gains.b * vr * sinc * ey;
+
+        // w is clockwise, so the left side runs faster
+        double left = (v + w * track / 2) * rpm_per_mps;
+        double right = (v - w * track / 2) * rpm_per_mps;
+        double over = std::max(std::abs(left), std::abs(right)) / max_rpm;
+        if (over > 1) {
+            left /= over;
+            right /= over;
+        }
+        drive_lft->moveVelocity(left);
+        drive_rt->moveVelocity(right);
+        pros::Task::delay_until(&now, dt);
+    }
+    brake_stop(drive_lft, drive_rt, sensors);
+
+    double ex, ey, eh, ev;
+    if (!field(length - 1, ex, ey, eh, ev)) {
+        printf("ramsete: %s: couldn't read the trajectory\n", t.name);
+        return result;
+    }
+    okapi::OdomState end = odom->get_state();
+    double heading = wrap_angle(eh - end.theta.convert(okapi::radian));
+    printf("ramsete: %s: %.2f s trajectory, worst tracking error %.3f m, ended %.3f m and %.1f deg off\n",
+           t.name, length * t.dt, worst,
+           std::hypot(ex - end.x.convert(okapi::meter), ey - end.y.convert(okapi::meter)), heading * 180 / M_PI);
+    return result;
+}
@@ -0,0 +1,230 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+#ifndef OKAPI_H
+#define OKAPI_H
+#include "okapi/api.hpp"
+#endif
+#ifndef SEQLOCK_CPP
+#define SEQLOCK_CPP
+#include "seqlock.cpp"
+#endif
+
+#include <atomic>
+#include <functional>
+
+// Everything the controllers read from the smart ports, sampled together
+struct SensorSnapshot {
+    uint32_t time = 0;   // pros::millis() when the frame was taken
+    uint32_t frame = 0;  // 0 until the first frame is in
+
+    double rotation = 0;
+    double pitch = 0;
+    double roll = 0;
+    pros::c::imu_gyro_s_t gyro = {0, 0, 0};
+
+    int32_t distance = 0;  // mm, 0 when nothing is in range
+    int32_t distance_confidence = 0;
+    double distance_velocity = 0;
+
+    bool imu_ready = false; // rotation, pitch, roll and gyro are 0 until it is
+
+    double left_position = 0;
+    double right_position = 0;
+    double left_velocity = 0;
+    double right_velocity = 0;
+    int32_t left_counts = 0;  // front motor's raw encoder; tarePosition() doesn't reset it
+    int32_t right_counts = 0;
+};
+
+/*
+    IMU calibration in the background. start() begins the reset, which PROS
+    doesn't block on, and a small task that watches for it to finish, so
+    initialize() can build everything else in the ~2 s it takes. Anything
+    that needs a heading waits on wait() with a timeout instead of reading
+    a heading that isn't there yet.
+
+    on_ready, if set, runs on the watcher task with the pros::millis() the
+    IMU came ready at. If the reset can't start (nothing on the port) it is
+    failed before start() returns. If the IMU is still calibrating after
+    limit ms it is failed too, and on_failed runs on the watcher task, but
+    the watcher keeps looking: an IMU that finishes late clears the failure
+    and still becomes ready.
+*/
+class ImuCalibration {
+    public:
+    std::function<void(uint32_t)> on_ready;
+    std::function<void()> on_failed;
+
+    ImuCalibration(std::shared_ptr<pros::Imu> imu_, uint32_t limit_ = 3000) {
+        imu = imu_;
+        limit = limit_;
+    }
+
+    void start() {
+        if (watcher) {
+            return;
+        }
+        started_at = pros::millis();
+        if (imu->reset() == PROS_ERR) {
+            failed = true;
+            return;
+        }
+        watcher.reset(new pros::Task([this] { run(); }, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_MIN, "IMU Calibration"));
+    }
+
+    bool ready() const {
+        return ready_at.load(std::memory_order_acquire) != 0;
+    }
+
+    // Blocks until the IMU is ready or timeout ms have passed (0 waits for good); false if it isn't ready
+    bool wait(uint32_t timeout) const {
+        uint32_t start = pros::millis();
+        while (!ready()) {
+            if (failed || (timeout > 0 && pros::millis() - start >= timeout)) {
+                return false;
+            }
+            pros::delay(5);
+        }
+        return true;
+    }
+
+    // pros::millis() when calibration finished, 0 until then
+    uint32_t get_ready_time() const {
+        return ready_at.load(std::memory_order_acquire);
+    }
+
+    uint32_t get_duration() const {
+        return ready() ? get_ready_time() - started_at : 0;
+    }
+
+    bool get_failed() const {
+        return failed;
+    }
+
+    private:
+    std::shared_ptr<pros::Imu> imu;
+    uint32_t limit;
+    uint32_t started_at = 0;
+    std::atomic<uint32_t> ready_at{0};
+    std::atomic<bool> failed{false};
+    std::shared_ptr<pros::Task> watcher;
+
+    void run() {
+        pros::delay(20); // the status only says calibrating once the IMU has taken the reset
+        uint32_t period = 10;
+        while (imu->is_calibrating()) {
+            if (!failed && pros::millis() - started_at >= limit) {
+                failed = true;
+                if (on_failed) {
+                    on_failed();
+                }
+                period = 100; // nothing waits on it any more, so look less often
+            }
+            pros::delay(period);
+        }
+        uint32_t now = std::max<uint32_t>(pros::millis(), 1);
+        ready_at.store(now, std::memory_order_release);
+        failed = false;
+        if (on_ready) {
+            on_ready(now);
+        }
+    }
+};
+
+/*
+    One task reads every sensor once per frame and publishes the frame through
+    a Seqlock. The sampler runs above every reader, so a reader never waits on
+    it and never blocks.
+*/
+class SensorHub {
+    public:
+    SensorHub(std::shared_ptr<pros::Imu> imu_,
+              std::shared_ptr<pros::Distance> dist_,
+              std::shared_ptr<okapi::MotorGroup> lft_,
+              std::shared_ptr<okapi::MotorGroup> rt_,
+              uint32_t period_ = 5) {
+        imu = imu_;
+        dist = dist_;
+        lft = lft_;
+        rt = rt_;
+        period = period_;
+    }
+
+    void start() {
+        if (sampler) {
+            return;
+        }
+        sample();
+        sampler.reset(new pros::Task([this] { run(); }, TASK_PRIORITY_MAX - 2, TASK_STACK_DEPTH_DEFAULT, "Sensors"));
+    }
+
+    SensorSnapshot latest() const {
+        return frame.read();
+    }
+
+    uint32_t get_period() const {
+        return period;
+    }
+
+    // Set before start(); until it is ready, frames leave the IMU readings at 0
+    void set_calibration(std::shared_ptr<ImuCalibration> calibration_) {
+        calibration = calibration_;
+    }
+
+    // For anything that needs a heading; false if the IMU wasn't ready within timeout ms (0 waits for good)
+    bool wait_for_imu(uint32_t timeout) const {
+        return !calibration || calibration->wait(timeout);
+    }
+
+    private:
+    std::shared_ptr<pros::Imu> imu;
+    std::shared_ptr<pros::Distance> dist;
+    std::shared_ptr<okapi::MotorGroup> lft;
+    std::shared_ptr<okapi::MotorGroup> rt;
+    std::shared_ptr<ImuCalibration> calibration;
+    uint32_t period;
+
+    std::shared_ptr<pros::Task> sampler;
+    Seqlock<SensorSnapshot> frame;
+    uint32_t frames = 0;
+
+    void run() {
+        uint32_t now = pros::millis();
+        while (true) {
+            pros::Task::delay_until(&now, period);
+            sample();
+        }
+    }
+
+    void sample() {
+        SensorSnapshot next;
+        next.time = pros::millis();
+        next.frame = ++frames;
+        next.imu_ready = imu && (!calibration || calibration->ready());
+        if (next.imu_ready) {
+            next.rotation = imu->get_rotation();
+            next.pitch = imu->get_pitch();
+            next.roll = imu->get_roll();
+            next.gyro = imu->get_gyro_rate();
+        }
+        if (dist) {
+            next.distance = dist->get();
+            next.distance_confidence = dist->get_confidence();
+            next.distance_velocity = dist->get_object_velocity();
+        }
+        if (lft) {
+            next.left_position = lft->getPosition();
+            next.left_velocity = lft->getActualVelocity();
+            next.left_counts = lft->getRawPosition(nullptr);
+        }
+        if (rt) {
+            next.right_position = rt->getPosition();
+            next.right_velocity = rt->getActualVelocity();
+            next.right_counts = rt->getRawPosition(nullptr);
+        }
+
+        frame.write(next);
+    }
+};
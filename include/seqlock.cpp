@@ -0,0 +1,41 @@
+#include <atomic>
+#include <cstdint>
+
+/*
+    Hands the newest value from one writer task to any number of readers
+    without either side waiting. The sequence number is odd while a write is
+    under way, and a reader that saw it odd, or saw it change while copying,
+    copies again. The writers here all run above their readers, so a reader
+    is never stuck behind a write half done.
+
+    Only one task may write at a time; a class whose value is written from
+    more than one task (set_state() and the odometry task, say) has to hold
+    its own lock around write().
+*/
+template <typename T>
+class Seqlock {
+    public:
+    T read() const {
+        T copy;
+        uint32_t before, after;
+        do {
+            before = seq.load(std::memory_order_acquire);
+            copy = value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = seq.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        return copy;
+    }
+
+    void write(const T &next) {
+        uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        value = next;
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    private:
+    std::atomic<uint32_t> seq{0};
+    T value;
+};
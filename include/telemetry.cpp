@@ -0,0 +1,261 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+#ifndef OKAPI_H
+#define OKAPI_H
+#include "okapi/api.hpp"
+#endif
+#ifndef SENSORS_CPP
+#define SENSORS_CPP
+#include "sensors.cpp"
+#endif
+#include "telemetry_format.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/*
+    Telemetry log: any task append()s fixed size records into a RAM ring,
+    and a low priority task writes them to the SD card in big batches.
+
+    The ring is a bounded multi-producer queue. Every slot carries a sequence
+    number that says whether it is free for the writer holding a given ticket
+    or full for the flusher; a writer claims a ticket with one compare and
+    swap and never waits. If the flusher falls a whole ring behind, new
+    records are dropped and counted instead of blocking the control loop
+    that offered them.
+
+    Logs go to <dir>/tlm_NNN.bin, the first number not already used, and
+    sim/tools/telemetry_decode turns them into CSV.
+*/
+class Telemetry {
+    public:
+    Telemetry(const char *dir_ = "/usd", uint32_t flush_period_ = 100) : slots(CAPACITY) {
+        snprintf(dir, sizeof(dir), "%s", dir_);
+        flush_period = flush_period_;
+        for (uint32_t i = 0; i < CAPACITY; i++) {
+            slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Opens the next free log and starts the flusher; false if there is nowhere to write
+    bool start(const uint8_t *ports, uint8_t motors) {
+        if (flusher) {
+            return true;
+        }
+        for (int n = 0; n < 1000 && file == NULL; n++) {
+            snprintf(path, sizeof(path), "%s/tlm_%03d.bin", dir, n);
+            FILE *existing = fopen(path, "rb");
+            if (existing != NULL) {
+                fclose(existing);
+                continue;
+            }
+            file = fopen(path, "wb");
+            if (file == NULL) {
+                return false;
+            }
+        }
+        if (file == NULL) {
+            return false;
+        }
+
+        TelemetryHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, TELEMETRY_MAGIC, 4);
+        header.version = TELEMETRY_VERSION;
+        header.record_size = sizeof(TelemetryRecord);
+        header.motors = motors < TELEMETRY_MOTORS ? motors : TELEMETRY_MOTORS;
+        memcpy(header.ports, ports, header.motors);
+        fwrite(&header, sizeof(header), 1, file);
+
+        flusher.reset(new pros::Task([this] { run(); }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Telemetry Flush"));
+        return true;
+    }
+
+    // Never blocks; false if the ring was full and the record was dropped.
+    // Records are numbered as they are offered, so dropped ones leave a gap,
+    // and two tasks racing here can land in the ring in either order.
+    bool append(const TelemetryRecord &record) {
+        uint32_t number = offered.fetch_add(1, std::memory_order_relaxed);
+        uint32_t pos = head.load(std::memory_order_relaxed);
+        while (true) {
+            Slot &slot = slots[pos & (CAPACITY - 1)];
+            int32_t diff = (int32_t) (slot.seq.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.record = record;
+                    slot.record.seq = number;
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void set_step(uint16_t id) {
+        step.store(id, std::memory_order_relaxed);
+    }
+
+    uint16_t get_step() const {
+        return step.load(std::memory_order_relaxed);
+    }
+
+    uint32_t get_written() const {
+        return written.load(std::memory_order_relaxed);
+    }
+
+    uint32_t get_dropped() const {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+    const char *get_path() const {
+        return path;
+    }
+
+    // Writes out whatever is in the ring now; the flusher calls this, but so can the end of a routine
+    void flush() {
+        if (file == NULL) {
+            return;
+        }
+        flushing.take(); // only between flushes, appends never take it
+        uint32_t count = 0;
+        while (true) {
+            Slot &slot = slots[tail & (CAPACITY - 1)];
+            if (slot.seq.load(std::memory_order_acquire) != tail + 1) {
+                break;
+            }
+            batch[count++] = slot.record;
+            slot.seq.store(tail + CAPACITY, std::memory_order_release);
+            tail++;
+            if (count == BATCH) {
+                fwrite(batch, sizeof(TelemetryRecord), count, file);
+                written.fetch_add(count, std::memory_order_relaxed);
+                count = 0;
+            }
+        }
+        if (count > 0) {
+            fwrite(batch, sizeof(TelemetryRecord), count, file);
+            written.fetch_add(count, std::memory_order_relaxed);
+        }
+        fflush(file);
+        flushing.give();
+    }
+
+    private:
+    static const uint32_t CAPACITY = 1024; // records, a power of two; 10 s at 100 Hz
+    static const uint32_t BATCH = 64;      // records per fwrite
+
+    struct Slot {
+        std::atomic<uint32_t> seq{0};
+        TelemetryRecord record;
+    };
+
+    char dir[32];
+    char path[48] = "";
+    uint32_t flush_period;
+    FILE *file = NULL;
+    std::shared_ptr<pros::Task> flusher;
+    pros::Mutex flushing;
+
+    std::vector<Slot> slots;
+    std::atomic<uint32_t> head{0};
+    uint32_t tail = 0; // only touched by the flusher
+    TelemetryRecord batch[BATCH];
+
+    std::atomic<uint32_t> offered{0};
+    std::atomic<uint32_t> written{0};
+    std::atomic<uint32_t> dropped{0};
+    std::atomic<uint16_t> step{TELEMETRY_NO_STEP};
+
+    void run() {
+        uint32_t now = pros::millis();
+        while (true) {
+            pros::Task::delay_until(&now, flush_period);
+            flush();
+        }
+    }
+};
+
+/*
+    Samples the whole robot into a Telemetry log at a fixed rate: every
+    motor's voltage, current, temperature and position, plus the latest
+    SensorHub frame. Runs just under the control loops so it only takes the
+    time they leave.
+*/
+class TelemetrySampler {
+    public:
+    TelemetrySampler(std::shared_ptr<Telemetry> log_,
+                     std::vector<std::shared_ptr<okapi::Motor>> motors_,
+                     std::shared_ptr<SensorHub> sensors_,
+                     uint32_t period_ = 10) {
+        log = log_;
+        motors = motors_;
+        if (motors.size() > TELEMETRY_MOTORS) {
+            motors.resize(TELEMETRY_MOTORS);
+        }
+        sensors = sensors_;
+        period = period_;
+    }
+
+    bool start() {
+        if (sampler) {
+            return true;
+        }
+        uint8_t ports[TELEMETRY_MOTORS] = {0};
+        for (size_t i = 0; i < motors.size(); i++) {
+            ports[i] = motors[i]->getPort();
+        }
+        if (!log->start(ports, motors.size())) {
+            return false;
+        }
+        sampler.reset(new pros::Task([this] { run(); }, TASK_PRIORITY_DEFAULT - 1, TASK_STACK_DEPTH_DEFAULT, "Telemetry"));
+        return true;
+    }
+
+    private:
+    std::shared_ptr<Telemetry> log;
+    std::vector<std::shared_ptr<okapi::Motor>> motors;
+    std::shared_ptr<SensorHub> sensors;
+    uint32_t period;
+    std::shared_ptr<pros::Task> sampler;
+
+    void run() {
+        uint32_t now = pros::millis();
+        while (true) {
+            sample();
+            pros::Task::delay_until(&now, period);
+        }
+    }
+
+    void sample() {
+        TelemetryRecord r;
+        memset(&r, 0, sizeof(r));
+        r.time = pros::millis();
+        r.step = log->get_step();
+        for (size_t i = 0; i < motors.size(); i++) {
+            r.voltage[i] = motors[i]->getVoltage();
+            r.current[i] = motors[i]->getCurrentDraw();
+            r.temperature[i] = motors[i]->getTemperature();
+            r.position[i] = motors[i]->getPosition();
+        }
+        if (sensors) {
+            SensorSnapshot s = sensors->latest();
+            r.rotation = s.rotation;
+            r.pitch = s.pitch;
+            r.roll = s.roll;
+            r.distance = s.distance;
+            r.distance_confidence = s.distance_confidence;
+        }
+        log->append(r);
+    }
+};
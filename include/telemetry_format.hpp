@@ -0,0 +1,48 @@
+#ifndef TELEMETRY_FORMAT_HPP
+#define TELEMETRY_FORMAT_HPP
+
+#include <cstdint>
+
+/*
+    Layout of the telemetry logs on the SD card. Shared by the robot code and
+    sim/tools/telemetry_decode.cpp, so it only uses fixed size types.
+
+    A log is one TelemetryHeader followed by TelemetryRecords back to back,
+    little endian as the brain writes them. Bump TELEMETRY_VERSION whenever a
+    record changes.
+*/
+
+#define TELEMETRY_MAGIC "SKTL"
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_MOTORS 12
+#define TELEMETRY_NO_STEP 0xFFFF
+
+struct TelemetryHeader {
+    char magic[4];            // TELEMETRY_MAGIC
+    uint16_t version;         // TELEMETRY_VERSION
+    uint16_t record_size;     // sizeof(TelemetryRecord)
+    uint8_t motors;           // how many of the motor slots are used
+    uint8_t ports[TELEMETRY_MOTORS]; // smart port of each motor slot
+    uint8_t reserved[3];
+};
+
+struct TelemetryRecord {
+    uint32_t seq;             // counts every record offered, so gaps show drops
+    uint32_t time;            // ms
+    uint16_t step;            // auton step id, TELEMETRY_NO_STEP outside auton
+    uint16_t flags;
+    int16_t voltage[TELEMETRY_MOTORS];    // mV
+    int16_t current[TELEMETRY_MOTORS];    // mA
+    int8_t temperature[TELEMETRY_MOTORS]; // deg C
+    float position[TELEMETRY_MOTORS];     // encoder, in each motor's units
+    float rotation;           // IMU, deg
+    float pitch;
+    float roll;
+    int16_t distance;         // mm
+    int16_t distance_confidence;
+};
+
+static_assert(sizeof(TelemetryHeader) == 24, "telemetry header layout changed");
+static_assert(sizeof(TelemetryRecord) == 136, "telemetry record layout changed, bump TELEMETRY_VERSION");
+
+#endif
@@ -0,0 +1,343 @@
+#ifndef TRAJECTORY_HPP
+#define TRAJECTORY_HPP
+
+#include "okapi/pathfinder/include/pathfinder/structs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+    Trajectories as Pathfinder lays them out: one Segment per dt along the
+    path's centre, with position, speed and acceleration along it and the
+    pose it is at. Shared by the robot code and sim/tools/trajectory_gen.cpp,
+    so it only uses the standard library.
+
+    Waypoints and segments are in odometry's frame: x forward from the start,
+    y to the right, heading clockwise, in m and rad.
+*/
+
+/*
+    A centre trajectory as the follower reads it: the pose and speed at each
+    point, one float array per field, every point dt apart. A Segment keeps
+    eight doubles, 64 bytes a point, and a tank pair keeps two of those; this
+    keeps 16. The arrays can be tables generated into flash or a
+    TrajectoryStore's.
+*/
+struct PackedTrajectory {
+    const char *name;
+    float dt;              // s between points
+    uint32_t length;
+    const float *x;        // m, odometry's frame
+    const float *y;
+    const float *heading;  // rad clockwise
+    const float *velocity; // m/s along the path
+
+    // Point i; always there, the arrays are in memory
+    bool point(uint32_t i, float &x_, float &y_, float &heading_, float &velocity_) const {
+        x_ = x[i];
+        y_ = y[i];
+        heading_ = heading[i];
+        velocity_ = velocity[i];
+        return true;
+    }
+
+    // rad/s clockwise from point i to the next; 0 at the last point
+    double turn_rate(uint32_t i) const {
+        if (i + 1 >= length) {
+            return 0;
+        }
+        return std::remainder((double) heading[i + 1] - heading[i], 2 * M_PI) / dt;
+    }
+
+    // The wheels' speeds at point i for a drive with this track, as Pathfinder's tank modifier would give them
+    void wheel_speeds(uint32_t i, double track, double &left, double &right) const {
+        double w = turn_rate(i);
+        left = velocity[i] + w * track / 2;
+        right = velocity[i] - w * track / 2;
+    }
+};
+
+/*
+    Trajectories by number. add() gives each one the next id, and followers
+    look them up with get(), an index, rather than by name; find() is for
+    turning a name into its id once, at setup. Tables already in flash are
+    kept as they are, and anything else is packed into arrays owned here.
+*/
+class TrajectoryStore {
+    public:
+    uint16_t add(const PackedTrajectory &table) {
+        trajectories.push_back(table);
+        return trajectories.size() - 1;
+    }
+
+    uint16_t add(const std::string &name, const std::vector<Segment> &segments) {
+        size_t n = segments.size();
+        std::vector<float> block(4 * n);
+        for (size_t i = 0; i < n; i++) {
+            block[i] = segments[i].x;
+            block[n + i] = segments[i].y;
+            block[2 * n + i] = segments[i].heading;
+            block[3 * n + i] = segments[i].velocity;
+        }
+        return add(name, n > 0 ? (float) segments[0].dt : 0.01f, std::move(block));
+    }
+
+    // block is the four arrays one after the other, as a trajectory file has them
+    uint16_t add(const std::string &name, float dt, std::vector<float> &&block) {
+        uint32_t n = block.size() / 4;
+        names.push_back(std::unique_ptr<std::string>(new std::string(name)));
+        blocks.push_back(std::move(block)); // moving keeps the data where it is
+        const float *data = blocks.back().data();
+        return add({names.back()->c_str(), dt, n, data, data + n, data + 2 * n, data + 3 * n});
+    }
+
+    const PackedTrajectory &get(uint16_t id) const {
+        return trajectories[id];
+    }
+
+    // The id of the trajectory called name, or -1
+    int find(const std::string &name) const {
+        for (size_t i = 0; i < trajectories.size(); i++) {
+            if (name == trajectories[i].name) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    size_t size() const {
+        return trajectories.size();
+    }
+
+    // RAM this store uses, not counting tables that stay in flash
+    size_t bytes() const {
+        size_t total = sizeof(*this) + trajectories.capacity() * sizeof(PackedTrajectory);
+        for (const std::vector<float> &block : blocks) {
+            total += sizeof(block) + block.capacity() * sizeof(float);
+        }
+        for (const std::unique_ptr<std::string> &name : names) {
+            total += sizeof(std::string) + name->capacity();
+        }
+        return total;
+    }
+
+    private:
+    std::vector<PackedTrajectory> trajectories;
+    std::vector<std::vector<float>> blocks;
+    std::vector<std::unique_ptr<std::string>> names;
+};
+
+struct PathLimits {
+    double max_velocity = 1.0;      // m/s
+    double max_acceleration = 2.0;  // m/s^2
+    double dt = 0.01;               // s between segments
+};
+
+/*
+    A quintic Hermite spline from one waypoint to the next, leaving and
+    arriving along the waypoints' headings with no curvature at either end,
+    like Pathfinder's FIT_HERMITE_QUINTIC. The tangents are as long as the
+    gap between the waypoints.
+*/
+struct HermiteSpline {
+    double x0, y0, dx0, dy0;
+    double x1, y1, dx1, dy1;
+
+    HermiteSpline(const Waypoint &a, const Waypoint &b) {
+        double d = std::hypot(b.x - a.x, b.y - a.y);
+        x0 = a.x;
+        y0 = a.y;
+        dx0 = d * std::cos(a.angle);
+        dy0 = d * std::sin(a.angle);
+        x1 = b.x;
+        y1 = b.y;
+        dx1 = d * std::cos(b.angle);
+        dy1 = d * std::sin(b.angle);
+    }
+
+    void point(double t, double &x, double &y) const {
+        double t3 = t * t * t, t4 = t3 * t, t5 = t4 * t;
+        double h0 = 1 - 10 * t3 + 15 * t4 - 6 * t5;
+        double h1 = t - 6 * t3 + 8 * t4 - 3 * t5;
+        double h4 = -4 * t3 + 7 * t4 - 3 * t5;
+        double h5 = 10 * t3 - 15 * t4 + 6 * t5;
+        x = h0 * x0 + h1 * dx0 + h4 * dx1 + h5 * x1;
+        y = h0 * y0 + h1 * dy0 + h4 * dy1 + h5 * y1;
+    }
+
+    void derivative(double t, double &dx, double &dy) const {
+        double t2 = t * t, t3 = t2 * t, t4 = t3 * t;
+        double h0 = -30 * t2 + 60 * t3 - 30 * t4;
+        double h1 = 1 - 18 * t2 + 32 * t3 - 15 * t4;
+        double h4 = -12 * t2 + 28 * t3 - 15 * t4;
+        double h5 = 30 * t2 - 60 * t3 + 30 * t4;
+        dx = h0 * x0 + h1 * dx0 + h4 * dx1 + h5 * x1;
+        dy = h0 * y0 + h1 * dy0 + h4 * dy1 + h5 * y1;
+    }
+
+    double speed(double t) const {
+        double dx, dy;
+        derivative(t, dx, dy);
+        return std::hypot(dx, dy);
+    }
+
+    // Arc length from t0 to t1, to within tolerance m
+    double length(double t0, double t1, double tolerance = 1e-9) const {
+        return adaptive_length(t0, t1, gauss_length(t0, t1), tolerance, 12);
+    }
+
+    // Five point Gauss-Legendre over [t0, t1], which would be exact if the speed were a polynomial up to degree 9
+    double gauss_length(double t0, double t1) const {
+        static const double nodes[] = {0, 0.5384693101056831, -0.5384693101056831, 0.9061798459386640, -0.9061798459386640};
+        static const double weights[] = {0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891};
+        double mid = (t0 + t1) / 2, half = (t1 - t0) / 2;
+        double sum = 0;
+        for (int i = 0; i < 5; i++) {
+            sum += weights[i] * speed(mid + half * nodes[i]);
+        }
+        return sum * half;
+    }
+
+    private:
+    // Splits the interval until its halves agree with the whole, which only takes long near a cusp
+    double adaptive_length(double t0, double t1, double whole, double tolerance, int depth) const {
+        double mid = (t0 + t1) / 2;
+        double left = gauss_length(t0, mid);
+        double right = gauss_length(mid, t1);
+        if (depth == 0 || std::abs(left + right - whole) < tolerance) {
+            return left + right;
+        }
+        return adaptive_length(t0, mid, left, tolerance / 2, depth - 1) + adaptive_length(mid, t1, right, tolerance / 2, depth - 1);
+    }
+};
+
+/*
+    The splines through the waypoints, and a lookup table from arc length
+    to spline parameter so a distance along the path maps back to a point.
+
+    Pathfinder finds the length by summing thousands of samples per spline,
+    and has to sample again for every distance it looks up. Here each spline
+    is split into knots equal steps of its parameter, and Gauss-Legendre
+    quadrature gives the arc length at each; the lengths only grow, so a
+    binary search finds the step a distance is in. Newton's method then
+    solves for the parameter inside that step, with one more quadrature over
+    the part of the step it covers each iteration. The lengths come out
+    within about a nanometre with a few hundred evaluations of the speed per
+    spline instead of thousands.
+*/
+class SplinePath {
+    public:
+    explicit SplinePath(const std::vector<Waypoint> &waypoints, int knots_ = 16) {
+        knots = knots_;
+        for (size_t i = 0; i + 1 < waypoints.size(); i++) {
+            splines.emplace_back(waypoints[i], waypoints[i + 1]);
+        }
+        lengths.push_back(0);
+        for (const HermiteSpline &spline : splines) {
+            for (int k = 1; k <= knots; k++) {
+                lengths.push_back(lengths.back() + spline.length((double) (k - 1) / knots, (double) k / knots));
+            }
+        }
+    }
+
+    double length() const {
+        return lengths.back();
+    }
+
+    // The point at distance s along the path and the heading there
+    void at(double s, double &x, double &y, double &heading) const {
+        s = std::max(0.0, std::min(s, length()));
+        size_t k = std::upper_bound(lengths.begin(), lengths.end(), s) - lengths.begin();
+        k = std::max<size_t>(1, std::min(k, lengths.size() - 1));
+        size_t which = (k - 1) / knots;
+        const HermiteSpline &spline = splines[which];
+        double t0 = (double) ((k - 1) % knots) / knots;
+        double t1 = t0 + 1.0 / knots;
+        double want = s - lengths[k - 1];
+
+        double span = lengths[k] - lengths[k - 1];
+        double t = span > 0 ? t0 + want / span / knots : t0;
+        for (int i = 0; i < 8; i++) {
+            double error = spline.gauss_length(t0, t) - want;
+            double speed = spline.speed(t);
+            if (std::abs(error) < 1e-10 || speed < 1e-12) {
+                break;
+            }
+            t = std::max(t0, std::min(t1, t - error / speed));
+        }
+
+        double dx, dy;
+        spline.point(t, x, y);
+        spline.derivative(t, dx, dy);
+        heading = std::atan2(dy, dx);
+    }
+
+    private:
+    std::vector<HermiteSpline> splines;
+    std::vector<double> lengths; // arc length at every 1/knots of each spline, back to back
+    int knots;
+};
+
+/*
+    Drives a path on a trapezoidal speed profile that starts and ends at
+    rest, one Segment every limits.dt. Path is anything with length() and
+    at() like SplinePath.
+*/
+template <typename Path>
+std::vector<Segment> profile_path(const Path &path, const PathLimits &limits)
+{
+    std::vector<Segment> out;
+    double length = path.length();
+    double v = limits.max_velocity;
+    double a = limits.max_acceleration;
+    if (v * v / a > length) {
+        v = std::sqrt(length * a); // never gets to cruise
+    }
+    double ramp = v / a;
+    double cruise = (length - v * ramp) / v;
+    double total = 2 * ramp + cruise;
+
+    int count = (int) std::ceil(total / limits.dt) + 1;
+    double last_acceleration = 0;
+    for (int i = 0; i < count; i++) {
+        double t = std::min(i * limits.dt, total);
+        Segment seg;
+        seg.dt = limits.dt;
+        if (t < ramp) {
+            seg.acceleration = a;
+            seg.velocity = a * t;
+            seg.position = a * t * t / 2;
+        }
+        else if (t < ramp + cruise) {
+            seg.acceleration = 0;
+            seg.velocity = v;
+            seg.position = v * ramp / 2 + v * (t - ramp);
+        }
+        else {
+            double left = total - t;
+            seg.acceleration = -a;
+            seg.velocity = a * left;
+            seg.position = length - a * left * left / 2;
+        }
+        seg.jerk = (seg.acceleration - last_acceleration) / limits.dt;
+        last_acceleration = seg.acceleration;
+        path.at(seg.position, seg.x, seg.y, seg.heading);
+        out.push_back(seg);
+    }
+    return out;
+}
+
+// The trajectory through the waypoints; empty for fewer than two
+inline std::vector<Segment> generate_trajectory(const std::vector<Waypoint> &waypoints, const PathLimits &limits)
+{
+    if (waypoints.size() < 2) {
+        return {};
+    }
+    return profile_path(SplinePath(waypoints), limits);
+}
+
+#endif
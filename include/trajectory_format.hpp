@@ -0,0 +1,265 @@
+#ifndef TRAJECTORY_FORMAT_HPP
+#define TRAJECTORY_FORMAT_HPP
+
+#include "trajectory.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+
+/*
+    Trajectory files on the SD card. Shared by the robot code and
+    sim/tools/trajectory_gen.cpp, so it only uses the standard library.
+
+    A file is one TrajectoryFileHeader and then the PackedTrajectory's
+    arrays, x, y, heading and velocity, each length floats back to back,
+    little endian as the brain writes them. A whole array is one fread, and
+    a run of points in the middle is one fseek and fread per array.
+    header_crc covers the header up to it and data_crc the four arrays, both
+    CRC-32 as zlib computes it. Bump TRAJECTORY_FILE_VERSION whenever the
+    layout changes.
+*/
+
+#define TRAJECTORY_FILE_MAGIC "SKTJ"
+#define TRAJECTORY_FILE_VERSION 1
+#define TRAJECTORY_FILE_ARRAYS 4
+
+struct TrajectoryFileHeader {
+    char magic[4];        // TRAJECTORY_FILE_MAGIC
+    uint16_t version;     // TRAJECTORY_FILE_VERSION
+    uint16_t header_size; // sizeof(TrajectoryFileHeader)
+    uint32_t length;      // points in each array
+    float dt;             // s between points
+    char name[32];        // nul terminated
+    uint32_t data_crc;    // CRC-32 of the arrays
+    uint32_t header_crc;  // CRC-32 of everything above
+};
+
+static_assert(sizeof(TrajectoryFileHeader) == 56, "trajectory file header layout changed, bump TRAJECTORY_FILE_VERSION");
+
+// CRC-32 (reflected 0xEDB88320) continued over size more bytes; start from 0
+inline uint32_t crc32_update(uint32_t crc, const void *data, size_t size)
+{
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t;
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    const uint8_t *bytes = (const uint8_t *) data;
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+inline uint32_t trajectory_header_crc(const TrajectoryFileHeader &header)
+{
+    return crc32_update(0, &header, offsetof(TrajectoryFileHeader, header_crc));
+}
+
+// CRC-32 of t's arrays as a file of it would carry in data_crc
+inline uint32_t trajectory_data_crc(const PackedTrajectory &t)
+{
+    uint32_t crc = 0;
+    for (const float *array : {t.x, t.y, t.heading, t.velocity}) {
+        crc = crc32_update(crc, array, t.length * sizeof(float));
+    }
+    return crc;
+}
+
+inline bool write_trajectory_file(const char *path, const PackedTrajectory &t)
+{
+    TrajectoryFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRAJECTORY_FILE_MAGIC, 4);
+    header.version = TRAJECTORY_FILE_VERSION;
+    header.header_size = sizeof(header);
+    header.length = t.length;
+    header.dt = t.dt;
+    snprintf(header.name, sizeof(header.name), "%s", t.name);
+    header.data_crc = trajectory_data_crc(t);
+    header.header_crc = trajectory_header_crc(header);
+
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (const float *array : {t.x, t.y, t.heading, t.velocity}) {
+        ok = ok && fwrite(array, sizeof(float), t.length, file) == t.length;
+    }
+    return fclose(file) == 0 && ok;
+}
+
+// Reads and checks the header; leaves file at the first array
+inline bool read_trajectory_header(FILE *file, TrajectoryFileHeader &header)
+{
+    return fread(&header, sizeof(header), 1, file) == 1 &&
+           memcmp(header.magic, TRAJECTORY_FILE_MAGIC, 4) == 0 &&
+           header.version == TRAJECTORY_FILE_VERSION &&
+           header.header_size == sizeof(header) &&
+           header.header_crc == trajectory_header_crc(header) &&
+           header.dt > 0 && header.name[sizeof(header.name) - 1] == '\0';
+}
+
+/*
+    Loads a whole trajectory file into store, one fread per array, and sets
+    id to it. False, with nothing added, if the file is missing, isn't a
+    trajectory file of this version, or fails either CRC.
+*/
+inline bool load_trajectory_file(const char *path, TrajectoryStore &store, uint16_t &id)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    TrajectoryFileHeader header;
+    bool ok = read_trajectory_header(file, header);
+    std::vector<float> block;
+    if (ok) {
+        block.resize((size_t) TRAJECTORY_FILE_ARRAYS * header.length);
+        uint32_t crc = 0;
+        for (int a = 0; ok && a < TRAJECTORY_FILE_ARRAYS; a++) {
+            float *array = block.data() + (size_t) a * header.length;
+            ok = fread(array, sizeof(float), header.length, file) == header.length;
+            crc = crc32_update(crc, array, header.length * sizeof(float));
+        }
+        ok = ok && crc == header.data_crc;
+    }
+    fclose(file);
+    if (ok) {
+        id = store.add(header.name, header.dt, std::move(block));
+    }
+    return ok;
+}
+
+/*
+    A trajectory file read a chunk at a time, for paths too long to keep in
+    RAM. open() reads the file through once in chunks to check the CRC,
+    the whole file off the card, so open one while disabled rather than
+    when the path is due, and pass a cancelled() that lets the match start
+    stop it between chunks; after that point() only goes to the card when asked for a point outside
+    the chunk it has, and then reads the chunk from a quarter of a chunk
+    before that point on, so a follower reading a little ahead of where it
+    is, and once in a while looking back, stays inside one chunk.
+    follow_trajectory() takes one in place of a PackedTrajectory.
+*/
+class TrajectoryStream {
+    public:
+    char name[32] = "";
+    float dt = 0.01f;
+    uint32_t length = 0;
+    uint32_t data_crc = 0; // the file's, once open() has checked it
+    uint32_t loads = 0;    // chunks read since open()
+
+    explicit TrajectoryStream(uint32_t chunk_ = 64) {
+        chunk = chunk_;
+        buffer.resize((size_t) TRAJECTORY_FILE_ARRAYS * chunk);
+    }
+
+    TrajectoryStream(const TrajectoryStream &) = delete;
+    TrajectoryStream &operator=(const TrajectoryStream &) = delete;
+
+    ~TrajectoryStream() {
+        close();
+    }
+
+    // False if the file is missing or bad, or if cancelled() came true between chunks
+    bool open(const char *path, std::function<bool()> cancelled = nullptr) {
+        close();
+        file = fopen(path, "rb");
+        TrajectoryFileHeader header;
+        if (file == nullptr || !read_trajectory_header(file, header)) {
+            close();
+            return false;
+        }
+        length = header.length;
+        dt = header.dt;
+        memcpy(name, header.name, sizeof(name));
+        uint32_t crc = 0;
+        size_t left = (size_t) TRAJECTORY_FILE_ARRAYS * length;
+        while (left > 0) {
+            size_t n = std::min(left, buffer.size());
+            if ((cancelled && cancelled()) || fread(buffer.data(), sizeof(float), n, file) != n) {
+                close();
+                return false;
+            }
+            crc = crc32_update(crc, buffer.data(), n * sizeof(float));
+            left -= n;
+        }
+        if (crc != header.data_crc) {
+            close();
+            return false;
+        }
+        data_crc = crc;
+        base = count = loads = 0;
+        return true;
+    }
+
+    void close() {
+        if (file != nullptr) {
+            fclose(file);
+            file = nullptr;
+        }
+        length = 0;
+    }
+
+    // Point i, or false if the card couldn't be read
+    bool point(uint32_t i, float &x, float &y, float &heading, float &velocity) {
+        if ((i < base || i >= base + count) && !load(i)) {
+            return false;
+        }
+        uint32_t k = i - base;
+        x = buffer[k];
+        y = buffer[chunk + k];
+        heading = buffer[2 * chunk + k];
+        velocity = buffer[3 * chunk + k];
+        return true;
+    }
+
+    // rad/s clockwise from point i to the next; 0 at the last point
+    double turn_rate(uint32_t i) {
+        float x, y, h0, h1, v;
+        if (i + 1 >= length || !point(i, x, y, h0, v) || !point(i + 1, x, y, h1, v)) {
+            return 0;
+        }
+        return std::remainder((double) h1 - h0, 2 * M_PI) / dt;
+    }
+
+    private:
+    FILE *file = nullptr;
+    uint32_t chunk;
+    std::vector<float> buffer; // chunk points of each array, one after the other
+    uint32_t base = 0;  // first point in the buffer
+    uint32_t count = 0; // points in the buffer
+
+    bool load(uint32_t i) {
+        if (file == nullptr || i >= length) {
+            return false;
+        }
+        base = i > chunk / 4 ? i - chunk / 4 : 0;
+        count = std::min(chunk, length - base);
+        for (int a = 0; a < TRAJECTORY_FILE_ARRAYS; a++) {
+            long offset = sizeof(TrajectoryFileHeader) + ((long) a * length + base) * sizeof(float);
+            if (fseek(file, offset, SEEK_SET) != 0 ||
+                fread(buffer.data() + (size_t) a * chunk, sizeof(float), count, file) != count) {
+                count = 0;
+                return false;
+            }
+        }
+        loads++;
+        return true;
+    }
+};
+
+#endif
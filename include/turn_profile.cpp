@@ -0,0 +1,233 @@
+#ifndef MAIN_H
+#define MAIN_H
+#include "main.h"
+#endif
+#ifndef OKAPI_H
+#define OKAPI_H
+#include "okapi/api.hpp"
+#endif
+#ifndef SENSORS_CPP
+#define SENSORS_CPP
+#include "sensors.cpp"
+#endif
+
+#include <cmath>
+
+/*
+    Constants for a profiled turn. Voltages are in mV per drive side, rates in
+    deg/s and deg/s^2 of IMU rotation, positive clockwise like get_rotation().
+
+        volts = kS*sign(v) + kV*v + kA*a + kP*(angle error) + kD*(rate error)
+
+    kS, kV and kA should come from measure_turn_gains() on the real robot;
+    the defaults are only a starting point.
+*/
+struct TurnGains {
+    double kS = 600;
+    double kV = 22;
+    double kA = 2.5;
+    double kP = 120;
+    double kD = 8;
+
+    double max_velocity = 360;      // deg/s
+    double max_acceleration = 1500; // deg/s^2
+
+    double tolerance = 1.5;         // deg
+    double rate_tolerance = 10;     // deg/s
+    double rate_sign = 1;           // flips gyro z into the rotation sense
+
+    // Profile limits that leave a fifth of the battery for the feedback terms
+    void fit_limits(double volts = 12000) {
+        double usable = 0.8 * volts - kS;
+        max_velocity = usable / kV;
+        max_acceleration = usable / 2 / kA;
+    }
+};
+
+// Where a trapezoidal profile wants the robot t seconds in
+struct ProfilePoint {
+    double position = 0;
+    double velocity = 0;
+    double acceleration = 0;
+};
+
+/*
+    Trapezoidal velocity profile over a signed distance: accelerate at the
+    limit, cruise, decelerate at the limit. Short moves that never reach the
+    cruise speed become a triangle.
+*/
+class TrapezoidProfile {
+    public:
+    TrapezoidProfile(double distance_, double max_velocity, double max_acceleration) {
+        distance = distance_;
+        sign = distance < 0 ? -1 : 1;
+        accel = max_acceleration;
+        double length = std::abs(distance);
+        if (length * accel > max_velocity * max_velocity) {
+            cruise = max_velocity;
+        }
+        else {
+            cruise = std::sqrt(length * accel);
+        }
+        ramp = cruise > 0 ? cruise / accel : 0;
+        coast = cruise > 0 ? length / cruise - ramp : 0;
+    }
+
+    double duration() const {
+        return 2 * ramp + coast;
+    }
+
+    ProfilePoint sample(double t) const {
+        ProfilePoint p;
+        if (t <= 0) {
+            return p;
+        }
+        if (t >= duration()) {
+            p.position = distance;
+            return p;
+        }
+        double ramp_length = 0.5 * accel * ramp * ramp;
+        if (t < ramp) {
+            p.position = 0.5 * accel * t * t;
+            p.velocity = accel * t;
+            p.acceleration = accel;
+        }
+        else if (t < ramp + coast) {
+            p.position = ramp_length + cruise * (t - ramp);
+            p.velocity = cruise;
+        }
+        else {
+            double left = duration() - t;
+            p.position = std::abs(distance) - 0.5 * accel * left * left;
+            p.velocity = accel * left;
+            p.acceleration = -accel;
+        }
+        p.position *= sign;
+        p.velocity *= sign;
+        p.acceleration *= sign;
+        return p;
+    }
+
+    private:
+    double distance;
+    double sign;
+    double accel;
+    double cruise;
+    double ramp;  // s spent accelerating, and again decelerating
+    double coast; // s at cruise speed
+};
+
+double turn_rate(const SensorSnapshot &s, const TurnGains &gains)
+{
+    return gains.rate_sign * s.gyro.z;
+}
+
+/*
+    Spins the robot in place to measure the turn feedforward. Needs about a
+    metre of clear floor around the robot and takes roughly eight seconds.
+
+    kS is the voltage where a slow ramp first gets the robot turning, kV a
+    least squares fit of steady turn rate against voltage over four steps,
+    and kA a fit of the leftover voltage against the acceleration right after
+    a step from rest. Also works out which way gyro z points. Prints the
+    result; copy it into the robot's TurnGains. Returns gains unchanged if
+    the IMU isn't calibrated within 3 s, or if the robot doesn't sit still
+    for 300 ms within 5 s of being told to stop between steps (a noisy gyro,
+    or a robot rocking on the platform edge).
+*/
+TurnGains measure_turn_gains(std::shared_ptr<okapi::MotorGroup> drive_lft, std::shared_ptr<okapi::MotorGroup> drive_rt, std::shared_ptr<SensorHub> sensors, TurnGains gains = TurnGains())
+{
+    if (!sensors->wait_for_imu(3000)) {
+        return gains;
+    }
+    const TurnGains given = gains;
+    uint32_t period = sensors->get_period();
+    auto spin = [&](double volts) {
+        drive_lft->moveVoltage(volts);
+        drive_rt->moveVoltage(-volts);
+    };
+    // false if the robot hasn't been still for 300 ms after 5 s; coasting
+    // down from the fastest step takes about 2.5 s
+    auto rest = [&]() {
+        spin(0);
+        uint32_t still = 0;
+        for (uint32_t waited = 0; still < 300; waited += period) {
+            if (waited >= 5000) {
+                printf("turn gains: the robot never came to rest, nothing measured\n");
+                return false;
+            }
+            pros::delay(period);
+            still = std::abs(sensors->latest().gyro.z) < 2 ? still + period : 0;
+        }
+        return true;
+    };
+
+    // kS: ramp 2.4 V/s until the robot starts to turn
+    if (!rest()) {
+        return given;
+    }
+    double volts = 0;
+    while (volts < 6000 && std::abs(sensors->latest().gyro.z) < 3) {
+        volts += 2.4 * period;
+        spin(volts);
+        pros::delay(period);
+    }
+    gains.kS = volts;
+
+    // kV: steady rate at each step, fit through the kS intercept
+    if (!rest()) {
+        return given;
+    }
+    double start_rotation = sensors->latest().rotation;
+    double sum_vv = 0, sum_rv = 0;
+    double z_sum = 0;
+    for (double step : {4000.0, 6000.0, 8000.0, 10000.0}) {
+        spin(step);
+        pros::delay(800);
+        double rate = 0;
+        int n = 0;
+        for (uint32_t t = 0; t < 200; t += period, n++) {
+            rate += sensors->latest().gyro.z;
+            pros::delay(period);
+        }
+        rate /= n;
+        z_sum += rate; // signed, so rate_sign sees which way gyro z points
+        rate = std::abs(rate);
+        sum_vv += rate * rate;
+        sum_rv += rate * (step - gains.kS);
+    }
+    gains.kV = sum_rv / sum_vv;
+    double turned = sensors->latest().rotation - start_rotation;
+    gains.rate_sign = (turned >= 0) == (z_sum >= 0) ? 1 : -1;
+
+    // kA: leftover voltage against acceleration for 250 ms after a step
+    if (!rest()) {
+        return given;
+    }
+    double step = 10000;
+    double sum_aa = 0, sum_ra = 0;
+    SensorSnapshot last = sensors->latest();
+    spin(step);
+    for (uint32_t t = 0; t < 250; t += period) {
+        pros::delay(period);
+        SensorSnapshot now = sensors->latest();
+        if (now.time == last.time) {
+            continue;
+        }
+        double rate = turn_rate(now, gains);
+        double accel = (rate - turn_rate(last, gains)) / ((now.time - last.time) / 1000.0);
+        double left = step - gains.kS - gains.kV * rate;
+        sum_aa += accel * accel;
+        sum_ra += accel * left;
+        last = now;
+    }
+    spin(0);
+    if (sum_aa > 0) {
+        gains.kA = sum_ra / sum_aa;
+    }
+    gains.fit_limits();
+
+    printf("turn gains: kS %.0f kV %.2f kA %.3f rate_sign %.0f -> %.0f deg/s, %.0f deg/s^2\n",
+           gains.kS, gains.kV, gains.kA, gains.rate_sign, gains.max_velocity, gains.max_acceleration);
+    return gains;
+}
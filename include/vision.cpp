@@ -6,6 +6,15 @@
 #define OKAPI_H
 #include "okapi/api.hpp"
 #endif
+#ifndef SEQLOCK_CPP
+#define SEQLOCK_CPP
+#include "seqlock.cpp"
+#endif
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 
 enum goal_color
 {
@@ -14,6 +23,12 @@ enum goal_color
     BLUE    
 };
 
+// Vision signature ids start at 1
+inline uint8_t goal_signature(goal_color c)
+{
+    return c + 1;
+}
+
 // int s;
 // float
 // char
@@ -38,36 +53,400 @@ enum goal_color
 
 
 
+static const char *GOAL_COLOR_NAMES[] = {"RED", "YELLOW", "BLUE"};
+
 class GoalCamera {
     public:
     std::shared_ptr<pros::Vision> vision_sensor;
+    pros::vision_signature_s_t signatures[3];
 
-    GoalCamera(int port) {
+    // Signatures come from table if it is there (see load_signatures), else the built in ones
+    GoalCamera(int port, const char *table = "/usd/vision_sigs.txt") {
         vision_sensor.reset(new pros::Vision(port, pros::E_VISION_ZERO_CENTER));
 
-        pros::vision_signature_s_t RED_SIG =
-            pros::Vision::signature_from_utility(RED, 10091, 11357, 10724, -2207, -1527, -1867, 3.000, 0);
-            //pros::Vision::signature_from_utility(RED, 8717, 11443, 10080, -2329, -1959, -2144, 3.000, 0);
+        signatures[RED] =
+            pros::Vision::signature_from_utility(goal_signature(RED), 10091, 11357, 10724, -2207, -1527, -1867, 3.000, 0);
+            //pros::Vision::signature_from_utility(goal_signature(RED), 8717, 11443, 10080, -2329, -1959, -2144, 3.000, 0);
+
+        signatures[YELLOW] =
+            pros::Vision::signature_from_utility(goal_signature(YELLOW), 3295, 5517, 4406, -4699, -4415, -4557, 3.000, 0);
+
+        signatures[BLUE] =
+            pros::Vision::signature_from_utility(goal_signature(BLUE), -1921, -1195, -1558, 5113, 7113, 6113, 3.000, 0);
+
+        load_signatures(table);
+        for (int c = RED; c <= BLUE; c++) {
+            vision_sensor->set_signature(goal_signature((goal_color) c), &signatures[c]);
+        }
+    }
 
-        pros::vision_signature_s_t YELLOW_SIG =
-            pros::Vision::signature_from_utility(YELLOW, 3295, 5517, 4406, -4699, -4415, -4557, 3.000, 0);
+    /*
+        Reads a signature table written by the vision_calibrate host tool,
+        one color per line:
 
-        pros::vision_signature_s_t BLUE_SIG =
-            pros::Vision::signature_from_utility(BLUE, -1921, -1195, -1558, 5113, 7113, 6113, 3.000, 0);
+            # color u_min u_max u_mean v_min v_max v_mean range
+            RED 10091 11357 10724 -2207 -1527 -1867 3.0
 
-        vision_sensor->set_signature(RED, &RED_SIG);
-        vision_sensor->set_signature(YELLOW, &YELLOW_SIG);
-        vision_sensor->set_signature(BLUE, &BLUE_SIG);
+        Colors missing from the table keep their built in signature. Returns
+        how many colors were loaded.
+    */
+    int load_signatures(const char *path) {
+        FILE *file = fopen(path, "r");
+        if (file == NULL) {
+            return 0;
+        }
+        int loaded = 0;
+        char line[128];
+        while (fgets(line, sizeof(line), file)) {
+            char name[16];
+            int u_min, u_max, u_mean, v_min, v_max, v_mean;
+            float range;
+            if (line[0] == '#' || sscanf(line, "%15s %d %d %d %d %d %d %f", name, &u_min, &u_max, &u_mean, &v_min, &v_max, &v_mean, &range) != 8) {
+                continue;
+            }
+            for (int c = RED; c <= BLUE; c++) {
+                if (strcmp(name, GOAL_COLOR_NAMES[c]) == 0) {
+                    signatures[c] = pros::Vision::signature_from_utility(goal_signature((goal_color) c), u_min, u_max, u_mean, v_min, v_max, v_mean, range, 0);
+                    loaded++;
+                }
+            }
+        }
+        fclose(file);
+        return loaded;
     }
 
     //Recieving object by doing 
     //int x, y
     //tie(x, y) = sensor.get_by_sig(RED)
     std::tuple<int, int> get_by_sig(goal_color c) {
-        pros::vision_object_s_t object = vision_sensor->get_by_sig(0, c);
+        pros::vision_object_s_t object = vision_sensor->get_by_sig(0, goal_signature(c));
 
         double x = object.x_middle_coord;
         double y = object.y_middle_coord;
         return std::make_tuple(x, y);
     }
+
+    // Every object of every signature, biggest first, in one read
+    int read_all(pros::vision_object_s_t *objects, int max) {
+        int count = vision_sensor->read_by_size(0, max, objects);
+        return count == PROS_ERR ? 0 : count;
+    }
+};
+
+/*
+    Records what the sensor sees of each color through a sweep of U and V
+    windows around its current signature, for the vision_calibrate host tool.
+
+    label says what is really in front of the camera: a color name, or NONE
+    for a view with no goal in it. Record each goal color in the lighting
+    you care about, plus a few NONE views of the field around it. Every line
+    appended to path is one window:
+
+        label,color,axis,u_min,u_max,v_min,v_max,found,width,height
+
+    where axis is the one being swept (U or V, the other stays at the current
+    signature). Each window is held for three camera frames. Takes about
+    7 s and leaves the signatures as they were. Anything else reading the
+    camera meanwhile, like a GoalTracker, sees the sweep too.
+*/
+bool record_signature_sweep(std::shared_ptr<GoalCamera> camera, const char *label, const char *path = "/usd/vision_rec.csv")
+{
+    FILE *file = fopen(path, "a");
+    if (file == NULL) {
+        return false;
+    }
+    const double shifts[] = {-1, -0.5, 0, 0.5, 1};  // of the half width
+    const double widths[] = {0.5, 1, 1.5, 2};       // times the half width
+
+    for (int c = RED; c <= BLUE; c++) {
+        const pros::vision_signature_s_t base = camera->signatures[c];
+        for (int axis = 0; axis < 2; axis++) {
+            double lo = axis == 0 ? base.u_min : base.v_min;
+            double hi = axis == 0 ? base.u_max : base.v_max;
+            double mid = (lo + hi) / 2;
+            double half = (hi - lo) / 2;
+            for (double shift : shifts) {
+                for (double width : widths) {
+                    int32_t w_min = mid + shift * half - width * half;
+                    int32_t w_max = mid + shift * half + width * half;
+                    int32_t u_min = axis == 0 ? w_min : base.u_min;
+                    int32_t u_max = axis == 0 ? w_max : base.u_max;
+                    int32_t v_min = axis == 1 ? w_min : base.v_min;
+                    int32_t v_max = axis == 1 ? w_max : base.v_max;
+                    pros::vision_signature_s_t sig = pros::Vision::signature_from_utility(
+                        goal_signature((goal_color) c), u_min, u_max, (u_min + u_max) / 2, v_min, v_max, (v_min + v_max) / 2, base.range, 0);
+                    camera->vision_sensor->set_signature(goal_signature((goal_color) c), &sig);
+
+                    for (int frame = 0; frame < 3; frame++) {
+                        pros::delay(20);
+                        pros::vision_object_s_t object = camera->vision_sensor->get_by_sig(0, goal_signature((goal_color) c));
+                        bool found = object.signature == goal_signature((goal_color) c);
+                        fprintf(file, "%s,%s,%c,%ld,%ld,%ld,%ld,%d,%d,%d\n", label, GOAL_COLOR_NAMES[c], axis == 0 ? 'U' : 'V',
+                                (long) u_min, (long) u_max, (long) v_min, (long) v_max,
+                                found ? 1 : 0, found ? object.width : 0, found ? object.height : 0);
+                    }
+                }
+            }
+        }
+        camera->vision_sensor->set_signature(goal_signature((goal_color) c), &camera->signatures[c]);
+    }
+    fclose(file);
+    return true;
+}
+
+// A goal the tracker has followed across frames
+struct TrackedGoal {
+    uint32_t id = 0;
+    goal_color color = RED;
+    double x = 0;   // px from the centre of the view, filtered
+    double y = 0;
+    double vx = 0;  // px/s
+    double vy = 0;
+    double width = 0;
+    double confidence = 0; // 0-1, rises with each frame it is seen in
+    uint32_t age = 0;      // ms since it was first seen
+    uint32_t unseen = 0;   // ms since it was last seen
+};
+
+// Everything the tracker knows after one camera frame
+struct VisionFrame {
+    static const int MAX_GOALS = 8;
+    uint32_t time = 0;
+    uint32_t frame = 0;
+    int count = 0;
+    TrackedGoal goals[MAX_GOALS];
+
+    // The most confident goal of a color, or nullptr
+    const TrackedGoal *best(goal_color c, double min_confidence = 0.5) const {
+        const TrackedGoal *found = nullptr;
+        for (int i = 0; i < count; i++) {
+            const TrackedGoal &g = goals[i];
+            if (g.color == c && g.confidence >= min_confidence && (!found || g.confidence * g.width > found->confidence * found->width)) {
+                found = &g;
+            }
+        }
+        return found;
+    }
+};
+
+/*
+    Follows goals across camera frames.
+
+    A task reads every signature in one read_by_size call per camera frame
+    (the sensor only has a new picture every 20 ms) and skips frames that
+    come back identical to the last one. Each blob is matched to the nearest
+    predicted track of its color inside a gate; each track runs a constant
+    velocity Kalman filter per axis, so aiming sees a smooth position and a
+    velocity instead of raw pixel centres. Unmatched blobs start new tracks,
+    and tracks that go unseen lose confidence until they are dropped.
+
+    latest() hands out the newest VisionFrame through a Seqlock, like
+    SensorHub does.
+*/
+class GoalTracker {
+    public:
+    double gate = 40;            // px a blob may be from a track's prediction
+    double measurement_var = 16; // px^2 of pixel noise on a blob centre
+    double accel_var = 40000;    // (px/s^2)^2 the goals may appear to accelerate
+    uint32_t drop_after = 200;   // ms unseen before a track is dropped
+
+    GoalTracker(std::shared_ptr<GoalCamera> camera_, uint32_t period_ = 20) {
+        camera = camera_;
+        period = period_;
+    }
+
+    void start() {
+        if (reader) {
+            return;
+        }
+        reader.reset(new pros::Task([this] { run(); }, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "Goal Tracker"));
+    }
+
+    VisionFrame latest() const {
+        return published.read();
+    }
+
+    uint32_t get_period() const {
+        return period;
+    }
+
+    private:
+    static const int MAX_BLOBS = 16;
+
+    // Constant velocity Kalman filter along one image axis
+    struct Axis {
+        double p = 0, v = 0;
+        double P00 = 0, P01 = 0, P11 = 0;
+
+        void reset(double z, double var) {
+            p = z;
+            v = 0;
+            P00 = var;
+            P01 = 0;
+            P11 = 1e6;
+        }
+
+        void predict(double dt, double q) {
+            p += v * dt;
+            P00 += dt * (2 * P01 + dt * P11) + q * dt * dt * dt / 3;
+            P01 += dt * P11 + q * dt * dt / 2;
+            P11 += q * dt;
+        }
+
+        void correct(double z, double r) {
+            double s = P00 + r;
+            double k0 = P00 / s;
+            double k1 = P01 / s;
+            double innovation = z - p;
+            p += k0 * innovation;
+            v += k1 * innovation;
+            P11 -= k1 * P01;
+            P01 -= k0 * P01;
+            P00 -= k0 * P00;
+        }
+    };
+
+    struct Track {
+        TrackedGoal goal;
+        Axis x, y;
+        uint32_t born = 0;
+        uint32_t seen = 0;
+        bool matched = false; // in the last distinct frame
+    };
+
+    std::shared_ptr<GoalCamera> camera;
+    uint32_t period;
+    std::shared_ptr<pros::Task> reader;
+    Seqlock<VisionFrame> published;
+
+    Track tracks[VisionFrame::MAX_GOALS];
+    int track_count = 0;
+    uint32_t next_id = 1;
+    uint32_t frames = 0;
+    uint32_t last_time = 0;
+    pros::vision_object_s_t last_blobs[MAX_BLOBS];
+    int last_count = -1;
+
+    void run() {
+        uint32_t now = pros::millis();
+        last_time = now;
+        while (true) {
+            step();
+            pros::Task::delay_until(&now, period);
+        }
+    }
+
+    void step() {
+        pros::vision_object_s_t blobs[MAX_BLOBS];
+        int count = camera->read_all(blobs, MAX_BLOBS);
+        uint32_t time = pros::millis();
+        double dt = (time - last_time) / 1000.0;
+        last_time = time;
+
+        bool repeat = count > 0 && count == last_count && memcmp(blobs, last_blobs, count * sizeof(blobs[0])) == 0;
+        memcpy(last_blobs, blobs, sizeof(blobs));
+        last_count = count;
+
+        for (int i = 0; i < track_count; i++) {
+            tracks[i].x.predict(dt, accel_var);
+            tracks[i].y.predict(dt, accel_var);
+        }
+        if (repeat) {
+            // same picture as last time: the goals are still there, but
+            // there is nothing new to correct the filters with
+            for (int i = 0; i < track_count; i++) {
+                if (tracks[i].matched) {
+                    tracks[i].seen = time;
+                    tracks[i].goal.confidence += 0.25 * (1 - tracks[i].goal.confidence);
+                }
+            }
+        }
+        else {
+            associate(blobs, count, time);
+        }
+        age(time);
+        publish(time);
+    }
+
+    void associate(const pros::vision_object_s_t *blobs, int count, uint32_t time) {
+        bool taken[VisionFrame::MAX_GOALS] = {false};
+        for (int b = 0; b < count; b++) {
+            const pros::vision_object_s_t &blob = blobs[b];
+            if (blob.signature < 1 || blob.signature > BLUE + 1) {
+                continue;
+            }
+            goal_color color = (goal_color) (blob.signature - 1);
+
+            // blobs come biggest first, so the closest goals claim tracks first
+            int match = -1;
+            double closest = 0;
+            for (int t = 0; t < track_count; t++) {
+                if (taken[t] || tracks[t].goal.color != color) {
+                    continue;
+                }
+                double d = std::hypot(blob.x_middle_coord - tracks[t].x.p, blob.y_middle_coord - tracks[t].y.p);
+                if (d <= gate + blob.width / 2.0 && (match < 0 || d < closest)) {
+                    match = t;
+                    closest = d;
+                }
+            }
+
+            if (match < 0) {
+                if (track_count == VisionFrame::MAX_GOALS) {
+                    continue;
+                }
+                match = track_count++;
+                Track &fresh = tracks[match];
+                fresh = Track();
+                fresh.goal.id = next_id++;
+                fresh.goal.color = color;
+                fresh.born = time;
+                fresh.x.reset(blob.x_middle_coord, measurement_var);
+                fresh.y.reset(blob.y_middle_coord, measurement_var);
+            }
+            else {
+                tracks[match].x.correct(blob.x_middle_coord, measurement_var);
+                tracks[match].y.correct(blob.y_middle_coord, measurement_var);
+            }
+            Track &t = tracks[match];
+            taken[match] = true;
+            t.seen = time;
+            t.goal.width = blob.width;
+            t.goal.confidence += 0.25 * (1 - t.goal.confidence);
+        }
+        for (int t = 0; t < track_count; t++) {
+            tracks[t].matched = taken[t];
+            if (!taken[t]) {
+                tracks[t].goal.confidence *= 0.8;
+            }
+        }
+    }
+
+    void age(uint32_t time) {
+        int kept = 0;
+        for (int i = 0; i < track_count; i++) {
+            Track &t = tracks[i];
+            t.goal.age = time - t.born;
+            t.goal.unseen = time - t.seen;
+            t.goal.x = t.x.p;
+            t.goal.y = t.y.p;
+            t.goal.vx = t.x.v;
+            t.goal.vy = t.y.v;
+            if (t.goal.unseen < drop_after) {
+                tracks[kept++] = t;
+            }
+        }
+        track_count = kept;
+    }
+
+    void publish(uint32_t time) {
+        VisionFrame next;
+        next.time = time;
+        next.frame = ++frames;
+        next.count = track_count;
+        for (int i = 0; i < track_count; i++) {
+            next.goals[i] = tracks[i].goal;
+        }
+        published.write(next);
+    }
 };
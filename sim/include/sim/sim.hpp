@@ -0,0 +1,120 @@
+#ifndef SKAR_SIM_HPP
+#define SKAR_SIM_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Host-side stand-ins for the V5 brain.
+ *
+ * The robot code (src/main.cpp and the SKAR_* files it pulls in) is compiled
+ * unchanged against the real PROS and OkapiLib headers. The sim provides the
+ * library side: a cooperative scheduler running on a virtual clock, the PROS
+ * device API backed by a small tank-drive physics model, and the parts of
+ * OkapiLib the robots use.
+ */
+namespace sim
+{
+
+// A point on the field in meters, heading in radians counter-clockwise from +x.
+struct Pose
+{
+	double x = 0;
+	double y = 0;
+	double theta = 0;
+};
+
+// A mobile goal, seen by the distance sensor and the vision sensor.
+// color matches goal_color in vision.cpp (RED, YELLOW, BLUE); the vision
+// sensor reports it as signature color + 1.
+struct Goal
+{
+	double x;
+	double y;
+	int color;
+	double radius = 0.165;
+};
+
+// A seesaw platform. The robot climbs it along axis (radians); the near
+// side is down until the robot's centre passes the pivot.
+struct Platform
+{
+	bool enabled = false;
+	double x = 0;
+	double y = 0;
+	double axis = 0;
+	double half_length = 0.6;
+	double half_width = 1.3;
+	double max_tilt = 25;  // degrees
+	double level_band = 0.05;  // meters either side of the pivot that count as level
+};
+
+// Master controller input from --driver, held from time until the next frame.
+struct DriverFrame
+{
+	std::uint32_t time;  // virtual ms
+	std::int32_t analog[4];  // pros::controller_analog_e_t order
+	std::uint32_t digital;  // bit per pros::controller_digital_e_t - DIGITAL_L1
+};
+
+struct Config
+{
+	int auton = 0;
+	bool opcontrol = false;
+	bool trace = false;
+	bool pits = false;  // no competition control connected
+	std::uint32_t imu_calibration = 2000;  // virtual ms an IMU reset takes to calibrate
+	std::uint32_t time_limit = 120000;  // virtual ms before the run is abandoned
+	std::uint32_t disabled = 0;  // virtual ms disabled between initialize() and the mode, in competition_initialize()
+	std::uint32_t auton_period = 0;  // virtual ms before the autonomous task is deleted and opcontrol() starts, 0 to let it finish
+	std::string usd;  // host folder standing in for the SD card, empty for no card
+	std::vector<DriverFrame> driver;  // sorted by time
+	Pose start;
+	std::vector<Goal> goals;
+	Platform platform;
+};
+
+Config& config();
+
+/* Kernel */
+
+// Registers the calling thread as the first task and starts the virtual clock.
+void kernel_start(const char* name);
+
+// Renames the calling task, like the PROS competition template does per mode.
+void set_task_name(const char* name);
+
+// Virtual milliseconds since kernel_start.
+std::uint32_t now();
+
+// Prints the run summary and terminates the process with the given code.
+[[noreturn]] void finish(int code, const char* why);
+
+/* World */
+
+struct DriveSide
+{
+	std::vector<int> ports;  // negative ports are mounted reversed
+};
+
+// Registered by the chassis builder so the physics model knows which motors
+// turn which side. ratio is okapi's motor:wheel ratio.
+void set_drive(const DriveSide& left, const DriveSide& right, double wheel_diameter, double wheel_track,
+               double ratio);
+
+// Advances the physics model by one millisecond.
+void world_step();
+
+Pose pose();
+double pitch();
+
+// Virtual ms a goal first came into the front claw, 0 if none has.
+std::uint32_t goal_contact();
+
+// Event log for --trace, prefixed with the virtual time.
+void trace(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+}  // namespace sim
+
+#endif
@@ -0,0 +1,30 @@
+#!/bin/sh
+# Runs each robot's match rush in the sim and checks that the front claw was
+# fired its lead ahead of the goal getting into it, to within TOLERANCE ms.
+# Each runs straight into autonomous and again after a second disabled, where
+# SKAR_2 settles the rush's goal filter before the match.
+#
+#   make -C sim check
+
+TOLERANCE=${TOLERANCE:-8}
+cd "$(dirname "$0")/.." || exit 1
+status=0
+for target in SKAR_1 SKAR_2; do
+	make -s TARGET=$target >/dev/null 2>&1 || { echo "$target: build failed"; status=1; continue; }
+	for disabled in 0 1000; do
+		bin/$target --auton 1 --disabled $disabled --limit $((disabled + 3000)) | awk -v target="$target, $disabled ms disabled" -v tolerance=$TOLERANCE '
+			/^approach: claw fired at/ { fired = $5; lead = $9 }
+			/^goal in the front claw at/ { contact = $7 }
+			END {
+				if (fired == "" || contact == "") {
+					printf "%s: claw fired %s, goal in the claw %s\n", target, fired == "" ? "never" : "yes", contact == "" ? "never" : "yes"
+					exit 1
+				}
+				took = contact - fired
+				off = took - lead
+				printf "%s: claw fired %d ms before the goal got there, lead %d ms (%+d ms)\n", target, took, lead, off
+				exit (off > tolerance || off < -tolerance)
+			}' || status=1
+	done
+done
+exit $status
@@ -0,0 +1,1184 @@
+#include "api.h"
+#include "world.hpp"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+/**
+ * PROS device API on top of the physics model.
+ *
+ * Only the calls the robots make are backed by the model; the C++ device
+ * classes forward to the C API the same way libpros does.
+ */
+
+namespace
+{
+
+sim::MotorState& motor(std::uint8_t port)
+{
+	return sim::world().motors[port];
+}
+
+double units_per_degree(const sim::MotorState& m)
+{
+	switch (m.units)
+	{
+		case pros::E_MOTOR_ENCODER_ROTATIONS:
+			return 1.0 / 360.0;
+		case pros::E_MOTOR_ENCODER_COUNTS:
+			return (m.gearset == pros::E_MOTOR_GEARSET_36 ? 1800 : m.gearset == pros::E_MOTOR_GEARSET_06 ? 300 : 900) /
+			       360.0;
+		default:
+			return 1.0;
+	}
+}
+
+double imu_rotation(std::uint8_t port)
+{
+	const sim::World& w = sim::world();
+	return -(w.robot.theta - sim::config().start.theta) * 180.0 / M_PI + w.imus[port].rotation_offset;
+}
+
+bool imu_calibrating(std::uint8_t port)
+{
+	return sim::now() < sim::world().imus[port].calibrated_at;
+}
+
+int adi_index(std::uint8_t port)
+{
+	if (port >= 'a' && port <= 'h')
+	{
+		return port - 'a';
+	}
+	if (port >= 'A' && port <= 'H')
+	{
+		return port - 'A';
+	}
+	return port - 1;
+}
+
+std::int32_t motor_tpr(int gearset)
+{
+	return gearset == pros::E_MOTOR_GEARSET_36 ? 1800 : gearset == pros::E_MOTOR_GEARSET_06 ? 300 : 900;
+}
+
+}  // namespace
+
+namespace pros
+{
+namespace c
+{
+
+/* Motors */
+
+int32_t motor_move(uint8_t port, int32_t voltage)
+{
+	return motor_move_voltage(port, voltage * 12000 / 127);
+}
+
+int32_t motor_move_absolute(uint8_t port, const double position, const int32_t velocity)
+{
+	sim::MotorState& m = motor(port);
+	m.mode = sim::MotorMode::ABSOLUTE;
+	m.target = position / units_per_degree(m) + m.zero;
+	m.command = velocity;
+	return 1;
+}
+
+int32_t motor_move_relative(uint8_t port, const double position, const int32_t velocity)
+{
+	sim::MotorState& m = motor(port);
+	double base = m.mode == sim::MotorMode::ABSOLUTE ? m.target : m.position;
+	m.mode = sim::MotorMode::ABSOLUTE;
+	m.target = base + position / units_per_degree(m);
+	m.command = velocity;
+	return 1;
+}
+
+int32_t motor_move_velocity(uint8_t port, const int32_t velocity)
+{
+	sim::MotorState& m = motor(port);
+	m.mode = sim::MotorMode::VELOCITY;
+	m.command = velocity;
+	return 1;
+}
+
+int32_t motor_move_voltage(uint8_t port, const int32_t voltage)
+{
+	sim::MotorState& m = motor(port);
+	m.mode = sim::MotorMode::VOLTAGE;
+	m.command = voltage;
+	return 1;
+}
+
+int32_t motor_modify_profiled_velocity(uint8_t port, const int32_t velocity)
+{
+	motor(port).command = velocity;
+	return 1;
+}
+
+double motor_get_target_position(uint8_t port)
+{
+	sim::MotorState& m = motor(port);
+	return (m.target - m.zero) * units_per_degree(m);
+}
+
+int32_t motor_get_target_velocity(uint8_t port)
+{
+	sim::MotorState& m = motor(port);
+	return m.mode == sim::MotorMode::VELOCITY ? m.command : 0;
+}
+
+double motor_get_actual_velocity(uint8_t port)
+{
+	return motor(port).velocity;
+}
+
+int32_t motor_get_current_draw(uint8_t port)
+{
+	return motor(port).current;
+}
+
+int32_t motor_get_direction(uint8_t port)
+{
+	return motor(port).velocity < 0 ? -1 : 1;
+}
+
+double motor_get_efficiency(uint8_t port)
+{
+	return 100.0 - motor(port).current / 25.0;
+}
+
+int32_t motor_is_over_current(uint8_t port)
+{
+	return motor(port).current >= 2500;
+}
+
+int32_t motor_is_over_temp(uint8_t port)
+{
+	(void)port;
+	return 0;
+}
+
+int32_t motor_is_stopped(uint8_t port)
+{
+	return std::abs(motor(port).velocity) < 0.5;
+}
+
+int32_t motor_get_zero_position_flag(uint8_t port)
+{
+	return motor(port).zero == 0;
+}
+
+uint32_t motor_get_faults(uint8_t port)
+{
+	(void)port;
+	return 0;
+}
+
+uint32_t motor_get_flags(uint8_t port)
+{
+	(void)port;
+	return 0;
+}
+
+int32_t motor_get_raw_position(uint8_t port, uint32_t* const timestamp)
+{
+	sim::MotorState& m = motor(port);
+	if (timestamp != nullptr)
+	{
+		*timestamp = sim::now();
+	}
+	return static_cast<int32_t>(m.position * motor_tpr(m.gearset) / 360.0);
+}
+
+double motor_get_position(uint8_t port)
+{
+	sim::MotorState& m = motor(port);
+	return (m.position - m.zero) * units_per_degree(m);
+}
+
+double motor_get_power(uint8_t port)
+{
+	sim::MotorState& m = motor(port);
+	return std::abs(m.voltage / 1000.0 * m.current / 1000.0);
+}
+
+double motor_get_temperature(uint8_t port)
+{
+	(void)port;
+	return 30;
+}
+
+double motor_get_torque(uint8_t port)
+{
+	return motor(port).current / 2500.0 * 2.1;
+}
+
+int32_t motor_get_voltage(uint8_t port)
+{
+	return motor(port).voltage;
+}
+
+int32_t motor_set_zero_position(uint8_t port, const double position)
+{
+	sim::MotorState& m = motor(port);
+	m.zero = m.position - position / units_per_degree(m);
+	return 1;
+}
+
+int32_t motor_tare_position(uint8_t port)
+{
+	sim::MotorState& m = motor(port);
+	m.zero = m.position;
+	return 1;
+}
+
+int32_t motor_set_brake_mode(uint8_t port, const motor_brake_mode_e_t mode)
+{
+	motor(port).brake = mode;
+	return 1;
+}
+
+int32_t motor_set_current_limit(uint8_t port, const int32_t limit)
+{
+	(void)port;
+	(void)limit;
+	return 1;
+}
+
+int32_t motor_set_encoder_units(uint8_t port, const motor_encoder_units_e_t units)
+{
+	motor(port).units = units;
+	return 1;
+}
+
+int32_t motor_set_gearing(uint8_t port, const motor_gearset_e_t gearset)
+{
+	motor(port).gearset = gearset;
+	return 1;
+}
+
+int32_t motor_set_reversed(uint8_t port, const bool reverse)
+{
+	(void)port;
+	(void)reverse;
+	return 1;
+}
+
+int32_t motor_set_voltage_limit(uint8_t port, const int32_t limit)
+{
+	(void)port;
+	(void)limit;
+	return 1;
+}
+
+motor_brake_mode_e_t motor_get_brake_mode(uint8_t port)
+{
+	return static_cast<motor_brake_mode_e_t>(motor(port).brake);
+}
+
+int32_t motor_get_current_limit(uint8_t port)
+{
+	(void)port;
+	return 2500;
+}
+
+motor_encoder_units_e_t motor_get_encoder_units(uint8_t port)
+{
+	return static_cast<motor_encoder_units_e_t>(motor(port).units);
+}
+
+motor_gearset_e_t motor_get_gearing(uint8_t port)
+{
+	return static_cast<motor_gearset_e_t>(motor(port).gearset);
+}
+
+int32_t motor_is_reversed(uint8_t port)
+{
+	(void)port;
+	return 0;
+}
+
+int32_t motor_get_voltage_limit(uint8_t port)
+{
+	(void)port;
+	return 0;
+}
+
+/* Inertial sensor */
+
+int32_t imu_reset(uint8_t port)
+{
+	sim::world().imus[port] = sim::ImuState();
+	sim::world().imus[port].calibrated_at = sim::now() + sim::config().imu_calibration;
+	sim::world().imus[port].rotation_offset = -imu_rotation(port);
+	return 1;
+}
+
+int32_t imu_set_data_rate(uint8_t port, uint32_t rate)
+{
+	(void)port;
+	(void)rate;
+	return 1;
+}
+
+double imu_get_rotation(uint8_t port)
+{
+	if (imu_calibrating(port))
+	{
+		errno = EAGAIN;
+		return PROS_ERR_F;
+	}
+	return imu_rotation(port);
+}
+
+double imu_get_heading(uint8_t port)
+{
+	double rotation = imu_get_rotation(port);
+	if (rotation == PROS_ERR_F)
+	{
+		return rotation;
+	}
+	double heading = std::fmod(rotation, 360.0);
+	return heading < 0 ? heading + 360.0 : heading;
+}
+
+double imu_get_pitch(uint8_t port)
+{
+	if (imu_calibrating(port))
+	{
+		errno = EAGAIN;
+		return PROS_ERR_F;
+	}
+	return sim::world().pitch + sim::world().imus[port].pitch_offset;
+}
+
+double imu_get_roll(uint8_t port)
+{
+	if (imu_calibrating(port))
+	{
+		errno = EAGAIN;
+		return PROS_ERR_F;
+	}
+	return sim::world().imus[port].roll_offset;
+}
+
+double imu_get_yaw(uint8_t port)
+{
+	double heading = imu_get_heading(port);
+	if (heading == PROS_ERR_F)
+	{
+		return heading;
+	}
+	return (heading > 180 ? heading - 360 : heading) + sim::world().imus[port].yaw_offset;
+}
+
+euler_s_t imu_get_euler(uint8_t port)
+{
+	return {imu_get_pitch(port), imu_get_roll(port), imu_get_yaw(port)};
+}
+
+quaternion_s_t imu_get_quaternion(uint8_t port)
+{
+	double yaw = imu_get_yaw(port) * M_PI / 180.0;
+	return {0, 0, std::sin(yaw / 2), std::cos(yaw / 2)};
+}
+
+imu_gyro_s_t imu_get_gyro_rate(uint8_t port)
+{
+	if (imu_calibrating(port))
+	{
+		errno = EAGAIN;
+		return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+	}
+	return {0, sim::world().pitch_rate, sim::world().yaw_rate};
+}
+
+imu_accel_s_t imu_get_accel(uint8_t port)
+{
+	(void)port;
+	return {0, 0, 1};
+}
+
+imu_status_e_t imu_get_status(uint8_t port)
+{
+	return imu_calibrating(port) ? E_IMU_STATUS_CALIBRATING : static_cast<imu_status_e_t>(0);
+}
+
+int32_t imu_set_rotation(uint8_t port, double target)
+{
+	sim::world().imus[port].rotation_offset += target - imu_rotation(port);
+	return 1;
+}
+
+int32_t imu_set_heading(uint8_t port, double target)
+{
+	return imu_set_rotation(port, imu_rotation(port) - imu_get_heading(port) + target);
+}
+
+int32_t imu_set_pitch(uint8_t port, double target)
+{
+	sim::world().imus[port].pitch_offset = target - sim::world().pitch;
+	return 1;
+}
+
+int32_t imu_set_roll(uint8_t port, double target)
+{
+	sim::world().imus[port].roll_offset = target;
+	return 1;
+}
+
+int32_t imu_set_yaw(uint8_t port, double target)
+{
+	sim::world().imus[port].yaw_offset += target - imu_get_yaw(port);
+	return 1;
+}
+
+int32_t imu_set_euler(uint8_t port, euler_s_t target)
+{
+	imu_set_pitch(port, target.pitch);
+	imu_set_roll(port, target.roll);
+	return imu_set_yaw(port, target.yaw);
+}
+
+int32_t imu_tare_rotation(uint8_t port)
+{
+	return imu_set_rotation(port, 0);
+}
+
+int32_t imu_tare_heading(uint8_t port)
+{
+	return imu_set_heading(port, 0);
+}
+
+int32_t imu_tare_pitch(uint8_t port)
+{
+	return imu_set_pitch(port, 0);
+}
+
+int32_t imu_tare_roll(uint8_t port)
+{
+	return imu_set_roll(port, 0);
+}
+
+int32_t imu_tare_yaw(uint8_t port)
+{
+	return imu_set_yaw(port, 0);
+}
+
+int32_t imu_tare_euler(uint8_t port)
+{
+	return imu_set_euler(port, {0, 0, 0});
+}
+
+int32_t imu_tare(uint8_t port)
+{
+	imu_tare_euler(port);
+	return imu_tare_rotation(port);
+}
+
+/* Distance sensor */
+
+int32_t distance_get(uint8_t port)
+{
+	(void)port;
+	return std::lround(sim::world().distance_mm);
+}
+
+int32_t distance_get_confidence(uint8_t port)
+{
+	(void)port;
+	double mm = sim::world().distance_mm;
+	return mm >= 9999 ? 0 : mm < 200 ? 63 : static_cast<int32_t>(63 - (mm - 200) / 40);
+}
+
+int32_t distance_get_object_size(uint8_t port)
+{
+	(void)port;
+	return sim::world().distance_mm >= 9999 ? -1 : 200;
+}
+
+double distance_get_object_velocity(uint8_t port)
+{
+	(void)port;
+	return sim::world().distance_rate;
+}
+
+/* ADI */
+
+int32_t adi_port_set_config(uint8_t port, adi_port_config_e_t type)
+{
+	(void)port;
+	(void)type;
+	return 1;
+}
+
+adi_port_config_e_t adi_port_get_config(uint8_t port)
+{
+	(void)port;
+	return E_ADI_DIGITAL_OUT;
+}
+
+int32_t adi_port_get_value(uint8_t port)
+{
+	return sim::world().adi[adi_index(port)];
+}
+
+int32_t adi_port_set_value(uint8_t port, int32_t value)
+{
+	std::int32_t& slot = sim::world().adi[adi_index(port)];
+	if (slot != value)
+	{
+		sim::trace("adi %c = %d", 'A' + adi_index(port), value);
+	}
+	slot = value;
+	return 1;
+}
+
+int32_t adi_digital_write(uint8_t port, bool value)
+{
+	return adi_port_set_value(port, value);
+}
+
+int32_t adi_digital_read(uint8_t port)
+{
+	return adi_port_get_value(port);
+}
+
+/* Controllers */
+
+int32_t controller_is_connected(controller_id_e_t id)
+{
+	(void)id;
+	return 1;
+}
+
+int32_t controller_get_analog(controller_id_e_t id, controller_analog_e_t channel)
+{
+	return sim::world().controllers[id].analog[channel];
+}
+
+int32_t controller_get_battery_capacity(controller_id_e_t id)
+{
+	(void)id;
+	return 100;
+}
+
+int32_t controller_get_battery_level(controller_id_e_t id)
+{
+	(void)id;
+	return 100;
+}
+
+int32_t controller_get_digital(controller_id_e_t id, controller_digital_e_t button)
+{
+	return (sim::world().controllers[id].digital >> (button - E_CONTROLLER_DIGITAL_L1)) & 1;
+}
+
+int32_t controller_get_digital_new_press(controller_id_e_t id, controller_digital_e_t button)
+{
+	sim::ControllerState& c = sim::world().controllers[id];
+	std::uint32_t bit = 1u << (button - E_CONTROLLER_DIGITAL_L1);
+	bool pressed = (c.digital & bit) && !(c.last_digital & bit);
+	c.last_digital = (c.last_digital & ~bit) | (c.digital & bit);
+	return pressed;
+}
+
+int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col, const char* str)
+{
+	if (line > 2)
+	{
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	std::string& text = sim::world().controllers[id].lines[line];
+	text.resize(std::max<std::size_t>(text.size(), col), ' ');
+	text = text.substr(0, col) + str;
+	sim::trace("controller %d line %d: %s", id, line, text.c_str());
+	return 1;
+}
+
+int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const char* fmt, ...)
+{
+	char buf[64];
+	va_list args;
+	va_start(args, fmt);
+	std::vsnprintf(buf, sizeof(buf), fmt, args);
+	va_end(args);
+	return controller_set_text(id, line, col, buf);
+}
+
+int32_t controller_clear_line(controller_id_e_t id, uint8_t line)
+{
+	return controller_set_text(id, line, 0, "");
+}
+
+int32_t controller_clear(controller_id_e_t id)
+{
+	for (std::string& text : sim::world().controllers[id].lines)
+	{
+		text.clear();
+	}
+	return 1;
+}
+
+int32_t controller_rumble(controller_id_e_t id, const char* rumble_pattern)
+{
+	sim::trace("controller %d rumble %s", id, rumble_pattern);
+	return 1;
+}
+
+uint8_t competition_get_status(void)
+{
+	uint8_t connected = sim::config().pits ? 0 : COMPETITION_CONNECTED;
+	return sim::config().opcontrol ? connected : connected | COMPETITION_AUTONOMOUS;
+}
+
+int32_t battery_get_voltage(void)
+{
+	return 12800;
+}
+
+int32_t battery_get_current(void)
+{
+	return 0;
+}
+
+double battery_get_temperature(void)
+{
+	return 30;
+}
+
+double battery_get_capacity(void)
+{
+	return 100;
+}
+
+int32_t usd_is_installed(void)
+{
+	return sim::config().usd.empty() ? 0 : 1;
+}
+
+/* Vision sensor */
+
+vision_signature_s_t vision_signature_from_utility(const int32_t id, const int32_t u_min, const int32_t u_max,
+                                                   const int32_t u_mean, const int32_t v_min, const int32_t v_max,
+                                                   const int32_t v_mean, const float range, const int32_t type)
+{
+	vision_signature_s_t sig{};
+	sig.id = id;
+	sig.range = range;
+	sig.u_min = u_min;
+	sig.u_max = u_max;
+	sig.u_mean = u_mean;
+	sig.v_min = v_min;
+	sig.v_max = v_max;
+	sig.v_mean = v_mean;
+	sig.type = type;
+	return sig;
+}
+
+int32_t vision_set_signature(uint8_t port, const uint8_t signature_id, vision_signature_s_t* const signature_ptr)
+{
+	(void)port;
+	(void)signature_id;
+	(void)signature_ptr;
+	return 1;
+}
+
+int32_t vision_set_zero_point(uint8_t port, vision_zero_e_t zero_point)
+{
+	sim::world().visions[port].zero_point = zero_point;
+	return 1;
+}
+
+namespace
+{
+// Goals of one signature (or every signature when sig_id is 0) in front of
+// the robot, biggest first. Signature ids are goal color + 1, as GoalCamera
+// sets them.
+std::vector<vision_object_s_t> vision_objects(uint8_t port, uint32_t sig_id)
+{
+	// Goals in front of the robot project onto the sensor's 61 degree field of view.
+	const double half_fov = 61.0 / 2 * M_PI / 180.0;
+	const sim::World& w = sim::world();
+	std::vector<vision_object_s_t> seen;
+	for (const sim::Goal& g : sim::config().goals)
+	{
+		uint32_t id = static_cast<uint32_t>(g.color) + 1;
+		if (sig_id != 0 && id != sig_id)
+		{
+			continue;
+		}
+		double dx = g.x - w.robot.x;
+		double dy = g.y - w.robot.y;
+		double range = std::hypot(dx, dy);
+		double bearing = std::remainder(std::atan2(dy, dx) - w.robot.theta, 2 * M_PI);
+		if (std::abs(bearing) > half_fov || range < g.radius || range > 3.0)
+		{
+			continue;
+		}
+		vision_object_s_t obj{};
+		obj.signature = id;
+		obj.width = std::min(VISION_FOV_WIDTH, static_cast<int>(2 * std::atan(g.radius / range) / (2 * half_fov) *
+		                                                          VISION_FOV_WIDTH));
+		obj.height = obj.width / 2;
+		obj.x_middle_coord = -bearing / half_fov * (VISION_FOV_WIDTH / 2);
+		obj.y_middle_coord = 0;
+		if (w.visions[port].zero_point == E_VISION_ZERO_TOPLEFT)
+		{
+			obj.x_middle_coord += VISION_FOV_WIDTH / 2;
+			obj.y_middle_coord += VISION_FOV_HEIGHT / 2;
+		}
+		obj.left_coord = obj.x_middle_coord - obj.width / 2;
+		obj.top_coord = obj.y_middle_coord - obj.height / 2;
+		seen.push_back(obj);
+	}
+	std::sort(seen.begin(), seen.end(),
+	          [](const vision_object_s_t& a, const vision_object_s_t& b) { return a.width > b.width; });
+	return seen;
+}
+
+int32_t vision_copy_out(const std::vector<vision_object_s_t>& seen, uint32_t size_id, uint32_t object_count,
+                        vision_object_s_t* const object_arr)
+{
+	int32_t count = 0;
+	for (uint32_t i = 0; i < object_count; i++)
+	{
+		if (size_id + i < seen.size())
+		{
+			object_arr[i] = seen[size_id + i];
+			count++;
+		}
+		else
+		{
+			object_arr[i] = vision_object_s_t{};
+			object_arr[i].signature = VISION_OBJECT_ERR_SIG;
+		}
+	}
+	if (count == 0)
+	{
+		errno = EDOM;
+		return PROS_ERR;
+	}
+	return count;
+}
+}  // namespace
+
+int32_t vision_read_by_sig(uint8_t port, const uint32_t size_id, const uint32_t sig_id, const uint32_t object_count,
+                           vision_object_s_t* const object_arr)
+{
+	return vision_copy_out(vision_objects(port, sig_id), size_id, object_count, object_arr);
+}
+
+int32_t vision_read_by_size(uint8_t port, const uint32_t size_id, const uint32_t object_count,
+                            vision_object_s_t* const object_arr)
+{
+	return vision_copy_out(vision_objects(port, 0), size_id, object_count, object_arr);
+}
+
+vision_object_s_t vision_get_by_sig(uint8_t port, const uint32_t size_id, const uint32_t sig_id)
+{
+	vision_object_s_t obj;
+	vision_read_by_sig(port, size_id, sig_id, 1, &obj);
+	return obj;
+}
+
+/* LLEMU */
+
+bool lcd_set_text(int16_t line, const char* text)
+{
+	sim::trace("lcd line %d: %s", line, text);
+	return true;
+}
+
+bool lcd_clear_line(int16_t line)
+{
+	(void)line;
+	return true;
+}
+
+bool lcd_print(int16_t line, const char* fmt, ...)
+{
+	char buf[64];
+	va_list args;
+	va_start(args, fmt);
+	std::vsnprintf(buf, sizeof(buf), fmt, args);
+	va_end(args);
+	return lcd_set_text(line, buf);
+}
+
+/* Brain screen */
+
+void screen_print(text_format_e_t txt_fmt, const int16_t line, const char* text, ...)
+{
+	(void)txt_fmt;
+	char buf[128];
+	va_list args;
+	va_start(args, text);
+	std::vsnprintf(buf, sizeof(buf), text, args);
+	va_end(args);
+	sim::trace("screen line %d: %s", line, buf);
+}
+
+}  // namespace c
+
+/* C++ device classes */
+
+std::int32_t Imu::reset() const
+{
+	return c::imu_reset(_port);
+}
+
+std::int32_t Imu::set_data_rate(std::uint32_t rate) const
+{
+	return c::imu_set_data_rate(_port, rate);
+}
+
+double Imu::get_rotation() const
+{
+	return c::imu_get_rotation(_port);
+}
+
+double Imu::get_heading() const
+{
+	return c::imu_get_heading(_port);
+}
+
+c::quaternion_s_t Imu::get_quaternion() const
+{
+	return c::imu_get_quaternion(_port);
+}
+
+c::euler_s_t Imu::get_euler() const
+{
+	return c::imu_get_euler(_port);
+}
+
+double Imu::get_pitch() const
+{
+	return c::imu_get_pitch(_port);
+}
+
+double Imu::get_roll() const
+{
+	return c::imu_get_roll(_port);
+}
+
+double Imu::get_yaw() const
+{
+	return c::imu_get_yaw(_port);
+}
+
+c::imu_gyro_s_t Imu::get_gyro_rate() const
+{
+	return c::imu_get_gyro_rate(_port);
+}
+
+std::int32_t Imu::tare_rotation() const
+{
+	return c::imu_tare_rotation(_port);
+}
+
+std::int32_t Imu::tare_heading() const
+{
+	return c::imu_tare_heading(_port);
+}
+
+std::int32_t Imu::tare_pitch() const
+{
+	return c::imu_tare_pitch(_port);
+}
+
+std::int32_t Imu::tare_yaw() const
+{
+	return c::imu_tare_yaw(_port);
+}
+
+std::int32_t Imu::tare_roll() const
+{
+	return c::imu_tare_roll(_port);
+}
+
+std::int32_t Imu::tare() const
+{
+	return c::imu_tare(_port);
+}
+
+std::int32_t Imu::tare_euler() const
+{
+	return c::imu_tare_euler(_port);
+}
+
+std::int32_t Imu::set_heading(const double target) const
+{
+	return c::imu_set_heading(_port, target);
+}
+
+std::int32_t Imu::set_rotation(const double target) const
+{
+	return c::imu_set_rotation(_port, target);
+}
+
+std::int32_t Imu::set_yaw(const double target) const
+{
+	return c::imu_set_yaw(_port, target);
+}
+
+std::int32_t Imu::set_pitch(const double target) const
+{
+	return c::imu_set_pitch(_port, target);
+}
+
+std::int32_t Imu::set_roll(const double target) const
+{
+	return c::imu_set_roll(_port, target);
+}
+
+std::int32_t Imu::set_euler(const c::euler_s_t target) const
+{
+	return c::imu_set_euler(_port, target);
+}
+
+c::imu_accel_s_t Imu::get_accel() const
+{
+	return c::imu_get_accel(_port);
+}
+
+c::imu_status_e_t Imu::get_status() const
+{
+	return c::imu_get_status(_port);
+}
+
+bool Imu::is_calibrating() const
+{
+	return get_status() & c::E_IMU_STATUS_CALIBRATING;
+}
+
+Distance::Distance(const std::uint8_t port) : _port(port)
+{
+}
+
+std::int32_t Distance::get()
+{
+	return c::distance_get(_port);
+}
+
+std::int32_t Distance::get_confidence()
+{
+	return c::distance_get_confidence(_port);
+}
+
+std::int32_t Distance::get_object_size()
+{
+	return c::distance_get_object_size(_port);
+}
+
+double Distance::get_object_velocity()
+{
+	return c::distance_get_object_velocity(_port);
+}
+
+std::uint8_t Distance::get_port()
+{
+	return _port;
+}
+
+ADIPort::ADIPort(std::uint8_t adi_port, adi_port_config_e_t type) : _smart_port(INTERNAL_ADI_PORT), _adi_port(adi_port)
+{
+	c::adi_port_set_config(_adi_port, type);
+}
+
+std::int32_t ADIPort::set_value(std::int32_t value) const
+{
+	return c::adi_port_set_value(_adi_port, value);
+}
+
+std::int32_t ADIPort::get_value() const
+{
+	return c::adi_port_get_value(_adi_port);
+}
+
+ADIDigitalOut::ADIDigitalOut(std::uint8_t adi_port, bool init_state) : ADIPort(adi_port, E_ADI_DIGITAL_OUT)
+{
+	set_value(init_state);
+}
+
+Controller::Controller(controller_id_e_t id) : _id(id)
+{
+}
+
+std::int32_t Controller::is_connected()
+{
+	return c::controller_is_connected(_id);
+}
+
+std::int32_t Controller::get_analog(controller_analog_e_t channel)
+{
+	return c::controller_get_analog(_id, channel);
+}
+
+std::int32_t Controller::get_digital(controller_digital_e_t button)
+{
+	return c::controller_get_digital(_id, button);
+}
+
+std::int32_t Controller::get_digital_new_press(controller_digital_e_t button)
+{
+	return c::controller_get_digital_new_press(_id, button);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const char* str)
+{
+	return c::controller_set_text(_id, line, col, str);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const std::string& str)
+{
+	return c::controller_set_text(_id, line, col, str.c_str());
+}
+
+std::int32_t Controller::clear_line(std::uint8_t line)
+{
+	return c::controller_clear_line(_id, line);
+}
+
+std::int32_t Controller::clear()
+{
+	return c::controller_clear(_id);
+}
+
+std::int32_t Controller::rumble(const char* rumble_pattern)
+{
+	return c::controller_rumble(_id, rumble_pattern);
+}
+
+namespace competition
+{
+std::uint8_t get_status()
+{
+	return c::competition_get_status();
+}
+
+std::uint8_t is_autonomous()
+{
+	return (get_status() & COMPETITION_AUTONOMOUS) != 0;
+}
+
+std::uint8_t is_connected()
+{
+	return (get_status() & COMPETITION_CONNECTED) != 0;
+}
+}  // namespace competition
+
+Vision::Vision(std::uint8_t port, vision_zero_e_t zero_point) : _port(port)
+{
+	c::vision_set_zero_point(port, zero_point);
+}
+
+vision_signature_s_t Vision::signature_from_utility(const std::int32_t id, const std::int32_t u_min,
+                                                    const std::int32_t u_max, const std::int32_t u_mean,
+                                                    const std::int32_t v_min, const std::int32_t v_max,
+                                                    const std::int32_t v_mean, const float range,
+                                                    const std::int32_t type)
+{
+	return c::vision_signature_from_utility(id, u_min, u_max, u_mean, v_min, v_max, v_mean, range, type);
+}
+
+std::int32_t Vision::set_signature(const std::uint8_t signature_id, vision_signature_s_t* const signature_ptr) const
+{
+	return c::vision_set_signature(_port, signature_id, signature_ptr);
+}
+
+vision_object_s_t Vision::get_by_sig(const std::uint32_t size_id, const std::uint32_t sig_id) const
+{
+	return c::vision_get_by_sig(_port, size_id, sig_id);
+}
+
+std::int32_t Vision::read_by_sig(const std::uint32_t size_id, const std::uint32_t sig_id,
+                                 const std::uint32_t object_count, vision_object_s_t* const object_arr) const
+{
+	return c::vision_read_by_sig(_port, size_id, sig_id, object_count, object_arr);
+}
+
+std::int32_t Vision::read_by_size(const std::uint32_t size_id, const std::uint32_t object_count,
+                                  vision_object_s_t* const object_arr) const
+{
+	return c::vision_read_by_size(_port, size_id, object_count, object_arr);
+}
+
+namespace lcd
+{
+bool initialize()
+{
+	return true;
+}
+
+bool set_text(std::int16_t line, std::string text)
+{
+	return c::lcd_set_text(line, text.c_str());
+}
+
+bool clear_line(std::int16_t line)
+{
+	return c::lcd_clear_line(line);
+}
+
+void register_btn1_cb(lcd_btn_cb_fn_t cb)
+{
+	(void)cb;
+}
+}  // namespace lcd
+
+}  // namespace pros
+
+// autoSelect/selection.h defines its button labels in the header, so it cannot
+// be included a second time here.
+namespace selector
+{
+
+int auton = 0;
+
+void init(int hue, int default_auton, const char** autons)
+{
+	(void)hue;
+	(void)default_auton;
+	(void)autons;
+	auton = sim::config().auton;
+}
+
+}  // namespace selector
+
+namespace pros
+{
+namespace usd
+{
+std::int32_t is_installed(void)
+{
+	return c::usd_is_installed();
+}
+}  // namespace usd
+}  // namespace pros
+
+// The brain mounts the SD card at /usd; the link wraps fopen so robot code
+// opening /usd/... gets the --usd folder instead, and no card without one.
+extern "C" FILE* __real_fopen(const char* path, const char* mode);
+
+extern "C" FILE* __wrap_fopen(const char* path, const char* mode)
+{
+	if (std::strncmp(path, "/usd/", 5) != 0)
+	{
+		return __real_fopen(path, mode);
+	}
+	if (sim::config().usd.empty())
+	{
+		errno = ENXIO;
+		return nullptr;
+	}
+	return __real_fopen((sim::config().usd + (path + 4)).c_str(), mode);
+}
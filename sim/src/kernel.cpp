@@ -0,0 +1,626 @@
+#include "api.h"
+#include "pros/apix.h"
+#include "sim/sim.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * Cooperative stand-in for the PROS scheduler.
+ *
+ * Every PROS task is a host thread, but only the task holding the baton runs.
+ * A task gives the baton up when it delays or blocks; the next task is the one
+ * with the earliest wake time (then highest priority, then least recently run).
+ * When nobody is ready the virtual clock jumps to the next wake time, stepping
+ * the physics model one millisecond at a time on the way. Runs are therefore
+ * deterministic and limited only by host CPU, not wall time.
+ *
+ * A task that never delays starves everything else, exactly as a
+ * highest-priority busy loop would on the brain.
+ */
+
+namespace
+{
+
+const std::uint32_t NEVER = TIMEOUT_MAX;
+
+struct SimTask
+{
+	std::string name;
+	std::uint32_t prio;
+	std::uint32_t wake = 0;
+	std::uint64_t last_run = 0;
+	bool suspended = false;
+	bool deleted = false;
+	bool waiting_notify = false;
+	std::uint32_t notify_value = 0;
+	std::condition_variable cv;
+
+	// task_notify_when_deleting registrations
+	struct DeleteNotify
+	{
+		SimTask* target;
+		std::uint32_t value;
+		pros::notify_action_e_t action;
+	};
+	std::vector<DeleteNotify> on_delete;
+};
+
+struct SimMutex
+{
+	SimTask* owner = nullptr;
+};
+
+// Thrown through a task's own stack when it deletes itself.
+struct TaskDeleted
+{
+};
+
+std::mutex kernel_lock;
+std::vector<SimTask*> tasks;
+SimTask* current = nullptr;
+std::uint32_t clock_ms = 0;
+std::uint64_t run_counter = 0;
+bool started = false;
+
+std::chrono::steady_clock::time_point wall_start;
+
+SimTask* self()
+{
+	return current;
+}
+
+SimTask* pick_next()
+{
+	SimTask* best = nullptr;
+	for (SimTask* t : tasks)
+	{
+		if (t->suspended || t->wake == NEVER)
+		{
+			continue;
+		}
+		if (best == nullptr || t->wake < best->wake ||
+		    (t->wake == best->wake && (t->prio > best->prio ||
+		                               (t->prio == best->prio && t->last_run < best->last_run))))
+		{
+			best = t;
+		}
+	}
+	return best;
+}
+
+// Hands the baton to the next ready task, advancing the clock if needed, and
+// blocks the caller (if it is still a live task) until it is scheduled again.
+void reschedule(std::unique_lock<std::mutex>& lk, SimTask* me)
+{
+	SimTask* next = pick_next();
+	if (next == nullptr)
+	{
+		lk.unlock();
+		sim::finish(3, "every task is blocked forever");
+	}
+	while (clock_ms < next->wake)
+	{
+		sim::world_step();
+		clock_ms++;
+		if (clock_ms >= sim::config().time_limit)
+		{
+			lk.unlock();
+			// driver control has no natural end; running out the clock is a pass
+			if (sim::config().opcontrol)
+			{
+				sim::finish(0, "opcontrol time elapsed");
+			}
+			sim::finish(2, "time limit reached");
+		}
+	}
+	next->last_run = ++run_counter;
+	current = next;
+	next->cv.notify_one();
+	if (me != nullptr && !me->deleted)
+	{
+		me->cv.wait(lk, [me] { return current == me; });
+	}
+}
+
+void notify_locked(SimTask* t, std::uint32_t value, pros::notify_action_e_t action, std::uint32_t* prev)
+{
+	if (prev != nullptr)
+	{
+		*prev = t->notify_value;
+	}
+	switch (action)
+	{
+		case pros::E_NOTIFY_ACTION_BITS:
+			t->notify_value |= value;
+			break;
+		case pros::E_NOTIFY_ACTION_INCR:
+			t->notify_value++;
+			break;
+		case pros::E_NOTIFY_ACTION_OWRITE:
+			t->notify_value = value;
+			break;
+		case pros::E_NOTIFY_ACTION_NO_OWRITE:
+			if (t->notify_value == 0)
+			{
+				t->notify_value = value;
+			}
+			break;
+		default:
+			break;
+	}
+	if (t->waiting_notify)
+	{
+		t->waiting_notify = false;
+		t->wake = clock_ms;
+	}
+}
+
+void remove_locked(SimTask* t)
+{
+	t->deleted = true;
+	for (const auto& n : t->on_delete)
+	{
+		if (!n.target->deleted)
+		{
+			notify_locked(n.target, n.value, n.action, nullptr);
+		}
+	}
+	for (auto it = tasks.begin(); it != tasks.end(); ++it)
+	{
+		if (*it == t)
+		{
+			tasks.erase(it);
+			break;
+		}
+	}
+}
+
+SimTask* resolve(pros::task_t task)
+{
+	return task == nullptr ? self() : static_cast<SimTask*>(task);
+}
+
+}  // namespace
+
+namespace sim
+{
+
+void kernel_start(const char* name)
+{
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	SimTask* t = new SimTask();
+	t->name = name;
+	t->prio = TASK_PRIORITY_DEFAULT;
+	tasks.push_back(t);
+	current = t;
+	started = true;
+	wall_start = std::chrono::steady_clock::now();
+}
+
+void set_task_name(const char* name)
+{
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	if (current != nullptr)
+	{
+		current->name = name;
+	}
+}
+
+std::uint32_t now()
+{
+	return clock_ms;
+}
+
+void finish(int code, const char* why)
+{
+	double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+	Pose p = pose();
+	std::printf("%s after %u ms virtual, %.3f s wall\n", why, clock_ms, wall);
+	std::printf("pose: x %.3f m, y %.3f m, heading %.1f deg, pitch %.1f deg\n", p.x, p.y,
+	            p.theta * 180.0 / M_PI, pitch());
+	if (goal_contact() != 0)
+	{
+		std::printf("goal in the front claw at %u ms\n", goal_contact());
+	}
+	std::fflush(stdout);
+	std::_Exit(code);
+}
+
+void trace(const char* fmt, ...)
+{
+	if (!config().trace)
+	{
+		return;
+	}
+	std::printf("%7u  ", clock_ms);
+	va_list args;
+	va_start(args, fmt);
+	std::vprintf(fmt, args);
+	va_end(args);
+	std::printf("\n");
+}
+
+}  // namespace sim
+
+namespace pros
+{
+namespace c
+{
+
+uint32_t millis(void)
+{
+	return clock_ms;
+}
+
+uint64_t micros(void)
+{
+	return static_cast<uint64_t>(clock_ms) * 1000;
+}
+
+void task_delay(const uint32_t milliseconds)
+{
+	std::unique_lock<std::mutex> lk(kernel_lock);
+	if (!started)
+	{
+		return;
+	}
+	SimTask* me = self();
+	me->wake = clock_ms + milliseconds;
+	reschedule(lk, me);
+}
+
+void delay(const uint32_t milliseconds)
+{
+	task_delay(milliseconds);
+}
+
+void task_delay_until(uint32_t* const prev_time, const uint32_t delta)
+{
+	uint32_t target = *prev_time + delta;
+	*prev_time = target;
+	if (target > clock_ms)
+	{
+		task_delay(target - clock_ms);
+	}
+}
+
+task_t task_create(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t stack_depth,
+                   const char* const name)
+{
+	(void)stack_depth;
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	SimTask* t = new SimTask();
+	t->name = name == nullptr ? "" : name;
+	t->prio = prio;
+	t->wake = clock_ms;
+	tasks.push_back(t);
+	std::thread([t, function, parameters] {
+		std::unique_lock<std::mutex> lk(kernel_lock);
+		t->cv.wait(lk, [t] { return current == t; });
+		lk.unlock();
+		try
+		{
+			function(parameters);
+		}
+		catch (const TaskDeleted&)
+		{
+		}
+		lk.lock();
+		remove_locked(t);
+		reschedule(lk, nullptr);
+	}).detach();
+	return t;
+}
+
+void task_delete(task_t task)
+{
+	std::unique_lock<std::mutex> lk(kernel_lock);
+	SimTask* t = resolve(task);
+	if (t->deleted)
+	{
+		return;
+	}
+	if (t == self())
+	{
+		lk.unlock();
+		throw TaskDeleted();
+	}
+	// The victim's thread stays parked on its condition variable forever.
+	remove_locked(t);
+}
+
+uint32_t task_get_priority(task_t task)
+{
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	return resolve(task)->prio;
+}
+
+void task_set_priority(task_t task, uint32_t prio)
+{
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	resolve(task)->prio = prio;
+}
+
+task_state_e_t task_get_state(task_t task)
+{
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	SimTask* t = resolve(task);
+	if (t->deleted)
+	{
+		return E_TASK_STATE_DELETED;
+	}
+	if (t->suspended)
+	{
+		return E_TASK_STATE_SUSPENDED;
+	}
+	if (t == current)
+	{
+		return E_TASK_STATE_RUNNING;
+	}
+	return t->wake <= clock_ms ? E_TASK_STATE_READY : E_TASK_STATE_BLOCKED;
+}
+
+void task_suspend(task_t task)
+{
+	std::unique_lock<std::mutex> lk(kernel_lock);
+	SimTask* t = resolve(task);
+	t->suspended = true;
+	if (t == self())
+	{
+		reschedule(lk, t);
+	}
+}
+
+void task_resume(task_t task)
+{
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	resolve(task)->suspended = false;
+}
+
+uint32_t task_get_count(void)
+{
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	return tasks.size();
+}
+
+char* task_get_name(task_t task)
+{
+	static char unnamed[] = "";
+	if (!started && task == nullptr)
+	{
+		return unnamed;
+	}
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	return const_cast<char*>(resolve(task)->name.c_str());
+}
+
+task_t task_get_by_name(const char* name)
+{
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	for (SimTask* t : tasks)
+	{
+		if (t->name == name)
+		{
+			return t;
+		}
+	}
+	return nullptr;
+}
+
+task_t task_get_current()
+{
+	return self();
+}
+
+uint32_t task_notify(task_t task)
+{
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	notify_locked(resolve(task), 0, E_NOTIFY_ACTION_INCR, nullptr);
+	return 1;
+}
+
+uint32_t task_notify_ext(task_t task, uint32_t value, notify_action_e_t action, uint32_t* prev_value)
+{
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	notify_locked(resolve(task), value, action, prev_value);
+	return 1;
+}
+
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout)
+{
+	std::unique_lock<std::mutex> lk(kernel_lock);
+	SimTask* me = self();
+	if (me->notify_value == 0 && timeout > 0)
+	{
+		me->waiting_notify = true;
+		me->wake = timeout == TIMEOUT_MAX ? NEVER : clock_ms + timeout;
+		reschedule(lk, me);
+		me->waiting_notify = false;
+	}
+	uint32_t value = me->notify_value;
+	if (value > 0)
+	{
+		me->notify_value = clear_on_exit ? 0 : value - 1;
+	}
+	return value;
+}
+
+bool task_notify_clear(task_t task)
+{
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	SimTask* t = resolve(task);
+	bool was_pending = t->notify_value != 0;
+	t->notify_value = 0;
+	return was_pending;
+}
+
+void task_notify_when_deleting(task_t target_task, task_t task, uint32_t value, notify_action_e_t notify_action)
+{
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	SimTask* target = resolve(target_task);
+	SimTask* watched = resolve(task);
+	watched->on_delete.push_back({target, value, notify_action});
+}
+
+mutex_t mutex_create(void)
+{
+	return new SimMutex();
+}
+
+bool mutex_take(mutex_t mutex, uint32_t timeout)
+{
+	SimMutex* m = static_cast<SimMutex*>(mutex);
+	uint32_t waited = 0;
+	while (true)
+	{
+		{
+			std::lock_guard<std::mutex> lk(kernel_lock);
+			if (m->owner == nullptr || !started)
+			{
+				m->owner = self();
+				return true;
+			}
+		}
+		if (waited >= timeout)
+		{
+			return false;
+		}
+		task_delay(1);
+		waited++;
+	}
+}
+
+bool mutex_give(mutex_t mutex)
+{
+	std::lock_guard<std::mutex> lk(kernel_lock);
+	static_cast<SimMutex*>(mutex)->owner = nullptr;
+	return true;
+}
+
+void mutex_delete(mutex_t mutex)
+{
+	delete static_cast<SimMutex*>(mutex);
+}
+
+}  // namespace c
+
+Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t stack_depth, const char* name)
+{
+	task = c::task_create(function, parameters, prio, stack_depth, name);
+}
+
+Task::Task(task_fn_t function, void* parameters, const char* name)
+    : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name)
+{
+}
+
+Task::Task(task_t task) : task(task)
+{
+}
+
+Task Task::current()
+{
+	return Task(c::task_get_current());
+}
+
+Task& Task::operator=(const task_t in)
+{
+	task = in;
+	return *this;
+}
+
+void Task::remove()
+{
+	c::task_delete(task);
+}
+
+std::uint32_t Task::get_priority()
+{
+	return c::task_get_priority(task);
+}
+
+void Task::set_priority(std::uint32_t prio)
+{
+	c::task_set_priority(task, prio);
+}
+
+std::uint32_t Task::get_state()
+{
+	return c::task_get_state(task);
+}
+
+void Task::suspend()
+{
+	c::task_suspend(task);
+}
+
+void Task::resume()
+{
+	c::task_resume(task);
+}
+
+const char* Task::get_name()
+{
+	return c::task_get_name(task);
+}
+
+std::uint32_t Task::notify()
+{
+	return c::task_notify(task);
+}
+
+std::uint32_t Task::notify_ext(std::uint32_t value, notify_action_e_t action, std::uint32_t* prev_value)
+{
+	return c::task_notify_ext(task, value, action, prev_value);
+}
+
+std::uint32_t Task::notify_take(bool clear_on_exit, std::uint32_t timeout)
+{
+	return c::task_notify_take(clear_on_exit, timeout);
+}
+
+bool Task::notify_clear()
+{
+	return c::task_notify_clear(task);
+}
+
+void Task::delay(const std::uint32_t milliseconds)
+{
+	c::task_delay(milliseconds);
+}
+
+void Task::delay_until(std::uint32_t* const prev_time, const std::uint32_t delta)
+{
+	c::task_delay_until(prev_time, delta);
+}
+
+std::uint32_t Task::get_count()
+{
+	return c::task_get_count();
+}
+
+Mutex::Mutex() : mutex(c::mutex_create(), c::mutex_delete)
+{
+}
+
+bool Mutex::take()
+{
+	return c::mutex_take(mutex.get(), TIMEOUT_MAX);
+}
+
+bool Mutex::take(std::uint32_t timeout)
+{
+	return c::mutex_take(mutex.get(), timeout);
+}
+
+bool Mutex::give()
+{
+	return c::mutex_give(mutex.get());
+}
+
+}  // namespace pros
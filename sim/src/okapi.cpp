@@ -0,0 +1,1602 @@
+#include "okapi/api.hpp"
+#include "sim/sim.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * The slice of OkapiLib the robots link against.
+ *
+ * Device classes forward to the PROS C API like the real library. The chassis
+ * and lift controllers are simplified: ChassisController runs okapi's
+ * distance/angle/turn PID structure in a 10 ms task (or drives the motors'
+ * own position control when no gains are given), and the position controller
+ * relies on the motor's profiled moveAbsolute, as AsyncPosIntegratedController
+ * does.
+ */
+
+namespace okapi
+{
+
+/* Logging and time */
+
+std::shared_ptr<Logger> defaultLogger;
+int DefaultLoggerInitializer::count = 0;
+
+Logger::Logger() noexcept : timer(nullptr), logLevel(LogLevel::off), logfile(nullptr)
+{
+}
+
+Logger::Logger(std::unique_ptr<AbstractTimer> itimer, std::string_view ifileName, const LogLevel& ilevel) noexcept
+    : timer(std::move(itimer)), logLevel(ilevel), logfile(isSerialStream(ifileName) ? stdout : nullptr)
+{
+}
+
+Logger::Logger(std::unique_ptr<AbstractTimer> itimer, FILE* ifile, const LogLevel& ilevel) noexcept
+    : timer(std::move(itimer)), logLevel(ilevel), logfile(ifile)
+{
+}
+
+Logger::~Logger()
+{
+}
+
+std::shared_ptr<Logger> Logger::getDefaultLogger()
+{
+	return defaultLogger;
+}
+
+void Logger::setDefaultLogger(std::shared_ptr<Logger> ilogger)
+{
+	defaultLogger = ilogger;
+}
+
+bool Logger::isSerialStream(std::string_view filename)
+{
+	return filename.rfind("/ser/", 0) == 0;
+}
+
+AbstractTimer::AbstractTimer(QTime ifirstCalled)
+    : firstCalled(ifirstCalled), lastCalled(ifirstCalled), mark(ifirstCalled), hardMark(0_ms), repeatMark(ifirstCalled)
+{
+}
+
+AbstractTimer::~AbstractTimer() = default;
+
+QTime AbstractTimer::getDt()
+{
+	QTime now = millis();
+	QTime dt = now - lastCalled;
+	lastCalled = now;
+	return dt;
+}
+
+QTime AbstractTimer::readDt() const
+{
+	return millis() - lastCalled;
+}
+
+QTime AbstractTimer::getStartingTime() const
+{
+	return firstCalled;
+}
+
+QTime AbstractTimer::getDtFromStart() const
+{
+	return millis() - firstCalled;
+}
+
+void AbstractTimer::placeMark()
+{
+	mark = millis();
+}
+
+QTime AbstractTimer::clearMark()
+{
+	QTime old = mark;
+	mark = 0_ms;
+	return old;
+}
+
+void AbstractTimer::placeHardMark()
+{
+	if (hardMark == 0_ms)
+	{
+		hardMark = millis();
+	}
+}
+
+QTime AbstractTimer::clearHardMark()
+{
+	QTime old = hardMark;
+	hardMark = 0_ms;
+	return old;
+}
+
+QTime AbstractTimer::getDtFromMark() const
+{
+	return mark == 0_ms ? 0_ms : millis() - mark;
+}
+
+QTime AbstractTimer::getDtFromHardMark() const
+{
+	return hardMark == 0_ms ? 0_ms : millis() - hardMark;
+}
+
+bool AbstractTimer::repeat(QTime time)
+{
+	if (repeatMark == 0_ms)
+	{
+		repeatMark = millis();
+		return false;
+	}
+	if (millis() - repeatMark >= time)
+	{
+		repeatMark = millis();
+		return true;
+	}
+	return false;
+}
+
+bool AbstractTimer::repeat(QFrequency frequency)
+{
+	return repeat(QTime(1 / frequency.convert(Hz)));
+}
+
+Timer::Timer() : AbstractTimer(millis())
+{
+}
+
+QTime Timer::millis() const
+{
+	return pros::c::millis() * millisecond;
+}
+
+AbstractRate::~AbstractRate() = default;
+
+Rate::Rate() = default;
+
+void Rate::delay(QFrequency ihz)
+{
+	delayUntil(QTime(1 / ihz.convert(Hz)));
+}
+
+void Rate::delayUntil(QTime itime)
+{
+	delayUntil(static_cast<uint32_t>(itime.convert(millisecond)));
+}
+
+void Rate::delayUntil(uint32_t ims)
+{
+	if (lastTime == 0)
+	{
+		lastTime = pros::c::millis();
+	}
+	pros::c::task_delay_until(&lastTime, ims);
+}
+
+SettledUtil::SettledUtil(std::unique_ptr<AbstractTimer> iatTargetTimer, double iatTargetError,
+                         double iatTargetDerivative, QTime iatTargetTime)
+    : atTargetError(iatTargetError), atTargetDerivative(iatTargetDerivative), atTargetTime(iatTargetTime),
+      atTargetTimer(std::move(iatTargetTimer))
+{
+}
+
+SettledUtil::~SettledUtil() = default;
+
+bool SettledUtil::isSettled(double ierror)
+{
+	double derivative = ierror - lastError;
+	lastError = ierror;
+	if (std::abs(ierror) <= atTargetError && std::abs(derivative) <= atTargetDerivative)
+	{
+		atTargetTimer->placeHardMark();
+	}
+	else
+	{
+		atTargetTimer->clearHardMark();
+	}
+	return atTargetTimer->getDtFromHardMark() >= atTargetTime;
+}
+
+void SettledUtil::reset()
+{
+	atTargetTimer->clearHardMark();
+	lastError = 0;
+}
+
+TimeUtil::TimeUtil(const Supplier<std::unique_ptr<AbstractTimer>>& itimerSupplier,
+                   const Supplier<std::unique_ptr<AbstractRate>>& irateSupplier,
+                   const Supplier<std::unique_ptr<SettledUtil>>& isettledUtilSupplier)
+    : timerSupplier(itimerSupplier), rateSupplier(irateSupplier), settledUtilSupplier(isettledUtilSupplier)
+{
+}
+
+std::unique_ptr<AbstractTimer> TimeUtil::getTimer() const
+{
+	return timerSupplier.get();
+}
+
+std::unique_ptr<AbstractRate> TimeUtil::getRate() const
+{
+	return rateSupplier.get();
+}
+
+std::unique_ptr<SettledUtil> TimeUtil::getSettledUtil() const
+{
+	return settledUtilSupplier.get();
+}
+
+Supplier<std::unique_ptr<AbstractTimer>> TimeUtil::getTimerSupplier() const
+{
+	return timerSupplier;
+}
+
+Supplier<std::unique_ptr<AbstractRate>> TimeUtil::getRateSupplier() const
+{
+	return rateSupplier;
+}
+
+Supplier<std::unique_ptr<SettledUtil>> TimeUtil::getSettledUtilSupplier() const
+{
+	return settledUtilSupplier;
+}
+
+TimeUtil TimeUtilFactory::create()
+{
+	return createDefault();
+}
+
+TimeUtil TimeUtilFactory::createDefault()
+{
+	return withSettledUtilParams();
+}
+
+TimeUtil TimeUtilFactory::withSettledUtilParams(double iatTargetError, double iatTargetDerivative,
+                                                const QTime& iatTargetTime)
+{
+	return TimeUtil(
+	    Supplier<std::unique_ptr<AbstractTimer>>([]() { return std::make_unique<Timer>(); }),
+	    Supplier<std::unique_ptr<AbstractRate>>([]() { return std::make_unique<Rate>(); }),
+	    Supplier<std::unique_ptr<SettledUtil>>([=]() {
+		    return std::make_unique<SettledUtil>(std::make_unique<Timer>(), iatTargetError, iatTargetDerivative,
+		                                         iatTargetTime);
+	    }));
+}
+
+Filter::~Filter() = default;
+
+PassthroughFilter::PassthroughFilter() = default;
+
+double PassthroughFilter::filter(double ireading)
+{
+	lastOutput = ireading;
+	return lastOutput;
+}
+
+double PassthroughFilter::getOutput() const
+{
+	return lastOutput;
+}
+
+/* Odometry math */
+
+QLength OdomMath::computeDistanceToPoint(const Point& ipoint, const OdomState& istate)
+{
+	const auto [xDiff, yDiff] = computeDiffs(ipoint, istate);
+	return computeDistance(xDiff, yDiff) * meter;
+}
+
+QAngle OdomMath::computeAngleToPoint(const Point& ipoint, const OdomState& istate)
+{
+	const auto [xDiff, yDiff] = computeDiffs(ipoint, istate);
+	return computeAngle(xDiff, yDiff, istate.theta.convert(radian)) * radian;
+}
+
+std::pair<QLength, QAngle> OdomMath::computeDistanceAndAngleToPoint(const Point& ipoint, const OdomState& istate)
+{
+	const auto [xDiff, yDiff] = computeDiffs(ipoint, istate);
+	return std::make_pair(computeDistance(xDiff, yDiff) * meter,
+	                      computeAngle(xDiff, yDiff, istate.theta.convert(radian)) * radian);
+}
+
+QAngle OdomMath::constrainAngle360(const QAngle& angle)
+{
+	return angle - 360_deg * std::floor(angle.convert(degree) / 360.0);
+}
+
+QAngle OdomMath::constrainAngle180(const QAngle& angle)
+{
+	return angle - 360_deg * std::floor((angle.convert(degree) + 180.0) / 360.0);
+}
+
+std::pair<double, double> OdomMath::computeDiffs(const Point& ipoint, const OdomState& istate)
+{
+	return std::make_pair(ipoint.x.convert(meter) - istate.x.convert(meter),
+	                      ipoint.y.convert(meter) - istate.y.convert(meter));
+}
+
+double OdomMath::computeDistance(double xDiff, double yDiff)
+{
+	return std::sqrt(xDiff * xDiff + yDiff * yDiff);
+}
+
+double OdomMath::computeAngle(double xDiff, double yDiff, double theta)
+{
+	return constrainAngle180((std::atan2(yDiff, xDiff) - theta) * radian).convert(radian);
+}
+
+/* Devices */
+
+namespace
+{
+
+pros::motor_gearset_e_t to_pros(AbstractMotor::gearset g)
+{
+	switch (g)
+	{
+		case AbstractMotor::gearset::red:
+			return pros::E_MOTOR_GEARSET_36;
+		case AbstractMotor::gearset::blue:
+			return pros::E_MOTOR_GEARSET_06;
+		default:
+			return pros::E_MOTOR_GEARSET_18;
+	}
+}
+
+AbstractMotor::gearset from_pros(pros::motor_gearset_e_t g)
+{
+	switch (g)
+	{
+		case pros::E_MOTOR_GEARSET_36:
+			return AbstractMotor::gearset::red;
+		case pros::E_MOTOR_GEARSET_06:
+			return AbstractMotor::gearset::blue;
+		case pros::E_MOTOR_GEARSET_18:
+			return AbstractMotor::gearset::green;
+		default:
+			return AbstractMotor::gearset::invalid;
+	}
+}
+
+// MotorGroup keeps its members protected; the sim needs them to tell the
+// physics model which ports make up each side of the drive.
+struct MotorGroupAccess : MotorGroup
+{
+	using MotorGroup::motors;
+};
+
+void collect_ports(const std::shared_ptr<AbstractMotor>& m, std::vector<int>& out)
+{
+	if (auto motor = std::dynamic_pointer_cast<Motor>(m))
+	{
+		out.push_back(motor->isReversed() ? -motor->getPort() : motor->getPort());
+	}
+	else if (auto group = std::dynamic_pointer_cast<MotorGroup>(m))
+	{
+		for (const auto& member : (*group).*(&MotorGroupAccess::motors))
+		{
+			collect_ports(member, out);
+		}
+	}
+}
+
+}  // namespace
+
+AbstractMotor::~AbstractMotor() = default;
+
+RotarySensor::~RotarySensor() = default;
+
+Motor::Motor(std::int8_t iport)
+    : Motor(std::abs(iport), iport < 0, gearset::green, encoderUnits::degrees)
+{
+}
+
+Motor::Motor(std::uint8_t iport, bool ireverse, AbstractMotor::gearset igearset,
+             AbstractMotor::encoderUnits iencoderUnits, const std::shared_ptr<Logger>& logger)
+    : port(iport), reversed(ireverse ? -1 : 1)
+{
+	(void)logger;
+	setGearing(igearset);
+	setEncoderUnits(iencoderUnits);
+}
+
+std::int32_t Motor::moveAbsolute(double iposition, std::int32_t ivelocity)
+{
+	return pros::c::motor_move_absolute(port, iposition * reversed, ivelocity);
+}
+
+std::int32_t Motor::moveRelative(double iposition, std::int32_t ivelocity)
+{
+	return pros::c::motor_move_relative(port, iposition * reversed, ivelocity);
+}
+
+std::int32_t Motor::moveVelocity(std::int16_t ivelocity)
+{
+	return pros::c::motor_move_velocity(port, ivelocity * reversed);
+}
+
+std::int32_t Motor::moveVoltage(std::int16_t ivoltage)
+{
+	return pros::c::motor_move_voltage(port, ivoltage * reversed);
+}
+
+std::int32_t Motor::modifyProfiledVelocity(std::int32_t ivelocity)
+{
+	return pros::c::motor_modify_profiled_velocity(port, ivelocity);
+}
+
+double Motor::getTargetPosition()
+{
+	return pros::c::motor_get_target_position(port) * reversed;
+}
+
+double Motor::getPosition()
+{
+	return pros::c::motor_get_position(port) * reversed;
+}
+
+std::int32_t Motor::tarePosition()
+{
+	return pros::c::motor_tare_position(port);
+}
+
+std::int32_t Motor::getTargetVelocity()
+{
+	return pros::c::motor_get_target_velocity(port) * reversed;
+}
+
+double Motor::getActualVelocity()
+{
+	return pros::c::motor_get_actual_velocity(port) * reversed;
+}
+
+std::int32_t Motor::getCurrentDraw()
+{
+	return pros::c::motor_get_current_draw(port);
+}
+
+std::int32_t Motor::getDirection()
+{
+	return pros::c::motor_get_direction(port) * reversed;
+}
+
+double Motor::getEfficiency()
+{
+	return pros::c::motor_get_efficiency(port);
+}
+
+std::int32_t Motor::isOverCurrent()
+{
+	return pros::c::motor_is_over_current(port);
+}
+
+std::int32_t Motor::isOverTemp()
+{
+	return pros::c::motor_is_over_temp(port);
+}
+
+std::int32_t Motor::isStopped()
+{
+	return pros::c::motor_is_stopped(port);
+}
+
+std::int32_t Motor::getZeroPositionFlag()
+{
+	return pros::c::motor_get_zero_position_flag(port);
+}
+
+uint32_t Motor::getFaults()
+{
+	return pros::c::motor_get_faults(port);
+}
+
+uint32_t Motor::getFlags()
+{
+	return pros::c::motor_get_flags(port);
+}
+
+std::int32_t Motor::getRawPosition(std::uint32_t* timestamp)
+{
+	return pros::c::motor_get_raw_position(port, timestamp) * reversed;
+}
+
+double Motor::getPower()
+{
+	return pros::c::motor_get_power(port);
+}
+
+double Motor::getTemperature()
+{
+	return pros::c::motor_get_temperature(port);
+}
+
+double Motor::getTorque()
+{
+	return pros::c::motor_get_torque(port);
+}
+
+std::int32_t Motor::getVoltage()
+{
+	return pros::c::motor_get_voltage(port) * reversed;
+}
+
+std::int32_t Motor::setBrakeMode(AbstractMotor::brakeMode imode)
+{
+	return pros::c::motor_set_brake_mode(port, static_cast<pros::motor_brake_mode_e_t>(imode));
+}
+
+AbstractMotor::brakeMode Motor::getBrakeMode()
+{
+	return static_cast<brakeMode>(pros::c::motor_get_brake_mode(port));
+}
+
+std::int32_t Motor::setCurrentLimit(std::int32_t ilimit)
+{
+	return pros::c::motor_set_current_limit(port, ilimit);
+}
+
+std::int32_t Motor::getCurrentLimit()
+{
+	return pros::c::motor_get_current_limit(port);
+}
+
+std::int32_t Motor::setEncoderUnits(AbstractMotor::encoderUnits iunits)
+{
+	return pros::c::motor_set_encoder_units(port, static_cast<pros::motor_encoder_units_e_t>(iunits));
+}
+
+AbstractMotor::encoderUnits Motor::getEncoderUnits()
+{
+	return static_cast<encoderUnits>(pros::c::motor_get_encoder_units(port));
+}
+
+std::int32_t Motor::setGearing(AbstractMotor::gearset igearset)
+{
+	return pros::c::motor_set_gearing(port, to_pros(igearset));
+}
+
+AbstractMotor::gearset Motor::getGearing()
+{
+	return from_pros(pros::c::motor_get_gearing(port));
+}
+
+std::int32_t Motor::setReversed(bool ireverse)
+{
+	reversed = ireverse ? -1 : 1;
+	return 1;
+}
+
+std::int32_t Motor::setVoltageLimit(std::int32_t ilimit)
+{
+	return pros::c::motor_set_voltage_limit(port, ilimit);
+}
+
+std::int32_t Motor::setPosPID(double, double, double, double)
+{
+	return 1;
+}
+
+std::int32_t Motor::setPosPIDFull(double, double, double, double, double, double, double, double)
+{
+	return 1;
+}
+
+std::int32_t Motor::setVelPID(double, double, double, double)
+{
+	return 1;
+}
+
+std::int32_t Motor::setVelPIDFull(double, double, double, double, double, double, double, double)
+{
+	return 1;
+}
+
+std::shared_ptr<ContinuousRotarySensor> Motor::getEncoder()
+{
+	return std::make_shared<IntegratedEncoder>(port, reversed < 0);
+}
+
+void Motor::controllerSet(double ivalue)
+{
+	moveVelocity(static_cast<std::int16_t>(ivalue * toUnderlyingType(getGearing())));
+}
+
+std::uint8_t Motor::getPort() const
+{
+	return port;
+}
+
+bool Motor::isReversed() const
+{
+	return reversed < 0;
+}
+
+IntegratedEncoder::IntegratedEncoder(const okapi::Motor& imotor)
+    : IntegratedEncoder(imotor.getPort(), imotor.isReversed())
+{
+}
+
+IntegratedEncoder::IntegratedEncoder(std::int8_t iport, bool ireversed)
+    : port(std::abs(iport)), reversed(ireversed ? -1 : 1)
+{
+}
+
+double IntegratedEncoder::get() const
+{
+	return pros::c::motor_get_position(port) * reversed;
+}
+
+std::int32_t IntegratedEncoder::reset()
+{
+	return pros::c::motor_tare_position(port);
+}
+
+double IntegratedEncoder::controllerGet()
+{
+	return get();
+}
+
+MotorGroup::MotorGroup(const std::initializer_list<Motor>& imotors, const std::shared_ptr<Logger>& ilogger)
+{
+	(void)ilogger;
+	for (const Motor& m : imotors)
+	{
+		motors.push_back(std::make_shared<Motor>(m));
+	}
+}
+
+MotorGroup::MotorGroup(const std::initializer_list<std::shared_ptr<AbstractMotor>>& imotors,
+                       const std::shared_ptr<Logger>& ilogger)
+    : motors(imotors)
+{
+	(void)ilogger;
+}
+
+std::int32_t MotorGroup::moveAbsolute(double iposition, std::int32_t ivelocity)
+{
+	for (auto& m : motors)
+	{
+		m->moveAbsolute(iposition, ivelocity);
+	}
+	return 1;
+}
+
+std::int32_t MotorGroup::moveRelative(double iposition, std::int32_t ivelocity)
+{
+	for (auto& m : motors)
+	{
+		m->moveRelative(iposition, ivelocity);
+	}
+	return 1;
+}
+
+std::int32_t MotorGroup::moveVelocity(std::int16_t ivelocity)
+{
+	for (auto& m : motors)
+	{
+		m->moveVelocity(ivelocity);
+	}
+	return 1;
+}
+
+std::int32_t MotorGroup::moveVoltage(std::int16_t ivoltage)
+{
+	for (auto& m : motors)
+	{
+		m->moveVoltage(ivoltage);
+	}
+	return 1;
+}
+
+std::int32_t MotorGroup::modifyProfiledVelocity(std::int32_t ivelocity)
+{
+	for (auto& m : motors)
+	{
+		m->modifyProfiledVelocity(ivelocity);
+	}
+	return 1;
+}
+
+double MotorGroup::getTargetPosition()
+{
+	return motors.front()->getTargetPosition();
+}
+
+double MotorGroup::getPosition()
+{
+	return motors.front()->getPosition();
+}
+
+std::int32_t MotorGroup::tarePosition()
+{
+	for (auto& m : motors)
+	{
+		m->tarePosition();
+	}
+	return 1;
+}
+
+std::int32_t MotorGroup::getTargetVelocity()
+{
+	return motors.front()->getTargetVelocity();
+}
+
+double MotorGroup::getActualVelocity()
+{
+	double sum = 0;
+	for (auto& m : motors)
+	{
+		sum += m->getActualVelocity();
+	}
+	return sum / motors.size();
+}
+
+std::int32_t MotorGroup::getCurrentDraw()
+{
+	std::int32_t sum = 0;
+	for (auto& m : motors)
+	{
+		sum += m->getCurrentDraw();
+	}
+	return sum;
+}
+
+std::int32_t MotorGroup::getDirection()
+{
+	return motors.front()->getDirection();
+}
+
+double MotorGroup::getEfficiency()
+{
+	return motors.front()->getEfficiency();
+}
+
+std::int32_t MotorGroup::isOverCurrent()
+{
+	return motors.front()->isOverCurrent();
+}
+
+std::int32_t MotorGroup::isOverTemp()
+{
+	return motors.front()->isOverTemp();
+}
+
+std::int32_t MotorGroup::isStopped()
+{
+	return motors.front()->isStopped();
+}
+
+std::int32_t MotorGroup::getZeroPositionFlag()
+{
+	return motors.front()->getZeroPositionFlag();
+}
+
+uint32_t MotorGroup::getFaults()
+{
+	return motors.front()->getFaults();
+}
+
+uint32_t MotorGroup::getFlags()
+{
+	return motors.front()->getFlags();
+}
+
+std::int32_t MotorGroup::getRawPosition(std::uint32_t* timestamp)
+{
+	return motors.front()->getRawPosition(timestamp);
+}
+
+double MotorGroup::getPower()
+{
+	double sum = 0;
+	for (auto& m : motors)
+	{
+		sum += m->getPower();
+	}
+	return sum;
+}
+
+double MotorGroup::getTemperature()
+{
+	double hottest = 0;
+	for (auto& m : motors)
+	{
+		hottest = std::max(hottest, m->getTemperature());
+	}
+	return hottest;
+}
+
+double MotorGroup::getTorque()
+{
+	return motors.front()->getTorque();
+}
+
+std::int32_t MotorGroup::getVoltage()
+{
+	return motors.front()->getVoltage();
+}
+
+std::int32_t MotorGroup::setBrakeMode(AbstractMotor::brakeMode imode)
+{
+	for (auto& m : motors)
+	{
+		m->setBrakeMode(imode);
+	}
+	return 1;
+}
+
+AbstractMotor::brakeMode MotorGroup::getBrakeMode()
+{
+	return motors.front()->getBrakeMode();
+}
+
+std::int32_t MotorGroup::setCurrentLimit(std::int32_t ilimit)
+{
+	for (auto& m : motors)
+	{
+		m->setCurrentLimit(ilimit);
+	}
+	return 1;
+}
+
+std::int32_t MotorGroup::getCurrentLimit()
+{
+	return motors.front()->getCurrentLimit();
+}
+
+std::int32_t MotorGroup::setEncoderUnits(AbstractMotor::encoderUnits iunits)
+{
+	for (auto& m : motors)
+	{
+		m->setEncoderUnits(iunits);
+	}
+	return 1;
+}
+
+AbstractMotor::encoderUnits MotorGroup::getEncoderUnits()
+{
+	return motors.front()->getEncoderUnits();
+}
+
+std::int32_t MotorGroup::setGearing(AbstractMotor::gearset igearset)
+{
+	for (auto& m : motors)
+	{
+		m->setGearing(igearset);
+	}
+	return 1;
+}
+
+AbstractMotor::gearset MotorGroup::getGearing()
+{
+	return motors.front()->getGearing();
+}
+
+std::int32_t MotorGroup::setReversed(bool ireverse)
+{
+	for (auto& m : motors)
+	{
+		m->setReversed(ireverse);
+	}
+	return 1;
+}
+
+std::int32_t MotorGroup::setVoltageLimit(std::int32_t ilimit)
+{
+	for (auto& m : motors)
+	{
+		m->setVoltageLimit(ilimit);
+	}
+	return 1;
+}
+
+std::shared_ptr<ContinuousRotarySensor> MotorGroup::getEncoder()
+{
+	return getEncoder(0);
+}
+
+std::shared_ptr<ContinuousRotarySensor> MotorGroup::getEncoder(std::size_t index)
+{
+	return motors.at(index)->getEncoder();
+}
+
+void MotorGroup::controllerSet(double ivalue)
+{
+	for (auto& m : motors)
+	{
+		m->controllerSet(ivalue);
+	}
+}
+
+/* Chassis */
+
+ChassisScales::ChassisScales(const std::initializer_list<QLength>& idimensions, double itpr,
+                             const std::shared_ptr<Logger>& ilogger)
+{
+	validateInputSize(idimensions.size(), ilogger);
+	std::vector<QLength> vec(idimensions);
+	wheelDiameter = vec.at(0);
+	wheelTrack = vec.at(1);
+	middleWheelDistance = vec.size() > 2 ? vec.at(2) : 0_m;
+	middleWheelDiameter = vec.size() > 3 ? vec.at(3) : wheelDiameter;
+	tpr = itpr;
+	straight = tpr / (wheelDiameter.convert(meter) * pi);
+	turn = wheelTrack.convert(meter) / wheelDiameter.convert(meter);
+	middle = middleWheelDiameter == 0_m ? 0 : tpr / (middleWheelDiameter.convert(meter) * pi);
+}
+
+ChassisScales::ChassisScales(const std::initializer_list<double>& iscales, double itpr,
+                             const std::shared_ptr<Logger>& ilogger)
+{
+	validateInputSize(iscales.size(), ilogger);
+	std::vector<double> vec(iscales);
+	straight = vec.at(0);
+	turn = vec.at(1);
+	middle = vec.size() > 3 ? vec.at(3) : straight;
+	tpr = itpr;
+	wheelDiameter = (tpr / (straight * pi)) * meter;
+	wheelTrack = turn * wheelDiameter;
+	middleWheelDistance = vec.size() > 2 ? vec.at(2) * meter : 0_m;
+	middleWheelDiameter = (tpr / (middle * pi)) * meter;
+}
+
+void ChassisScales::validateInputSize(std::size_t inputSize, const std::shared_ptr<Logger>& logger)
+{
+	(void)logger;
+	if (inputSize < 2)
+	{
+		throw std::invalid_argument("ChassisScales: expected at least two dimensions");
+	}
+}
+
+SkidSteerModel::SkidSteerModel(std::shared_ptr<AbstractMotor> ileftSideMotor,
+                               std::shared_ptr<AbstractMotor> irightSideMotor,
+                               std::shared_ptr<ContinuousRotarySensor> ileftEnc,
+                               std::shared_ptr<ContinuousRotarySensor> irightEnc, double imaxVelocity,
+                               double imaxVoltage)
+    : maxVelocity(imaxVelocity), maxVoltage(imaxVoltage), leftSideMotor(std::move(ileftSideMotor)),
+      rightSideMotor(std::move(irightSideMotor)), leftSensor(std::move(ileftEnc)), rightSensor(std::move(irightEnc))
+{
+}
+
+void SkidSteerModel::forward(double ispeed)
+{
+	double speed = std::clamp(ispeed, -1.0, 1.0);
+	leftSideMotor->moveVelocity(static_cast<std::int16_t>(speed * maxVelocity));
+	rightSideMotor->moveVelocity(static_cast<std::int16_t>(speed * maxVelocity));
+}
+
+void SkidSteerModel::driveVector(double iySpeed, double izRotation)
+{
+	double forward = std::clamp(iySpeed, -1.0, 1.0);
+	double yaw = std::clamp(izRotation, -1.0, 1.0);
+	double left = forward + yaw;
+	double right = forward - yaw;
+	double larger = std::max(std::abs(left), std::abs(right));
+	if (larger > 1)
+	{
+		left /= larger;
+		right /= larger;
+	}
+	leftSideMotor->moveVelocity(static_cast<std::int16_t>(left * maxVelocity));
+	rightSideMotor->moveVelocity(static_cast<std::int16_t>(right * maxVelocity));
+}
+
+void SkidSteerModel::driveVectorVoltage(double iforwardSpeed, double iyaw)
+{
+	double forward = std::clamp(iforwardSpeed, -1.0, 1.0);
+	double yaw = std::clamp(iyaw, -1.0, 1.0);
+	double left = forward + yaw;
+	double right = forward - yaw;
+	double larger = std::max(std::abs(left), std::abs(right));
+	if (larger > 1)
+	{
+		left /= larger;
+		right /= larger;
+	}
+	leftSideMotor->moveVoltage(static_cast<std::int16_t>(left * maxVoltage));
+	rightSideMotor->moveVoltage(static_cast<std::int16_t>(right * maxVoltage));
+}
+
+void SkidSteerModel::rotate(double ispeed)
+{
+	double speed = std::clamp(ispeed, -1.0, 1.0);
+	leftSideMotor->moveVelocity(static_cast<std::int16_t>(speed * maxVelocity));
+	rightSideMotor->moveVelocity(static_cast<std::int16_t>(-speed * maxVelocity));
+}
+
+void SkidSteerModel::stop()
+{
+	leftSideMotor->moveVelocity(0);
+	rightSideMotor->moveVelocity(0);
+}
+
+void SkidSteerModel::tank(double ileftSpeed, double irightSpeed, double ithreshold)
+{
+	double left = std::abs(ileftSpeed) <= ithreshold ? 0 : std::clamp(ileftSpeed, -1.0, 1.0);
+	double right = std::abs(irightSpeed) <= ithreshold ? 0 : std::clamp(irightSpeed, -1.0, 1.0);
+	leftSideMotor->moveVoltage(static_cast<std::int16_t>(left * maxVoltage));
+	rightSideMotor->moveVoltage(static_cast<std::int16_t>(right * maxVoltage));
+}
+
+void SkidSteerModel::arcade(double iforwardSpeed, double iyaw, double ithreshold)
+{
+	double forward = std::abs(iforwardSpeed) <= ithreshold ? 0 : iforwardSpeed;
+	double yaw = std::abs(iyaw) <= ithreshold ? 0 : iyaw;
+	driveVectorVoltage(forward, yaw);
+}
+
+void SkidSteerModel::left(double ispeed)
+{
+	leftSideMotor->moveVelocity(static_cast<std::int16_t>(std::clamp(ispeed, -1.0, 1.0) * maxVelocity));
+}
+
+void SkidSteerModel::right(double ispeed)
+{
+	rightSideMotor->moveVelocity(static_cast<std::int16_t>(std::clamp(ispeed, -1.0, 1.0) * maxVelocity));
+}
+
+std::valarray<std::int32_t> SkidSteerModel::getSensorVals() const
+{
+	return std::valarray<std::int32_t>{static_cast<std::int32_t>(leftSensor->get()),
+	                                   static_cast<std::int32_t>(rightSensor->get())};
+}
+
+void SkidSteerModel::resetSensors()
+{
+	leftSensor->reset();
+	rightSensor->reset();
+}
+
+void SkidSteerModel::setBrakeMode(AbstractMotor::brakeMode mode)
+{
+	leftSideMotor->setBrakeMode(mode);
+	rightSideMotor->setBrakeMode(mode);
+}
+
+void SkidSteerModel::setEncoderUnits(AbstractMotor::encoderUnits units)
+{
+	leftSideMotor->setEncoderUnits(units);
+	rightSideMotor->setEncoderUnits(units);
+}
+
+void SkidSteerModel::setGearing(AbstractMotor::gearset gearset)
+{
+	leftSideMotor->setGearing(gearset);
+	rightSideMotor->setGearing(gearset);
+}
+
+void SkidSteerModel::setMaxVelocity(double imaxVelocity)
+{
+	maxVelocity = imaxVelocity;
+}
+
+double SkidSteerModel::getMaxVelocity() const
+{
+	return maxVelocity;
+}
+
+void SkidSteerModel::setMaxVoltage(double imaxVoltage)
+{
+	maxVoltage = imaxVoltage;
+}
+
+double SkidSteerModel::getMaxVoltage() const
+{
+	return maxVoltage;
+}
+
+std::shared_ptr<AbstractMotor> SkidSteerModel::getLeftSideMotor() const
+{
+	return leftSideMotor;
+}
+
+std::shared_ptr<AbstractMotor> SkidSteerModel::getRightSideMotor() const
+{
+	return rightSideMotor;
+}
+
+namespace
+{
+
+// okapi's IterativePosPIDController reduced to what the chassis uses.
+struct SimPid
+{
+	IterativePosPIDController::Gains gains;
+	SettledUtil settled{std::make_unique<Timer>()};
+	double target = 0;
+	double error = 0;
+	double last_error = 0;
+	double integral = 0;
+	bool disabled = true;
+
+	double step(double reading)
+	{
+		if (disabled)
+		{
+			return 0;
+		}
+		error = target - reading;
+		integral += error;
+		double out = gains.kP * error + gains.kI * integral + gains.kD * (error - last_error) + gains.kBias;
+		last_error = error;
+		return std::clamp(out, -1.0, 1.0);
+	}
+
+	void reset(double reading)
+	{
+		target = reading;
+		error = 0;
+		last_error = 0;
+		integral = 0;
+		settled.reset();
+	}
+
+	bool is_settled()
+	{
+		return disabled || settled.isSettled(error);
+	}
+};
+
+class SimChassisController : public ChassisController
+{
+	public:
+	SimChassisController(std::shared_ptr<SkidSteerModel> imodel, ChassisScales iscales,
+	                     AbstractMotor::GearsetRatioPair ipair, bool iuse_pid,
+	                     const IterativePosPIDController::Gains& idistance,
+	                     const IterativePosPIDController::Gains& iturn,
+	                     const IterativePosPIDController::Gains& iangle)
+	    : chassis_model(std::move(imodel)), scales(std::move(iscales)), pair(ipair), use_pid(iuse_pid)
+	{
+		distance.gains = idistance;
+		turn.gains = iturn;
+		angle.gains = iangle;
+		chassis_model->setEncoderUnits(AbstractMotor::encoderUnits::counts);
+		if (use_pid)
+		{
+			pros::c::task_create(&SimChassisController::trampoline, this, TASK_PRIORITY_DEFAULT,
+			                     TASK_STACK_DEPTH_DEFAULT, "ChassisControllerPID");
+		}
+	}
+
+	void moveDistance(QLength itarget) override
+	{
+		moveDistanceAsync(itarget);
+		waitUntilSettled();
+	}
+
+	void moveRaw(double itarget) override
+	{
+		moveRawAsync(itarget);
+		waitUntilSettled();
+	}
+
+	void moveDistanceAsync(QLength itarget) override
+	{
+		moveRawAsync(itarget.convert(meter) * scales.straight * pair.ratio);
+	}
+
+	void moveRawAsync(double itarget) override
+	{
+		sim::trace("chassis move %.0f counts", itarget);
+		auto enc = chassis_model->getSensorVals();
+		if (use_pid)
+		{
+			distance.reset((enc[0] + enc[1]) / 2.0);
+			angle.reset(enc[0] - enc[1]);
+			distance.target += itarget;
+			distance.disabled = false;
+			angle.disabled = false;
+			turn.disabled = true;
+			mode = Mode::distance;
+		}
+		else
+		{
+			chassis_model->getLeftSideMotor()->moveRelative(itarget, chassis_model->getMaxVelocity());
+			chassis_model->getRightSideMotor()->moveRelative(itarget, chassis_model->getMaxVelocity());
+			mode = Mode::distance;
+		}
+	}
+
+	void turnAngle(QAngle idegTarget) override
+	{
+		turnAngleAsync(idegTarget);
+		waitUntilSettled();
+	}
+
+	void turnRaw(double idegTarget) override
+	{
+		turnRawAsync(idegTarget);
+		waitUntilSettled();
+	}
+
+	void turnAngleAsync(QAngle idegTarget) override
+	{
+		// wheel degrees per robot degree, in encoder counts
+		turnRawAsync(idegTarget.convert(degree) * scales.turn * pair.ratio * scales.tpr / 360.0);
+	}
+
+	void turnRawAsync(double idegTarget) override
+	{
+		double target = mirrored ? -idegTarget : idegTarget;
+		sim::trace("chassis turn %.0f counts", target);
+		auto enc = chassis_model->getSensorVals();
+		if (use_pid)
+		{
+			turn.reset((enc[0] - enc[1]) / 2.0);
+			turn.target += target;
+			turn.disabled = false;
+			distance.disabled = true;
+			angle.disabled = true;
+			mode = Mode::turn;
+		}
+		else
+		{
+			chassis_model->getLeftSideMotor()->moveRelative(target, chassis_model->getMaxVelocity());
+			chassis_model->getRightSideMotor()->moveRelative(-target, chassis_model->getMaxVelocity());
+			mode = Mode::turn;
+		}
+	}
+
+	void setTurnsMirrored(bool ishouldMirror) override
+	{
+		mirrored = ishouldMirror;
+	}
+
+	bool isSettled() override
+	{
+		if (mode == Mode::none)
+		{
+			return true;
+		}
+		if (use_pid)
+		{
+			return mode == Mode::distance ? distance.is_settled() && angle.is_settled() : turn.is_settled();
+		}
+		auto l = chassis_model->getLeftSideMotor();
+		auto r = chassis_model->getRightSideMotor();
+		return std::abs(l->getTargetPosition() - l->getPosition()) < 10 &&
+		       std::abs(r->getTargetPosition() - r->getPosition()) < 10 && std::abs(l->getActualVelocity()) < 2 &&
+		       std::abs(r->getActualVelocity()) < 2;
+	}
+
+	void waitUntilSettled() override
+	{
+		while (!isSettled())
+		{
+			pros::c::task_delay(10);
+		}
+		stop();
+	}
+
+	void stop() override
+	{
+		mode = Mode::none;
+		distance.disabled = true;
+		angle.disabled = true;
+		turn.disabled = true;
+		chassis_model->stop();
+	}
+
+	void setMaxVelocity(double imaxVelocity) override
+	{
+		chassis_model->setMaxVelocity(imaxVelocity);
+	}
+
+	double getMaxVelocity() const override
+	{
+		return chassis_model->getMaxVelocity();
+	}
+
+	ChassisScales getChassisScales() const override
+	{
+		return scales;
+	}
+
+	AbstractMotor::GearsetRatioPair getGearsetRatioPair() const override
+	{
+		return pair;
+	}
+
+	std::shared_ptr<ChassisModel> getModel() override
+	{
+		return chassis_model;
+	}
+
+	ChassisModel& model() override
+	{
+		return *chassis_model;
+	}
+
+	private:
+	enum class Mode
+	{
+		none,
+		distance,
+		turn
+	};
+
+	static void trampoline(void* self)
+	{
+		static_cast<SimChassisController*>(self)->loop();
+	}
+
+	void loop()
+	{
+		std::uint32_t now = pros::c::millis();
+		while (true)
+		{
+			if (mode != Mode::none)
+			{
+				auto enc = chassis_model->getSensorVals();
+				if (mode == Mode::distance)
+				{
+					double forward = distance.step((enc[0] + enc[1]) / 2.0);
+					double yaw = angle.step(enc[0] - enc[1]);
+					chassis_model->driveVector(forward, yaw);
+				}
+				else
+				{
+					chassis_model->rotate(turn.step((enc[0] - enc[1]) / 2.0));
+				}
+			}
+			pros::c::task_delay_until(&now, 10);
+		}
+	}
+
+	std::shared_ptr<SkidSteerModel> chassis_model;
+	ChassisScales scales;
+	AbstractMotor::GearsetRatioPair pair;
+	bool use_pid;
+	bool mirrored = false;
+	Mode mode = Mode::none;
+	SimPid distance;
+	SimPid angle;
+	SimPid turn;
+};
+
+class SimAsyncPosController : public AsyncPositionController<double, double>
+{
+	public:
+	SimAsyncPosController(std::shared_ptr<AbstractMotor> imotor, double imaxVelocity)
+	    : motor(std::move(imotor)), max_velocity(imaxVelocity)
+	{
+	}
+
+	void setTarget(double itarget) override
+	{
+		target = itarget;
+		if (!disabled)
+		{
+			motor->moveAbsolute(target, max_velocity);
+		}
+	}
+
+	void controllerSet(double ivalue) override
+	{
+		setTarget(ivalue);
+	}
+
+	double getTarget() override
+	{
+		return target;
+	}
+
+	double getProcessValue() const override
+	{
+		return motor->getPosition();
+	}
+
+	double getError() const override
+	{
+		return target - motor->getPosition();
+	}
+
+	bool isSettled() override
+	{
+		return disabled || settled->isSettled(getError());
+	}
+
+	void reset() override
+	{
+		target = motor->getPosition();
+		settled->reset();
+	}
+
+	void flipDisable() override
+	{
+		flipDisable(!disabled);
+	}
+
+	void flipDisable(bool iisDisabled) override
+	{
+		disabled = iisDisabled;
+		if (disabled)
+		{
+			motor->moveVelocity(0);
+		}
+		else
+		{
+			motor->moveAbsolute(target, max_velocity);
+		}
+	}
+
+	bool isDisabled() const override
+	{
+		return disabled;
+	}
+
+	void waitUntilSettled() override
+	{
+		while (!isSettled())
+		{
+			pros::c::task_delay(10);
+		}
+	}
+
+	void tarePosition() override
+	{
+		motor->tarePosition();
+	}
+
+	void setMaxVelocity(std::int32_t imaxVelocity) override
+	{
+		max_velocity = imaxVelocity;
+		motor->modifyProfiledVelocity(imaxVelocity);
+	}
+
+	private:
+	std::shared_ptr<AbstractMotor> motor;
+	std::unique_ptr<SettledUtil> settled = TimeUtilFactory::createDefault().getSettledUtil();
+	double target = 0;
+	double max_velocity;
+	bool disabled = false;
+};
+
+}  // namespace
+
+ChassisControllerBuilder::ChassisControllerBuilder(const std::shared_ptr<Logger>& ilogger) : logger(ilogger)
+{
+}
+
+ChassisControllerBuilder& ChassisControllerBuilder::withMotors(const Motor& ileft, const Motor& iright)
+{
+	return withMotors(std::shared_ptr<AbstractMotor>(std::make_shared<Motor>(ileft)),
+	                  std::shared_ptr<AbstractMotor>(std::make_shared<Motor>(iright)));
+}
+
+ChassisControllerBuilder& ChassisControllerBuilder::withMotors(const MotorGroup& ileft, const MotorGroup& iright)
+{
+	return withMotors(std::shared_ptr<AbstractMotor>(std::make_shared<MotorGroup>(ileft)),
+	                  std::shared_ptr<AbstractMotor>(std::make_shared<MotorGroup>(iright)));
+}
+
+ChassisControllerBuilder& ChassisControllerBuilder::withMotors(const std::shared_ptr<AbstractMotor>& ileft,
+                                                               const std::shared_ptr<AbstractMotor>& iright)
+{
+	hasMotors = true;
+	driveMode = DriveMode::SkidSteer;
+	skidSteerMotors = {ileft, iright};
+	if (!sensorsSetByUser)
+	{
+		leftSensor = ileft->getEncoder();
+		rightSensor = iright->getEncoder();
+	}
+	return *this;
+}
+
+ChassisControllerBuilder& ChassisControllerBuilder::withGains(const IterativePosPIDController::Gains& idistanceGains,
+                                                              const IterativePosPIDController::Gains& iturnGains)
+{
+	return withGains(idistanceGains, iturnGains, iturnGains);
+}
+
+ChassisControllerBuilder& ChassisControllerBuilder::withGains(const IterativePosPIDController::Gains& idistanceGains,
+                                                              const IterativePosPIDController::Gains& iturnGains,
+                                                              const IterativePosPIDController::Gains& iangleGains)
+{
+	hasGains = true;
+	distanceGains = idistanceGains;
+	turnGains = iturnGains;
+	angleGains = iangleGains;
+	return *this;
+}
+
+ChassisControllerBuilder& ChassisControllerBuilder::withDimensions(const AbstractMotor::GearsetRatioPair& igearset,
+                                                                   const ChassisScales& iscales)
+{
+	gearset = igearset;
+	driveScales = iscales;
+	if (!differentOdomScales)
+	{
+		odomScales = iscales;
+	}
+	if (!maxVelSetByUser)
+	{
+		maxVelocity = toUnderlyingType(igearset.internalGearset);
+	}
+	return *this;
+}
+
+ChassisControllerBuilder& ChassisControllerBuilder::withMaxVelocity(double imaxVelocity)
+{
+	maxVelSetByUser = true;
+	maxVelocity = imaxVelocity;
+	return *this;
+}
+
+ChassisControllerBuilder& ChassisControllerBuilder::withMaxVoltage(double imaxVoltage)
+{
+	maxVoltage = imaxVoltage;
+	return *this;
+}
+
+std::shared_ptr<ChassisController> ChassisControllerBuilder::build()
+{
+	if (!hasMotors)
+	{
+		throw std::runtime_error("ChassisControllerBuilder: No motors given.");
+	}
+	if (gearset.internalGearset == AbstractMotor::gearset::invalid)
+	{
+		throw std::runtime_error("ChassisControllerBuilder: No gearset given.");
+	}
+
+	sim::DriveSide left;
+	sim::DriveSide right;
+	collect_ports(skidSteerMotors.left, left.ports);
+	collect_ports(skidSteerMotors.right, right.ports);
+	sim::set_drive(left, right, driveScales.wheelDiameter.convert(meter), driveScales.wheelTrack.convert(meter),
+	               gearset.ratio);
+
+	skidSteerMotors.left->setGearing(gearset.internalGearset);
+	skidSteerMotors.right->setGearing(gearset.internalGearset);
+	auto model = std::make_shared<SkidSteerModel>(skidSteerMotors.left, skidSteerMotors.right, leftSensor,
+	                                              rightSensor, maxVelocity, maxVoltage);
+	return std::make_shared<SimChassisController>(model, driveScales, gearset, hasGains, distanceGains, turnGains,
+	                                              angleGains);
+}
+
+AsyncPosControllerBuilder::AsyncPosControllerBuilder(const std::shared_ptr<Logger>& ilogger) : logger(ilogger)
+{
+}
+
+AsyncPosControllerBuilder& AsyncPosControllerBuilder::withMotor(const Motor& imotor)
+{
+	return withMotor(std::shared_ptr<AbstractMotor>(std::make_shared<Motor>(imotor)));
+}
+
+AsyncPosControllerBuilder& AsyncPosControllerBuilder::withMotor(const MotorGroup& imotor)
+{
+	return withMotor(std::shared_ptr<AbstractMotor>(std::make_shared<MotorGroup>(imotor)));
+}
+
+AsyncPosControllerBuilder& AsyncPosControllerBuilder::withMotor(const std::shared_ptr<AbstractMotor>& imotor)
+{
+	hasMotors = true;
+	motor = imotor;
+	if (!maxVelSetByUser)
+	{
+		maxVelocity = toUnderlyingType(imotor->getGearing());
+	}
+	return *this;
+}
+
+AsyncPosControllerBuilder& AsyncPosControllerBuilder::withMaxVelocity(double imaxVelocity)
+{
+	maxVelSetByUser = true;
+	maxVelocity = imaxVelocity;
+	return *this;
+}
+
+std::shared_ptr<AsyncPositionController<double, double>> AsyncPosControllerBuilder::build()
+{
+	if (!hasMotors)
+	{
+		throw std::runtime_error("AsyncPosControllerBuilder: No motors given.");
+	}
+	return std::make_shared<SimAsyncPosController>(motor, maxVelocity);
+}
+
+}  // namespace okapi
@@ -0,0 +1,263 @@
+#include "api.h"
+#include "sim/sim.hpp"
+#include "world.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+void initialize(void);
+void competition_initialize(void);
+void autonomous(void);
+void opcontrol(void);
+}
+
+/**
+ * Runs one competition mode of the robot selected by BUILD_TARGET.
+ *
+ *   bin/SKAR_n [--auton N [--period MS]] [--opcontrol] [--disabled MS] [--limit MS] [--trace] [--pits] [--imu MS]
+ *              [--start X,Y,DEG] [--goal X,Y,COLOR]... [--platform X,Y,DEG]
+ *              [--usd DIR] [--driver FILE]
+ *
+ * Lengths are meters, angles degrees counter-clockwise from +x. The default
+ * field puts a yellow goal 1.3 m in front of the robot, which the match
+ * autons rush, and for skills (--auton 0) a platform where the SKAR_2 route
+ * ends up balancing. Any --goal or --platform replaces the matching default.
+ * --usd puts an SD card in the brain, backed by a folder on this computer.
+ * --disabled sits the robot on the field for MS after initialize(), running
+ * competition_initialize() on its own task and deleting it when the mode
+ * starts, as the field controller does.
+ * --pits runs with no competition control connected, as on the bench.
+ * --imu makes an IMU reset take MS to calibrate instead of 2000.
+ * --period runs the auton on its own task and deletes it after MS, wherever
+ * it is, then runs opcontrol(), as the field does when the autonomous period
+ * ends.
+ * --driver plays a script into the master controller, one line per change:
+ *
+ *   MS LX LY RX RY BUTTONS     e.g.  1500 0 127 -40 0 R1+B     or  3000 0 0 0 0 -
+ *
+ * holding the sticks and buttons (L1 L2 R1 R2 UP DOWN LEFT RIGHT X B Y A,
+ * joined by +, - for none) from MS until the next line. # starts a comment.
+ *
+ * Exit codes: 0 the mode returned (or opcontrol ran out the clock), 1 bad
+ * arguments, 2 the time limit was reached, 3 every task blocked forever.
+ */
+
+namespace
+{
+
+sim::Config the_config;
+
+void usage()
+{
+	std::fprintf(stderr, "usage: SKAR_n [--auton N [--period MS]] [--opcontrol] [--disabled MS] [--limit MS] [--trace] [--pits] [--imu MS]\n"
+	                     "              [--start X,Y,DEG] [--goal X,Y,COLOR]... [--platform X,Y,DEG]\n"
+	                     "              [--usd DIR] [--driver FILE]\n");
+	std::exit(1);
+}
+
+void parse_triple(const char* arg, double& a, double& b, double& c)
+{
+	if (arg == nullptr || std::sscanf(arg, "%lf,%lf,%lf", &a, &b, &c) != 3)
+	{
+		usage();
+	}
+}
+
+const char* const BUTTON_NAMES[] = {"L1", "L2", "R1", "R2", "UP", "DOWN", "LEFT", "RIGHT", "X", "B", "Y", "A"};
+
+void load_driver(const char* path, std::vector<sim::DriverFrame>& frames)
+{
+	FILE* file = path != nullptr ? std::fopen(path, "r") : nullptr;
+	if (file == nullptr)
+	{
+		std::fprintf(stderr, "can't read driver script %s\n", path != nullptr ? path : "");
+		std::exit(1);
+	}
+	char line[256];
+	int number = 0;
+	while (std::fgets(line, sizeof(line), file) != nullptr)
+	{
+		number++;
+		if (char* comment = std::strchr(line, '#'))
+		{
+			*comment = '\0';
+		}
+		sim::DriverFrame frame{};
+		char buttons[128];
+		int fields = std::sscanf(line, "%u %d %d %d %d %127s", &frame.time, &frame.analog[0], &frame.analog[1],
+		                         &frame.analog[2], &frame.analog[3], buttons);
+		if (fields <= 0)
+		{
+			continue;
+		}
+		if (fields != 6 || (!frames.empty() && frame.time < frames.back().time))
+		{
+			std::fprintf(stderr, "%s:%d: expected MS LX LY RX RY BUTTONS in time order\n", path, number);
+			std::exit(1);
+		}
+		for (char* name = std::strtok(buttons, "+"); name != nullptr; name = std::strtok(nullptr, "+"))
+		{
+			if (std::strcmp(name, "-") == 0)
+			{
+				continue;
+			}
+			int bit = 0;
+			while (bit < 12 && std::strcmp(name, BUTTON_NAMES[bit]) != 0)
+			{
+				bit++;
+			}
+			if (bit == 12)
+			{
+				std::fprintf(stderr, "%s:%d: unknown button %s\n", path, number, name);
+				std::exit(1);
+			}
+			frame.digital |= 1u << bit;
+		}
+		frames.push_back(frame);
+	}
+	std::fclose(file);
+}
+
+}  // namespace
+
+namespace sim
+{
+
+Config& config()
+{
+	return the_config;
+}
+
+}  // namespace sim
+
+int main(int argc, char** argv)
+{
+	sim::Config& cfg = the_config;
+	bool goals_given = false;
+	bool platform_given = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (std::strcmp(arg, "--auton") == 0 && value != nullptr)
+		{
+			cfg.auton = std::atoi(value);
+			i++;
+		}
+		else if (std::strcmp(arg, "--opcontrol") == 0)
+		{
+			cfg.opcontrol = true;
+		}
+		else if (std::strcmp(arg, "--disabled") == 0 && value != nullptr)
+		{
+			cfg.disabled = std::strtoul(value, nullptr, 10);
+			i++;
+		}
+		else if (std::strcmp(arg, "--imu") == 0 && value != nullptr)
+		{
+			cfg.imu_calibration = std::strtoul(value, nullptr, 10);
+			i++;
+		}
+		else if (std::strcmp(arg, "--period") == 0 && value != nullptr)
+		{
+			cfg.auton_period = std::strtoul(value, nullptr, 10);
+			i++;
+		}
+		else if (std::strcmp(arg, "--limit") == 0 && value != nullptr)
+		{
+			cfg.time_limit = std::strtoul(value, nullptr, 10);
+			i++;
+		}
+		else if (std::strcmp(arg, "--usd") == 0 && value != nullptr)
+		{
+			cfg.usd = value;
+			i++;
+		}
+		else if (std::strcmp(arg, "--driver") == 0)
+		{
+			load_driver(value, cfg.driver);
+			i++;
+		}
+		else if (std::strcmp(arg, "--trace") == 0)
+		{
+			cfg.trace = true;
+		}
+		else if (std::strcmp(arg, "--pits") == 0)
+		{
+			cfg.pits = true;
+		}
+		else if (std::strcmp(arg, "--start") == 0)
+		{
+			double deg;
+			parse_triple(value, cfg.start.x, cfg.start.y, deg);
+			cfg.start.theta = deg * M_PI / 180.0;
+			i++;
+		}
+		else if (std::strcmp(arg, "--goal") == 0)
+		{
+			double x, y, color;
+			parse_triple(value, x, y, color);
+			cfg.goals.push_back({x, y, static_cast<int>(color)});
+			goals_given = true;
+			i++;
+		}
+		else if (std::strcmp(arg, "--platform") == 0)
+		{
+			double deg;
+			parse_triple(value, cfg.platform.x, cfg.platform.y, deg);
+			cfg.platform.axis = deg * M_PI / 180.0;
+			cfg.platform.enabled = true;
+			platform_given = true;
+			i++;
+		}
+		else
+		{
+			usage();
+		}
+	}
+
+	if (!goals_given)
+	{
+		cfg.goals.push_back({cfg.start.x + 1.3 * std::cos(cfg.start.theta),
+		                     cfg.start.y + 1.3 * std::sin(cfg.start.theta), 1});
+	}
+	if (!platform_given && cfg.auton == 0 && !cfg.opcontrol)
+	{
+		cfg.platform.enabled = true;
+		cfg.platform.x = cfg.start.x - 0.7;
+		cfg.platform.y = cfg.start.y - 0.2;
+		cfg.platform.axis = cfg.start.theta + M_PI / 2;
+	}
+
+	sim::world().robot = cfg.start;
+	sim::kernel_start("User Initialization (PROS)");
+	initialize();
+	if (cfg.disabled > 0)
+	{
+		pros::Task comp_init([] { competition_initialize(); }, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT,
+		                     "User Comp. Init. (PROS)");
+		pros::delay(cfg.disabled);
+		comp_init.remove();
+	}
+	if (cfg.auton_period > 0 && !cfg.opcontrol)
+	{
+		pros::Task auton([] { autonomous(); }, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT,
+		                 "User Autonomous (PROS)");
+		pros::delay(cfg.auton_period);
+		auton.remove();
+		cfg.opcontrol = true;
+	}
+	if (cfg.opcontrol)
+	{
+		sim::set_task_name("User Operator Control (PROS)");
+		opcontrol();
+		sim::finish(0, "opcontrol returned");
+	}
+	sim::set_task_name("User Autonomous (PROS)");
+	autonomous();
+	sim::finish(0, "autonomous finished");
+}
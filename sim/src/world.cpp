@@ -0,0 +1,264 @@
+#include "world.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Tank-drive physics.
+ *
+ * Each motor's output shaft chases a target speed with a first-order lag; the
+ * target comes from the last command (voltage, velocity or a profiled move to
+ * an absolute position). Drive motors registered by the chassis builder are
+ * averaged per side into wheel speeds, which integrate into a field pose.
+ * Wheel slip, battery sag and mechanism loads are not modelled.
+ */
+
+namespace sim
+{
+
+namespace
+{
+
+const double DT = 0.001;
+const double SENSOR_OFFSET = 0.2;  // meters from the robot centre to the front distance sensor
+const double SENSOR_RANGE = 2.0;
+const std::uint32_t DISTANCE_PERIOD = 33;  // ms between distance sensor readings
+const std::uint32_t DISTANCE_LAG = 20;  // ms a reading trails the robot
+const double CLAW_REACH = 0.035;  // meters from the distance sensor at which a goal is in the front claw
+
+const double TAU_DRIVE = 0.06;  // seconds to reach ~63% of a commanded speed
+const double TAU_BRAKE = 0.03;
+const double TAU_COAST = 0.4;
+const double PROFILE_ACCEL = 12;  // output shaft rev/s^2 for moveAbsolute/moveRelative
+const double STALL_CURRENT = 2500;
+
+World the_world;
+
+double target_rpm(MotorState& m)
+{
+	double max = max_rpm(m.gearset);
+	switch (m.mode)
+	{
+		case MotorMode::VOLTAGE:
+			return std::clamp(m.command / 12000.0, -1.0, 1.0) * max;
+		case MotorMode::VELOCITY:
+			return std::clamp(m.command, -max, max);
+		case MotorMode::ABSOLUTE:
+		{
+			double err_rev = (m.target - m.position) / 360.0;
+			double limit = std::min(std::abs(m.command), max);
+			double v = std::min(limit, std::sqrt(2 * PROFILE_ACCEL * std::abs(err_rev)) * 60);
+			if (std::abs(err_rev) < 0.5 / 360.0)
+			{
+				return 0;
+			}
+			return err_rev > 0 ? v : -v;
+		}
+	}
+	return 0;
+}
+
+void step_motor(MotorState& m)
+{
+	double target = target_rpm(m);
+	double tau = TAU_DRIVE;
+	bool stopping = target == 0 && (m.mode != MotorMode::ABSOLUTE);
+	if (stopping)
+	{
+		tau = m.brake == 0 ? TAU_COAST : TAU_BRAKE;
+	}
+	double max = max_rpm(m.gearset);
+	m.velocity += (target - m.velocity) * DT / tau;
+	m.position += m.velocity / 60.0 * 360.0 * DT;
+	m.current = std::min(STALL_CURRENT, std::abs(target - m.velocity) / max * STALL_CURRENT + 100);
+	m.voltage = m.mode == MotorMode::VOLTAGE ? m.command : target / max * 12000.0;
+}
+
+double side_speed(const DriveSide& side)
+{
+	if (side.ports.empty())
+	{
+		return 0;
+	}
+	double sum = 0;
+	for (int port : side.ports)
+	{
+		double v = the_world.motors[std::abs(port)].velocity;
+		sum += port < 0 ? -v : v;
+	}
+	double wheel_rpm = sum / side.ports.size() / the_world.ratio;
+	return wheel_rpm / 60.0 * M_PI * the_world.wheel_diameter;
+}
+
+void step_platform()
+{
+	const Platform& p = config().platform;
+	World& w = the_world;
+	double target_pitch = 0;
+	if (p.enabled)
+	{
+		double dx = w.robot.x - p.x;
+		double dy = w.robot.y - p.y;
+		double s = dx * std::cos(p.axis) + dy * std::sin(p.axis);
+		double across = -dx * std::sin(p.axis) + dy * std::cos(p.axis);
+		bool on = std::abs(s) <= p.half_length && std::abs(across) <= p.half_width;
+
+		// The seesaw follows the robot's centre of mass across the pivot.
+		double want = p.max_tilt;
+		if (on)
+		{
+			want = -std::clamp(s / p.level_band, -1.0, 1.0) * p.max_tilt;
+		}
+		double max_step = 60.0 * DT;
+		w.platform_tilt += std::clamp(want - w.platform_tilt, -max_step, max_step);
+		if (on)
+		{
+			target_pitch = w.platform_tilt * std::cos(w.robot.theta - p.axis);
+		}
+	}
+	double last = w.pitch;
+	w.pitch += (target_pitch - w.pitch) * DT / 0.08;
+	w.pitch_rate = (w.pitch - last) / DT;
+}
+
+void step_distance()
+{
+	World& w = the_world;
+	std::uint32_t t = now();
+	double d = ray_to_goal(w.robot, SENSOR_RANGE);
+	w.true_distance_mm[t % w.true_distance_mm.size()] = d < SENSOR_RANGE ? std::max(d * 1000.0, 0.0) : 9999;
+	if (w.goal_contact == 0 && d <= CLAW_REACH)
+	{
+		w.goal_contact = t;
+		trace("goal in the front claw");
+	}
+	if (t % DISTANCE_PERIOD != 0 || t < DISTANCE_LAG)
+	{
+		return;
+	}
+	double mm = w.true_distance_mm[(t - DISTANCE_LAG) % w.true_distance_mm.size()];
+	double last = w.distance_mm;
+	w.distance_mm = mm;
+	w.distance_rate = (mm < 9999 && last < 9999) ? (last - mm) / 1000.0 / (DISTANCE_PERIOD * DT) : 0;
+}
+
+// Plays the --driver script into the master controller
+void step_driver()
+{
+	static std::size_t next = 0;
+	const std::vector<DriverFrame>& frames = config().driver;
+	while (next < frames.size() && frames[next].time <= now())
+	{
+		ControllerState& c = the_world.controllers[0];
+		for (int ch = 0; ch < 4; ch++)
+		{
+			c.analog[ch] = frames[next].analog[ch];
+		}
+		c.digital = frames[next].digital;
+		next++;
+	}
+}
+
+}  // namespace
+
+World& world()
+{
+	return the_world;
+}
+
+double max_rpm(int gearset)
+{
+	switch (gearset)
+	{
+		case 0:
+			return 100;
+		case 2:
+			return 600;
+		default:
+			return 200;
+	}
+}
+
+double ray_to_goal(const Pose& from, double max_range)
+{
+	double c = std::cos(from.theta);
+	double s = std::sin(from.theta);
+	double ox = from.x + c * SENSOR_OFFSET;
+	double oy = from.y + s * SENSOR_OFFSET;
+	double best = max_range;
+	for (const Goal& g : config().goals)
+	{
+		// ray/circle intersection, ray direction is a unit vector
+		double fx = ox - g.x;
+		double fy = oy - g.y;
+		double b = fx * c + fy * s;
+		double k = fx * fx + fy * fy - g.radius * g.radius;
+		double disc = b * b - k;
+		if (disc < 0)
+		{
+			continue;
+		}
+		double t = -b - std::sqrt(disc);
+		if (k <= 0)
+		{
+			t = 0;  // sensor is already touching the goal
+		}
+		if (t >= 0 && t < best)
+		{
+			best = t;
+		}
+	}
+	return best;
+}
+
+void set_drive(const DriveSide& left, const DriveSide& right, double wheel_diameter, double wheel_track,
+               double ratio)
+{
+	the_world.left = left;
+	the_world.right = right;
+	the_world.wheel_diameter = wheel_diameter;
+	the_world.wheel_track = wheel_track;
+	the_world.ratio = ratio;
+}
+
+void world_step()
+{
+	World& w = the_world;
+	step_driver();
+	for (std::size_t port = 1; port < w.motors.size(); port++)
+	{
+		step_motor(w.motors[port]);
+	}
+
+	if (w.wheel_track > 0)
+	{
+		double vl = side_speed(w.left);
+		double vr = side_speed(w.right);
+		double v = (vl + vr) / 2;
+		double omega = (vr - vl) / w.wheel_track;
+		w.robot.theta += omega * DT;
+		w.robot.x += v * std::cos(w.robot.theta) * DT;
+		w.robot.y += v * std::sin(w.robot.theta) * DT;
+		w.yaw_rate = -omega * 180.0 / M_PI;
+	}
+
+	step_platform();
+	step_distance();
+}
+
+Pose pose()
+{
+	return the_world.robot;
+}
+
+double pitch()
+{
+	return the_world.pitch;
+}
+
+std::uint32_t goal_contact()
+{
+	return the_world.goal_contact;
+}
+
+}  // namespace sim
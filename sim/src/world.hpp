@@ -0,0 +1,97 @@
+#ifndef SKAR_SIM_WORLD_HPP
+#define SKAR_SIM_WORLD_HPP
+
+#include "sim/sim.hpp"
+
+#include <array>
+#include <string>
+
+/**
+ * Device state shared between the physics model and the PROS device API.
+ * Smart ports are indexed 1-21, ADI ports 'A'-'H' as 0-7.
+ */
+namespace sim
+{
+
+enum class MotorMode
+{
+	VOLTAGE,
+	VELOCITY,
+	ABSOLUTE
+};
+
+struct MotorState
+{
+	int gearset = 1;  // pros::motor_gearset_e_t
+	int units = 0;  // pros::motor_encoder_units_e_t
+	int brake = 0;  // pros::motor_brake_mode_e_t
+	MotorMode mode = MotorMode::VOLTAGE;
+	double command = 0;  // mV in VOLTAGE mode, rpm otherwise
+	double target = 0;  // degrees, ABSOLUTE mode
+	double velocity = 0;  // rpm at the output shaft
+	double position = 0;  // degrees at the output shaft
+	double zero = 0;  // degrees subtracted from position
+	double current = 0;  // mA
+	double voltage = 0;  // mV
+};
+
+struct ImuState
+{
+	std::uint32_t calibrated_at = 0;  // virtual ms at which a reset finishes
+	double rotation_offset = 0;
+	double pitch_offset = 0;
+	double roll_offset = 0;
+	double yaw_offset = 0;
+};
+
+struct ControllerState
+{
+	std::array<std::int32_t, 4> analog{};
+	std::uint32_t digital = 0;  // bit per pros::controller_digital_e_t - DIGITAL_L1
+	std::uint32_t last_digital = 0;
+	std::array<std::string, 3> lines;
+};
+
+struct VisionState
+{
+	int zero_point = 0;  // pros::vision_zero_e_t
+};
+
+struct World
+{
+	std::array<MotorState, 22> motors;
+	std::array<ImuState, 22> imus;
+	std::array<VisionState, 22> visions;
+	std::array<std::int32_t, 8> adi{};
+	std::array<ControllerState, 2> controllers;
+
+	Pose robot;
+	double pitch = 0;  // degrees, nose up positive
+	double pitch_rate = 0;  // degrees per second
+	double yaw_rate = 0;  // degrees per second, clockwise positive like the IMU
+	double platform_tilt = 0;  // degrees, near side down positive
+
+	DriveSide left;
+	DriveSide right;
+	double wheel_diameter = 0;
+	double wheel_track = 0;
+	double ratio = 1;
+
+	// distance sensor readings are derived from the robot pose: a new one
+	// every DISTANCE_PERIOD ms, of where the goal was DISTANCE_LAG ms before
+	double distance_mm = 9999;
+	double distance_rate = 0;  // m/s, positive when the object approaches
+	std::array<double, 64> true_distance_mm{};  // by ms, for the lag
+	std::uint32_t goal_contact = 0;  // virtual ms a goal first came into the front claw, 0 if none has
+};
+
+World& world();
+
+double max_rpm(int gearset);
+
+// Distance from the front of the robot to the nearest goal along its heading, in meters.
+double ray_to_goal(const Pose& from, double max_range);
+
+}  // namespace sim
+
+#endif
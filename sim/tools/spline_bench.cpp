@@ -0,0 +1,190 @@
+#include "trajectory.hpp"
+#include "okapi/pathfinder/include/pathfinder/spline.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/**
+ * Compares SplinePath's arc length engine with sampling the way Pathfinder
+ * does it, on a few paths like the robots drive.
+ *
+ *   bin/spline_bench [--reps N]
+ *
+ * For each path it times building the path and generating its trajectory
+ * both ways, and compares every segment's pose with a trajectory sampled
+ * at 1,000,000 points per spline, which stands in for the exact one. The
+ * sampled engine is run at Pathfinder's three sample counts.
+ */
+
+namespace
+{
+
+/*
+	Pathfinder's pf_spline_distance and pf_spline_progress_for_distance on
+	our splines: the length is the sum of sample_count chords, and every
+	distance lookup walks the samples from the start of its spline again.
+*/
+class SampledPath
+{
+public:
+	SampledPath(const std::vector<Waypoint>& waypoints, int samples_) : samples(samples_)
+	{
+		for (size_t i = 0; i + 1 < waypoints.size(); i++)
+		{
+			splines.emplace_back(waypoints[i], waypoints[i + 1]);
+			starts.push_back(total);
+			total += walk(splines.back(), -1);
+		}
+	}
+
+	double length() const { return total; }
+
+	void at(double s, double& x, double& y, double& heading) const
+	{
+		s = std::max(0.0, std::min(s, total));
+		size_t which = 0;
+		while (which + 1 < splines.size() && starts[which + 1] <= s)
+		{
+			which++;
+		}
+		double t = walk(splines[which], s - starts[which]);
+		double dx, dy;
+		splines[which].point(t, x, y);
+		splines[which].derivative(t, dx, dy);
+		heading = std::atan2(dy, dx);
+	}
+
+private:
+	std::vector<HermiteSpline> splines;
+	std::vector<double> starts;
+	double total = 0;
+	int samples;
+
+	// The spline's length if distance < 0, otherwise the parameter distance along it
+	double walk(const HermiteSpline& spline, double distance) const
+	{
+		double sum = 0, last_x, last_y;
+		spline.point(0, last_x, last_y);
+		for (int i = 1; i <= samples; i++)
+		{
+			double t = (double)i / samples;
+			double x, y;
+			spline.point(t, x, y);
+			double step = std::hypot(x - last_x, y - last_y);
+			if (distance >= 0 && sum + step >= distance)
+			{
+				return (i - 1 + (step > 0 ? (distance - sum) / step : 0)) / samples;
+			}
+			sum += step;
+			last_x = x;
+			last_y = y;
+		}
+		return distance < 0 ? sum : 1;
+	}
+};
+
+struct Case
+{
+	const char* name;
+	std::vector<Waypoint> waypoints;
+	PathLimits limits;
+};
+
+const double IN = 0.0254;
+const double DEG = M_PI / 180;
+
+void usage()
+{
+	std::fprintf(stderr, "usage: spline_bench [--reps N]\n");
+	std::exit(1);
+}
+
+template <typename Build>
+double time_us(int reps, Build build, std::vector<Segment>& out)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < reps; i++)
+	{
+		out = build();
+	}
+	std::chrono::duration<double, std::micro> took = std::chrono::steady_clock::now() - start;
+	return took.count() / reps;
+}
+
+// Worst distance and heading difference between matching segments
+void compare(const std::vector<Segment>& a, const std::vector<Segment>& b, double& distance, double& heading)
+{
+	distance = heading = 0;
+	if (a.size() != b.size())
+	{
+		distance = heading = INFINITY;
+		return;
+	}
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		distance = std::max(distance, std::hypot(a[i].x - b[i].x, a[i].y - b[i].y));
+		double turn = std::remainder(a[i].heading - b[i].heading, 2 * M_PI);
+		heading = std::max(heading, std::abs(turn));
+	}
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+	int reps = 20;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--reps") == 0 && i + 1 < argc)
+		{
+			reps = std::max(1, std::atoi(argv[++i]));
+		}
+		else
+		{
+			usage();
+		}
+	}
+
+	PathLimits fast;
+	fast.max_velocity = 1.2;
+	fast.max_acceleration = 2.0;
+	PathLimits sweep;
+	sweep.max_velocity = 0.75;
+	sweep.max_acceleration = 1.5;
+	std::vector<Case> cases = {
+		{"s-curve", {{0, 0, 0}, {1.0, 0.5, 0}, {2.0, 0, 0}}, fast},
+		{"ring sweep",
+		 {{10.7 * IN, 111.5 * IN, -90 * DEG}, {10.7 * IN, 75.7 * IN, -90 * DEG}, {-1.3 * IN, 63.7 * IN, 180 * DEG},
+		  {-61.2 * IN, 63.6 * IN, 180 * DEG}},
+		 sweep},
+		{"hairpin", {{0, 0, 0}, {0.6, 0.3, 90 * DEG}, {0, 0.6, 180 * DEG}}, sweep},
+	};
+
+	std::printf("%-11s %-14s %12s %10s %10s %10s\n", "path", "engine", "length m", "build us", "worst um", "worst deg");
+	for (const Case& c : cases)
+	{
+		std::vector<Segment> exact = profile_path(SampledPath(c.waypoints, 1000000), c.limits);
+		std::vector<Segment> out;
+		double distance, heading;
+
+		double us = time_us(reps, [&] { return generate_trajectory(c.waypoints, c.limits); }, out);
+		compare(out, exact, distance, heading);
+		std::printf("%-11s %-14s %12.9f %10.0f %10.3f %10.6f\n", c.name, "gauss-legendre", SplinePath(c.waypoints).length(),
+		            us, distance * 1e6, heading / DEG);
+
+		for (int samples : {PATHFINDER_SAMPLES_FAST, PATHFINDER_SAMPLES_LOW, PATHFINDER_SAMPLES_HIGH})
+		{
+			char engine[32];
+			std::snprintf(engine, sizeof(engine), "sampled %d", samples);
+			us = time_us(std::max(1, reps * 1000 / samples),
+			             [&] { return profile_path(SampledPath(c.waypoints, samples), c.limits); }, out);
+			compare(out, exact, distance, heading);
+			std::printf("%-11s %-14s %12.9f %10.0f %10.3f %10.6f\n", "", engine, SampledPath(c.waypoints, samples).length(),
+			            us, distance * 1e6, heading / DEG);
+		}
+	}
+	return 0;
+}
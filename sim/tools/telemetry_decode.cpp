@@ -0,0 +1,130 @@
+#include "telemetry_format.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * Turns a telemetry log from the SD card into CSV.
+ *
+ *   bin/telemetry_decode LOG [-o CSV]
+ *
+ * One row per record. Motor columns are named after their smart port. Gaps
+ * in the record sequence, i.e. records the robot had to drop because the
+ * card fell behind, are counted on stderr.
+ */
+
+namespace
+{
+
+void usage()
+{
+	std::fprintf(stderr, "usage: telemetry_decode LOG [-o CSV]\n");
+	std::exit(1);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+	const char* in_path = nullptr;
+	const char* out_path = nullptr;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			out_path = argv[++i];
+		}
+		else if (argv[i][0] != '-' && in_path == nullptr)
+		{
+			in_path = argv[i];
+		}
+		else
+		{
+			usage();
+		}
+	}
+	if (in_path == nullptr)
+	{
+		usage();
+	}
+
+	FILE* in = std::fopen(in_path, "rb");
+	if (in == nullptr)
+	{
+		std::perror(in_path);
+		return 1;
+	}
+	TelemetryHeader header;
+	if (std::fread(&header, sizeof(header), 1, in) != 1 || std::memcmp(header.magic, TELEMETRY_MAGIC, 4) != 0)
+	{
+		std::fprintf(stderr, "%s: not a telemetry log\n", in_path);
+		return 1;
+	}
+	if (header.version != TELEMETRY_VERSION || header.record_size != sizeof(TelemetryRecord))
+	{
+		std::fprintf(stderr, "%s: log version %u with %u byte records, this decoder reads version %u (%u bytes)\n",
+		             in_path, header.version, header.record_size, TELEMETRY_VERSION,
+		             static_cast<unsigned>(sizeof(TelemetryRecord)));
+		return 1;
+	}
+	int motors = header.motors < TELEMETRY_MOTORS ? header.motors : TELEMETRY_MOTORS;
+
+	FILE* out = out_path ? std::fopen(out_path, "w") : stdout;
+	if (out == nullptr)
+	{
+		std::perror(out_path);
+		return 1;
+	}
+	std::fprintf(out, "seq,time,step,flags");
+	for (int m = 0; m < motors; m++)
+	{
+		int port = header.ports[m];
+		std::fprintf(out, ",m%d_mV,m%d_mA,m%d_C,m%d_pos", port, port, port, port);
+	}
+	std::fprintf(out, ",rotation,pitch,roll,distance,distance_confidence\n");
+
+	TelemetryRecord r;
+	unsigned long records = 0;
+	// Two tasks can take numbers in one order and claim slots in the other, so
+	// records may arrive a little out of order: count the gaps in the span of
+	// numbers seen rather than between neighbours.
+	unsigned long out_of_order = 0;
+	uint32_t first_seq = 0;
+	uint32_t last_seq = 0;
+	while (std::fread(&r, sizeof(r), 1, in) == 1)
+	{
+		if (records == 0)
+		{
+			first_seq = last_seq = r.seq;
+		}
+		else if (static_cast<int32_t>(r.seq - last_seq) > 0)
+		{
+			last_seq = r.seq;
+		}
+		else
+		{
+			out_of_order++;
+			if (static_cast<int32_t>(r.seq - first_seq) < 0)
+			{
+				first_seq = r.seq;
+			}
+		}
+		records++;
+
+		std::fprintf(out, "%u,%u,%d,%u", r.seq, r.time, r.step == TELEMETRY_NO_STEP ? -1 : r.step, r.flags);
+		for (int m = 0; m < motors; m++)
+		{
+			std::fprintf(out, ",%d,%d,%d,%.3f", r.voltage[m], r.current[m], r.temperature[m], r.position[m]);
+		}
+		std::fprintf(out, ",%.2f,%.2f,%.2f,%d,%d\n", r.rotation, r.pitch, r.roll, r.distance, r.distance_confidence);
+	}
+	std::fclose(in);
+	if (out != stdout)
+	{
+		std::fclose(out);
+	}
+	unsigned long dropped = records == 0 ? 0 : last_seq - first_seq + 1 - records;
+	std::fprintf(stderr, "%lu records, %lu dropped, %lu out of order\n", records, dropped, out_of_order);
+	return 0;
+}
@@ -0,0 +1,122 @@
+#include "trajectory.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Compares keeping trajectories the way okapi's AsyncMotionProfileController
+ * does with keeping them packed in a TrajectoryStore.
+ *
+ *   bin/trajectory_bench [--track IN]
+ *
+ * Generates a path set like a skills run's, then prints the RAM each way
+ * takes: the controller keeps a left and a right array of Segments per path
+ * in a std::map keyed by name. It then walks every trajectory the way
+ * follow_trajectory does and prints the worst difference the packed floats
+ * make to what it reads (the pose, speed and turn rate at each point) and
+ * to the wheel speeds that gives, for a drive with the given track.
+ */
+
+namespace
+{
+
+const double IN = 0.0254;
+const double DEG = M_PI / 180;
+
+// What the controller allocates per path: the map node, its key and both sides
+size_t okapi_bytes(const std::string& name, size_t length)
+{
+	// red-black tree node links and colour, then key and TrajectoryPair{left, right, length}
+	size_t node = 4 * sizeof(void*) + sizeof(std::string) + 2 * (2 * sizeof(void*)) + sizeof(int);
+	size_t key = name.size() < 16 ? 0 : name.capacity() + 1;
+	return node + key + 2 * length * sizeof(Segment);
+}
+
+void usage()
+{
+	std::fprintf(stderr, "usage: trajectory_bench [--track IN]\n");
+	std::exit(1);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+	double track = 12.4375 * IN;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--track") == 0 && i + 1 < argc)
+		{
+			track = std::atof(argv[++i]) * IN;
+		}
+		else
+		{
+			usage();
+		}
+	}
+
+	PathLimits limits;
+	limits.max_velocity = 0.75;
+	limits.max_acceleration = 1.5;
+	struct Named
+	{
+		const char* name;
+		std::vector<Waypoint> waypoints;
+	};
+	std::vector<Named> set = {
+		{"left goal", {{-15 * IN, 0, 180 * DEG}, {-13.7 * IN, 60.7 * IN, 90 * DEG}}},
+		{"rings", {{-13.7 * IN, 60.7 * IN, 90 * DEG}, {-17.8 * IN, 78.2 * IN, 120 * DEG}, {-47.8 * IN, 78.2 * IN, 180 * DEG}}},
+		{"ring sweep",
+		 {{10.7 * IN, 111.5 * IN, -90 * DEG}, {10.7 * IN, 75.7 * IN, -90 * DEG}, {-1.3 * IN, 63.7 * IN, 180 * DEG},
+		  {-61.2 * IN, 63.6 * IN, 180 * DEG}}},
+		{"field crossing",
+		 {{0, 0, 0}, {1.8, 0.6, 30 * DEG}, {3.0, 1.8, 90 * DEG}, {1.8, 3.0, 180 * DEG}, {0, 2.4, 180 * DEG}}},
+	};
+
+	std::map<std::string, std::vector<Segment>> centres;
+	TrajectoryStore store;
+	size_t okapi = 0, points = 0;
+	std::printf("%-15s %7s %10s\n", "path", "points", "seconds");
+	for (const Named& n : set)
+	{
+		std::vector<Segment> segments = generate_trajectory(n.waypoints, limits);
+		centres[n.name] = segments;
+		store.add(n.name, segments);
+		okapi += okapi_bytes(n.name, segments.size());
+		points += segments.size();
+		std::printf("%-15s %7zu %10.2f\n", n.name, segments.size(), segments.size() * limits.dt);
+	}
+	std::printf("\n%zu points: %zu bytes as left and right Segments in a map, %zu as centre Segments, %zu packed\n",
+	            points, okapi, points * sizeof(Segment), store.bytes());
+	std::printf("packed is %.1fx smaller than the map, %.1fx smaller than centre Segments\n", (double)okapi / store.bytes(),
+	            (double)(points * sizeof(Segment)) / store.bytes());
+
+	double worst_pose = 0, worst_heading = 0, worst_speed = 0, worst_turn = 0, worst_wheel = 0;
+	for (const Named& n : set)
+	{
+		const std::vector<Segment>& c = centres[n.name];
+		const PackedTrajectory& p = store.get(store.find(n.name));
+		for (uint32_t i = 0; i < p.length; i++)
+		{
+			double turn = i + 1 < c.size() ? std::remainder(c[i + 1].heading - c[i].heading, 2 * M_PI) / c[i].dt : 0;
+			double left = c[i].velocity + turn * track / 2;
+			double right = c[i].velocity - turn * track / 2;
+			double packed_left, packed_right;
+			p.wheel_speeds(i, track, packed_left, packed_right);
+
+			worst_pose = std::max(worst_pose, std::hypot(p.x[i] - c[i].x, p.y[i] - c[i].y));
+			worst_heading = std::max(worst_heading, std::abs(std::remainder(p.heading[i] - c[i].heading, 2 * M_PI)));
+			worst_speed = std::max(worst_speed, std::abs(p.velocity[i] - c[i].velocity));
+			worst_turn = std::max(worst_turn, std::abs(p.turn_rate(i) - turn));
+			worst_wheel = std::max({worst_wheel, std::abs(packed_left - left), std::abs(packed_right - right)});
+		}
+	}
+	std::printf("worst difference packed: pose %.2g m, heading %.2g rad, speed %.2g m/s, turn rate %.2g rad/s, "
+	            "wheel speed %.2g m/s\n",
+	            worst_pose, worst_heading, worst_speed, worst_turn, worst_wheel);
+	return 0;
+}
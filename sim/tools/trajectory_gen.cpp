@@ -0,0 +1,216 @@
+#include "trajectory_format.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Generates trajectories ahead of time and writes them out as constexpr
+ * Segment tables, so the robot never generates a path on the brain.
+ *
+ *   bin/trajectory_gen PATHS [-o HEADER] [-b DIR]
+ *
+ * PATHS lists the trajectories of one robot:
+ *
+ *   # comment
+ *   path NAME MAX_VELOCITY MAX_ACCELERATION    (m/s, m/s^2)
+ *   X Y HEADING                                (in, in, deg; one per waypoint)
+ *
+ * in odometry's frame: x forward, y right, heading clockwise. The header
+ * (stdout by default) defines, in namespace paths, float arrays NAME_x,
+ * NAME_y, NAME_heading and NAME_velocity and a PackedTrajectory NAME over
+ * them for each path. paths::all has every one in the order they are
+ * listed, and NAME_id is its index there. With -b each path is also
+ * written to DIR/NAME.traj in the format in trajectory_format.hpp, for
+ * the SD card.
+ */
+
+namespace
+{
+
+const double METERS_PER_INCH = 0.0254;
+
+struct PathSpec
+{
+	std::string name;
+	PathLimits limits;
+	std::vector<Waypoint> waypoints;
+};
+
+void usage()
+{
+	std::fprintf(stderr, "usage: trajectory_gen PATHS [-o HEADER] [-b DIR]\n");
+	std::exit(1);
+}
+
+bool read_paths(const char* file_path, std::vector<PathSpec>& specs)
+{
+	FILE* file = std::fopen(file_path, "r");
+	if (file == nullptr)
+	{
+		std::perror(file_path);
+		return false;
+	}
+	char line[256];
+	int number = 0;
+	bool ok = true;
+	while (ok && std::fgets(line, sizeof(line), file))
+	{
+		number++;
+		char* hash = std::strchr(line, '#');
+		if (hash != nullptr)
+		{
+			*hash = '\0';
+		}
+		char name[64];
+		double a, b, c;
+		if (std::sscanf(line, " path %63s %lf %lf", name, &a, &b) == 3)
+		{
+			PathSpec spec;
+			spec.name = name;
+			spec.limits.max_velocity = a;
+			spec.limits.max_acceleration = b;
+			specs.push_back(spec);
+		}
+		else if (std::sscanf(line, "%lf %lf %lf", &a, &b, &c) == 3 && !specs.empty())
+		{
+			specs.back().waypoints.push_back({a * METERS_PER_INCH, b * METERS_PER_INCH, c * M_PI / 180});
+		}
+		else if (std::strspn(line, " \t\r\n") != std::strlen(line))
+		{
+			std::fprintf(stderr, "%s:%d: expected \"path NAME MAX_VELOCITY MAX_ACCELERATION\" or \"X Y HEADING\"\n",
+			             file_path, number);
+			ok = false;
+		}
+	}
+	std::fclose(file);
+	return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+	const char* in_path = nullptr;
+	const char* out_path = nullptr;
+	const char* bin_dir = nullptr;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			out_path = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+		{
+			bin_dir = argv[++i];
+		}
+		else if (argv[i][0] != '-' && in_path == nullptr)
+		{
+			in_path = argv[i];
+		}
+		else
+		{
+			usage();
+		}
+	}
+	if (in_path == nullptr)
+	{
+		usage();
+	}
+
+	std::vector<PathSpec> specs;
+	if (!read_paths(in_path, specs))
+	{
+		return 1;
+	}
+
+	// include guard from the header's file name, e.g. SKAR_2_PATHS_HPP
+	std::string guard = "PATHS_HPP";
+	if (out_path != nullptr)
+	{
+		const char* slash = std::strrchr(out_path, '/');
+		guard.clear();
+		for (const char* c = slash ? slash + 1 : out_path; *c; c++)
+		{
+			guard += std::isalnum((unsigned char) *c) ? (char) std::toupper((unsigned char) *c) : '_';
+		}
+	}
+
+	std::string text;
+	char buf[256];
+	text += "// Generated by sim/tools/trajectory_gen from ";
+	text += in_path;
+	text += "; edit that and run make -C sim paths\n";
+	text += "#ifndef " + guard + "\n#define " + guard + "\n\n#include \"trajectory.hpp\"\n\nnamespace paths\n{\n";
+	for (const PathSpec& spec : specs)
+	{
+		std::vector<Segment> segments = generate_trajectory(spec.waypoints, spec.limits);
+		if (segments.empty())
+		{
+			std::fprintf(stderr, "%s: path %s needs at least two waypoints\n", in_path, spec.name.c_str());
+			return 1;
+		}
+		std::fprintf(stderr, "%s: %zu segments, %.2f m in %.2f s\n", spec.name.c_str(), segments.size(),
+		             segments.back().position, segments.size() * spec.limits.dt);
+		if (bin_dir != nullptr)
+		{
+			TrajectoryStore store;
+			std::string file = std::string(bin_dir) + "/" + spec.name + ".traj";
+			if (!write_trajectory_file(file.c_str(), store.get(store.add(spec.name, segments))))
+			{
+				std::perror(file.c_str());
+				return 1;
+			}
+		}
+		const char* fields[] = {"x", "y", "heading", "velocity"};
+		text += "\n";
+		for (int f = 0; f < 4; f++)
+		{
+			text += "\tconstexpr float " + spec.name + "_" + fields[f] + "[] = {";
+			for (size_t i = 0; i < segments.size(); i++)
+			{
+				const Segment& seg = segments[i];
+				double value = f == 0 ? seg.x : f == 1 ? seg.y : f == 2 ? seg.heading : seg.velocity;
+				// every digit a float needs, so the table is the same bits as a -b file of it
+				std::snprintf(buf, sizeof(buf), "%.9g", (float) value);
+				text += i % 8 == 0 ? "\n\t\t" : " ";
+				text += buf;
+				text += std::strpbrk(buf, ".e") ? "f," : ".0f,"; // 0f isn't a float literal
+			}
+			text += "\n\t};\n";
+		}
+		std::snprintf(buf, sizeof(buf), "\"%s\", %gf, %zu", spec.name.c_str(), spec.limits.dt, segments.size());
+		text += "\tconstexpr PackedTrajectory " + spec.name + "{" + buf + ", " + spec.name + "_x, " + spec.name + "_y, " +
+		        spec.name + "_heading, " + spec.name + "_velocity};\n";
+	}
+
+	// ids in the order listed, for TrajectoryStore
+	text += "\n\tenum Id : uint16_t {\n";
+	for (const PathSpec& spec : specs)
+	{
+		text += "\t\t" + spec.name + "_id,\n";
+	}
+	text += "\t};\n";
+	text += "\n\tconstexpr PackedTrajectory all[] = {\n";
+	for (const PathSpec& spec : specs)
+	{
+		text += "\t\t" + spec.name + ",\n";
+	}
+	text += "\t};\n}\n\n#endif\n";
+
+	FILE* out = out_path ? std::fopen(out_path, "w") : stdout;
+	if (out == nullptr)
+	{
+		std::perror(out_path);
+		return 1;
+	}
+	std::fputs(text.c_str(), out);
+	if (out != stdout)
+	{
+		std::fclose(out);
+	}
+	return 0;
+}
@@ -0,0 +1,324 @@
+#include "trajectory_format.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Times loading a trajectory in each format the robot could read it from.
+ *
+ *   bin/trajectory_load_bench [--dir DIR] [--reps N]
+ *
+ * Writes a short path (the ring sweep) and a long one (a minute of driving)
+ * into DIR (/tmp by default) as:
+ *
+ *   csv        left and right .csv, as AsyncMotionProfileController::storePath
+ *              writes them, read back with fscanf
+ *   serialize  left and right through pathfinder_serialize's scheme, every
+ *              double turned into bytes and read back one at a time
+ *   traj       one trajectory file, loaded whole with load_trajectory_file
+ *   stream     the same file through a TrajectoryStream: open() and then
+ *              every point in order, as follow_trajectory reads them
+ *
+ * and prints the file size, the time per load and the RAM the loaded path
+ * holds, then checks the streamed points are the ones the file loads. These
+ * are host times with the files in the page cache, so they show the decoding
+ * cost; on the brain every read also waits on the SD card.
+ */
+
+namespace
+{
+
+/* Pathfinder's io.c, which isn't in this tree: big endian, one field at a time */
+
+void doubleToBytes(double n, char* bytes)
+{
+	unsigned long long l;
+	std::memcpy(&l, &n, 8);
+	for (int i = 0; i < 8; i++)
+	{
+		bytes[i] = (l >> (8 * (7 - i))) & 0xFF;
+	}
+}
+
+double bytesToDouble(const char* bytes)
+{
+	unsigned long long l = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		l = (l << 8) | (unsigned char)bytes[i];
+	}
+	double n;
+	std::memcpy(&n, &l, 8);
+	return n;
+}
+
+void pathfinder_serialize(FILE* fp, const Segment* trajectory, int length)
+{
+	char buf[8];
+	for (int i = 0; i < 4; i++)
+	{
+		buf[i] = (length >> (8 * (3 - i))) & 0xFF;
+	}
+	std::fwrite(buf, 1, 4, fp);
+	for (int i = 0; i < length; i++)
+	{
+		const Segment& s = trajectory[i];
+		for (double field : {s.dt, s.x, s.y, s.position, s.velocity, s.acceleration, s.jerk, s.heading})
+		{
+			doubleToBytes(field, buf);
+			std::fwrite(buf, 1, 8, fp);
+		}
+	}
+}
+
+int pathfinder_deserialize(FILE* fp, std::vector<Segment>& target)
+{
+	char buf[8];
+	if (std::fread(buf, 1, 4, fp) != 4)
+	{
+		return 0;
+	}
+	int length = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		length = (length << 8) | (unsigned char)buf[i];
+	}
+	target.resize(length);
+	for (Segment& s : target)
+	{
+		for (double* field : {&s.dt, &s.x, &s.y, &s.position, &s.velocity, &s.acceleration, &s.jerk, &s.heading})
+		{
+			if (std::fread(buf, 1, 8, fp) != 8)
+			{
+				return 0;
+			}
+			*field = bytesToDouble(buf);
+		}
+	}
+	return length;
+}
+
+void write_csv(const std::string& file, const std::vector<Segment>& side)
+{
+	FILE* f = std::fopen(file.c_str(), "w");
+	std::fputs("dt,x,y,position,velocity,acceleration,jerk,heading\n", f);
+	for (const Segment& s : side)
+	{
+		std::fprintf(f, "%f,%f,%f,%f,%f,%f,%f,%f\n", s.dt, s.x, s.y, s.position, s.velocity, s.acceleration, s.jerk,
+		             s.heading);
+	}
+	std::fclose(f);
+}
+
+// One side back from its .csv, header line first
+bool read_csv(const std::string& file, std::vector<Segment>& side)
+{
+	FILE* f = std::fopen(file.c_str(), "r");
+	if (f == nullptr)
+	{
+		return false;
+	}
+	side.clear();
+	char header[80];
+	if (std::fgets(header, sizeof(header), f) != nullptr)
+	{
+		Segment s;
+		while (std::fscanf(f, "%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf", &s.dt, &s.x, &s.y, &s.position, &s.velocity,
+		                   &s.acceleration, &s.jerk, &s.heading) == 8)
+		{
+			side.push_back(s);
+		}
+	}
+	std::fclose(f);
+	return !side.empty();
+}
+
+// The two sides half the track either side of the centre, as Pathfinder's tank modifier makes them
+void tank(const std::vector<Segment>& centre, double track, std::vector<Segment>& left, std::vector<Segment>& right)
+{
+	left = right = centre;
+	for (size_t i = 0; i < centre.size(); i++)
+	{
+		const Segment& c = centre[i];
+		double w = i + 1 < centre.size() ? std::remainder(centre[i + 1].heading - c.heading, 2 * M_PI) / c.dt : 0;
+		left[i].x = c.x - track / 2 * std::sin(c.heading);
+		left[i].y = c.y + track / 2 * std::cos(c.heading);
+		left[i].velocity = c.velocity + w * track / 2;
+		right[i].x = c.x + track / 2 * std::sin(c.heading);
+		right[i].y = c.y - track / 2 * std::cos(c.heading);
+		right[i].velocity = c.velocity - w * track / 2;
+	}
+}
+
+long file_size(const std::string& file)
+{
+	FILE* f = std::fopen(file.c_str(), "rb");
+	if (f == nullptr)
+	{
+		return 0;
+	}
+	std::fseek(f, 0, SEEK_END);
+	long size = std::ftell(f);
+	std::fclose(f);
+	return size;
+}
+
+template <typename Load>
+double time_us(int reps, Load load)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < reps; i++)
+	{
+		if (!load())
+		{
+			std::fprintf(stderr, "load failed\n");
+			std::exit(1);
+		}
+	}
+	std::chrono::duration<double, std::micro> took = std::chrono::steady_clock::now() - start;
+	return took.count() / reps;
+}
+
+void usage()
+{
+	std::fprintf(stderr, "usage: trajectory_load_bench [--dir DIR] [--reps N]\n");
+	std::exit(1);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+	std::string dir = "/tmp";
+	int reps = 50;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--dir") == 0 && i + 1 < argc)
+		{
+			dir = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--reps") == 0 && i + 1 < argc)
+		{
+			reps = std::max(1, std::atoi(argv[++i]));
+		}
+		else
+		{
+			usage();
+		}
+	}
+
+	const double IN = 0.0254, DEG = M_PI / 180;
+	PathLimits limits;
+	limits.max_velocity = 0.75;
+	limits.max_acceleration = 1.5;
+	std::vector<Waypoint> sweep = {{10.7 * IN, 111.5 * IN, -90 * DEG}, {10.7 * IN, 75.7 * IN, -90 * DEG},
+	                               {-1.3 * IN, 63.7 * IN, 180 * DEG}, {-61.2 * IN, 63.6 * IN, 180 * DEG}};
+	std::vector<Waypoint> tour = {{0, 0, 0}};
+	for (int lap = 0; lap < 5; lap++)
+	{
+		for (double a : {90, 180, 270, 360})
+		{
+			double h = (lap * 360 + a) * DEG;
+			tour.push_back({2.5 * std::cos(h - M_PI / 2), 2.5 + 2.5 * std::sin(h - M_PI / 2), h});
+		}
+	}
+	struct Case
+	{
+		const char* name;
+		std::vector<Segment> centre;
+	};
+	std::vector<Case> cases = {{"ring_sweep", generate_trajectory(sweep, limits)},
+	                           {"minute", generate_trajectory(tour, limits)}};
+
+	std::printf("%-11s %-10s %10s %10s %10s\n", "path", "format", "file B", "load us", "RAM B");
+	for (const Case& c : cases)
+	{
+		std::string base = dir + "/" + c.name;
+		std::vector<Segment> left, right;
+		tank(c.centre, 12.4375 * IN, left, right);
+
+		write_csv(base + ".left.csv", left);
+		write_csv(base + ".right.csv", right);
+		for (const char* side : {".left.bin", ".right.bin"})
+		{
+			FILE* f = std::fopen((base + side).c_str(), "wb");
+			pathfinder_serialize(f, (side[1] == 'l' ? left : right).data(), c.centre.size());
+			std::fclose(f);
+		}
+		TrajectoryStore packer;
+		write_trajectory_file((base + ".traj").c_str(), packer.get(packer.add(c.name, c.centre)));
+
+		size_t pair_ram = 2 * c.centre.size() * sizeof(Segment);
+		std::vector<Segment> l, r;
+		double us = time_us(reps, [&] { return read_csv(base + ".left.csv", l) && read_csv(base + ".right.csv", r); });
+		std::printf("%-11s %-10s %10ld %10.0f %10zu\n", c.name, "csv",
+		            file_size(base + ".left.csv") + file_size(base + ".right.csv"), us, pair_ram);
+
+		us = time_us(reps, [&] {
+			FILE* lf = std::fopen((base + ".left.bin").c_str(), "rb");
+			FILE* rf = std::fopen((base + ".right.bin").c_str(), "rb");
+			bool ok = lf && rf && pathfinder_deserialize(lf, l) > 0 && pathfinder_deserialize(rf, r) > 0;
+			std::fclose(lf);
+			std::fclose(rf);
+			return ok;
+		});
+		std::printf("%-11s %-10s %10ld %10.0f %10zu\n", "", "serialize",
+		            file_size(base + ".left.bin") + file_size(base + ".right.bin"), us, pair_ram);
+
+		size_t store_ram = 0;
+		us = time_us(reps, [&] {
+			TrajectoryStore store;
+			uint16_t id;
+			bool ok = load_trajectory_file((base + ".traj").c_str(), store, id);
+			store_ram = store.bytes();
+			return ok;
+		});
+		std::printf("%-11s %-10s %10ld %10.0f %10zu\n", "", "traj", file_size(base + ".traj"), us, store_ram);
+
+		uint32_t loads = 0;
+		us = time_us(reps, [&] {
+			TrajectoryStream stream;
+			if (!stream.open((base + ".traj").c_str()))
+			{
+				return false;
+			}
+			float x, y, h, v;
+			for (uint32_t i = 0; i < stream.length; i++)
+			{
+				if (!stream.point(i, x, y, h, v))
+				{
+					return false;
+				}
+			}
+			loads = stream.loads;
+			return true;
+		});
+		std::printf("%-11s %-10s %10ld %10.0f %10zu  (%u chunk reads)\n", "", "stream", file_size(base + ".traj"), us,
+		            sizeof(TrajectoryStream) + TRAJECTORY_FILE_ARRAYS * 64 * sizeof(float), loads);
+
+		TrajectoryStore store;
+		uint16_t id;
+		TrajectoryStream stream;
+		if (!load_trajectory_file((base + ".traj").c_str(), store, id) || !stream.open((base + ".traj").c_str()))
+		{
+			std::fprintf(stderr, "couldn't reopen %s.traj\n", base.c_str());
+			return 1;
+		}
+		const PackedTrajectory& p = store.get(id);
+		for (uint32_t i = 0; i < p.length; i++)
+		{
+			float x, y, h, v;
+			if (!stream.point(i, x, y, h, v) || x != p.x[i] || y != p.y[i] || h != p.heading[i] || v != p.velocity[i])
+			{
+				std::fprintf(stderr, "%s: streamed point %u differs from the loaded one\n", c.name, i);
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,184 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <tuple>
+
+/**
+ * Picks vision signatures from sweeps recorded with record_signature_sweep.
+ *
+ *   bin/vision_calibrate [--range R] [-o TABLE] RECORDING...
+ *
+ * For every color and axis it scores each recorded window by how often it
+ * found the goal in views labelled with that color, minus twice how often it
+ * found something in views labelled anything else, and keeps the best U and
+ * best V window. The table it writes (stdout by default) goes on the SD card
+ * as vision_sigs.txt, where GoalCamera loads it at startup.
+ */
+
+namespace
+{
+
+const char* const COLORS[] = {"RED", "YELLOW", "BLUE"};
+
+struct Score
+{
+	int positives = 0;
+	int hits = 0;
+	int negatives = 0;
+	int false_hits = 0;
+
+	double hit_rate() const { return positives ? double(hits) / positives : 0; }
+	double false_rate() const { return negatives ? double(false_hits) / negatives : 0; }
+	double value() const { return hit_rate() - 2 * false_rate(); }
+};
+
+// color, axis, window min, window max
+typedef std::tuple<std::string, char, long, long> Window;
+
+std::map<Window, Score> windows;
+// the signature in use while recording, per color: u_min, u_max, v_min, v_max
+std::map<std::string, std::tuple<long, long, long, long>> current;
+
+void usage()
+{
+	std::fprintf(stderr, "usage: vision_calibrate [--range R] [-o TABLE] RECORDING...\n");
+	std::exit(1);
+}
+
+bool read_recording(const char* path)
+{
+	FILE* file = std::fopen(path, "r");
+	if (file == nullptr)
+	{
+		std::perror(path);
+		return false;
+	}
+	char line[256];
+	while (std::fgets(line, sizeof(line), file))
+	{
+		char label[16], color[16], axis;
+		long u_min, u_max, v_min, v_max;
+		int found, width, height;
+		if (std::sscanf(line, "%15[^,],%15[^,],%c,%ld,%ld,%ld,%ld,%d,%d,%d", label, color, &axis, &u_min, &u_max,
+		                &v_min, &v_max, &found, &width, &height) != 10)
+		{
+			continue;
+		}
+		bool u = axis == 'U';
+		Score& s = windows[Window(color, axis, u ? u_min : v_min, u ? u_max : v_max)];
+		if (std::strcmp(label, color) == 0)
+		{
+			s.positives++;
+			s.hits += found;
+		}
+		else
+		{
+			s.negatives++;
+			s.false_hits += found;
+		}
+
+		// each axis is swept with the other one left at the current signature
+		auto& c = current[color];
+		if (u)
+		{
+			std::get<2>(c) = v_min;
+			std::get<3>(c) = v_max;
+		}
+		else
+		{
+			std::get<0>(c) = u_min;
+			std::get<1>(c) = u_max;
+		}
+	}
+	std::fclose(file);
+	return true;
+}
+
+// The best window of one color along one axis, or false if none has any positives
+bool best(const std::string& color, char axis, long& lo, long& hi, Score& score)
+{
+	bool any = false;
+	for (const auto& entry : windows)
+	{
+		const Window& w = entry.first;
+		const Score& s = entry.second;
+		if (std::get<0>(w) != color || std::get<1>(w) != axis || s.positives == 0)
+		{
+			continue;
+		}
+		long width = std::get<3>(w) - std::get<2>(w);
+		// on a tie take the narrower window, it has more margin against other colors
+		if (!any || s.value() > score.value() || (s.value() == score.value() && width < hi - lo))
+		{
+			lo = std::get<2>(w);
+			hi = std::get<3>(w);
+			score = s;
+			any = true;
+		}
+	}
+	return any;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+	double range = 3.0;
+	const char* out_path = nullptr;
+	int recordings = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--range") == 0 && i + 1 < argc)
+		{
+			range = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			out_path = argv[++i];
+		}
+		else if (argv[i][0] == '-')
+		{
+			usage();
+		}
+		else if (read_recording(argv[i]))
+		{
+			recordings++;
+		}
+	}
+	if (recordings == 0)
+	{
+		usage();
+	}
+
+	FILE* out = out_path ? std::fopen(out_path, "w") : stdout;
+	if (out == nullptr)
+	{
+		std::perror(out_path);
+		return 1;
+	}
+	std::fprintf(out, "# color u_min u_max u_mean v_min v_max v_mean range\n");
+	for (const char* color : COLORS)
+	{
+		long u_min, u_max, v_min, v_max;
+		Score u_score, v_score;
+		if (!best(color, 'U', u_min, u_max, u_score) || !best(color, 'V', v_min, v_max, v_score))
+		{
+			std::fprintf(stderr, "%-6s no views labelled %s, keeping the built in signature\n", color, color);
+			continue;
+		}
+		auto old = current[color];
+		const Score& before = windows[Window(color, 'U', std::get<0>(old), std::get<1>(old))];
+		std::fprintf(stderr, "%-6s found %3.0f%% -> %3.0f%% (U) %3.0f%% (V), false %3.0f%% -> %3.0f%% (U) %3.0f%% (V)\n",
+		             color, 100 * before.hit_rate(), 100 * u_score.hit_rate(), 100 * v_score.hit_rate(),
+		             100 * before.false_rate(), 100 * u_score.false_rate(), 100 * v_score.false_rate());
+		std::fprintf(out, "%s %ld %ld %ld %ld %ld %ld %.3f\n", color, u_min, u_max, (u_min + u_max) / 2, v_min, v_max,
+		             (v_min + v_max) / 2, range);
+	}
+	if (out != stdout)
+	{
+		std::fclose(out);
+	}
+	return 0;
+}
@@ -15,6 +15,8 @@
     selector::auton == -1 : Blue Front
     selector::auton == -2 : Blue Back
     selector::auton == -3 : Do Nothing
+    selector::auton == 4 : Replay the newest driver recording
+    selector::auton == -4 : Replay the newest driver recording
     selector::auton == 0 : Skills
 */
 
@@ -26,7 +28,9 @@
 #define SKAR_3 4
 
 // Build Target
+#ifndef BUILD_TARGET
 #define BUILD_TARGET SKAR_2 //SKAR_1 or SKAR_2
+#endif
 
 // Initial speed for auton
 #define AUTON_INIT 165